@@ -26,19 +26,73 @@
 
 #include "motor.h"
 #include "sensor.h"
+#include "clock.h"
+#include "profiler.h"
+#include "seqlock.h"
+#include "arena.h"
+#include "scalar.h"
 
 #include "data_io/interface/data_io.h"
-#include "kalman/kalman_filters.h"
+#include "threads/threads.h"
 #include "debug/data_logging.h"
-#include "timing/timing.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <errno.h>
+#endif
+
 
 enum ControlVariable { POSITION, VELOCITY, ACCELERATION, FORCE, CONTROL_VARS_NUMBER };
 
+enum { PROPORTIONAL, INTEGRAL, DERIVATIVE, GAINS_NUMBER };
+
+// High-rate local loop (sensors -> PID -> motor), fed by robot loop setpoints
+typedef struct _InnerLoop
+{
+  Thread thread;
+  volatile bool isRunning;
+  ThreadLock stateLock;                 // Held only for taking requested control state changes, applied by the running thread itself (outside the lock)
+  bool isStateChanged;
+  double timeStep;
+  double passTime;                      // Robot cycle time, for running inner steps along with setpoints when the thread is not running (simulated time)
+  enum ControlVariable variable;
+  Scalar gainsList[ GAINS_NUMBER ];
+  Scalar errorIntegral, lastError;
+  bool hasLastError;                    // Cleared on resets, so that the first step error also seeds the derivative term
+  SeqLock setpointsLock;
+  DoFVariables setpoints;
+  SeqLock measuresLock;
+  double measuresList[ CONTROL_VARS_NUMBER ];
+}
+InnerLoop;
+
+// Single sensor row of motion filter measurement matrix, only used for correction while sensor has new samples
+typedef struct _MeasureRow
+{
+  size_t variable;                      // Measured control variable (CONTROL_VARS_NUMBER if none)
+  double weight;
+  double measure;
+  bool hasNewSample;
+}
+MeasureRow;
+
+// Kalman filter over motion (constant acceleration) and force states, with one scalar correction for each measure row
+typedef struct _MotionFilter
+{
+  double state[ CONTROL_VARS_NUMBER ];
+  double covariance[ CONTROL_VARS_NUMBER ][ CONTROL_VARS_NUMBER ];
+}
+MotionFilter;
+
+const double MOTION_PREDICTION_NOISE = 1.0;
+const double MOTION_MEASURE_NOISE = 1.0;
+
 struct _ActuatorData
 {
   enum ControlState controlState;
@@ -47,10 +101,18 @@ struct _ActuatorData
   double setpointLimit;
   Sensor* sensorsList;
   size_t sensorsNumber;
-  KFilter motionFilter;
+  MotionFilter motionFilter;
+  MeasureRow* measureRowsList;
+  InnerLoop* innerLoop;
   Log log;
 };
 
+static enum ControlVariable GetControlVariable( const char* );
+static void ResetMotionFilter( MotionFilter* );
+static void ApplyControlState( Actuator );
+static void StopInnerLoop( Actuator );
+static void* AsyncInnerLoop( void* );
+
 
 const char* CONTROL_MODE_NAMES[ CONTROL_VARS_NUMBER ] = { [ POSITION ] = "POSITION", [ VELOCITY ] = "VELOCITY", 
                                                           [ ACCELERATION ] = "ACCELERATION", [ FORCE ] = "FORCE" };
@@ -62,26 +124,33 @@ Actuator Actuator_Init( const char* configName )
   DataHandle configuration = DataIO_LoadStorageData( filePath );
   if( configuration == NULL ) return NULL;
   DEBUG_PRINT( "found actuator %s config in handle %p", configName, configuration );
-  Actuator newActuator = (Actuator) malloc( sizeof(ActuatorData) );
-  memset( newActuator, 0, sizeof(ActuatorData) );
+  Actuator newActuator = (Actuator) Arena_Calloc( 1, sizeof(ActuatorData) );
+  if( newActuator == NULL )
+  {
+    DataIO_UnloadData( configuration );
+    return NULL;
+  }
   
   bool loadSuccess = true;
   DEBUG_PRINT( "found %lu sensors", DataIO_GetListSize( configuration, KEY_SENSORS ) );
   if( (newActuator->sensorsNumber = DataIO_GetListSize( configuration, KEY_SENSORS )) > 0 )
   {
-    newActuator->motionFilter = Kalman_CreateFilter( CONTROL_VARS_NUMBER, newActuator->sensorsNumber, 0 );
-    
-    newActuator->sensorsList = (Sensor*) calloc( newActuator->sensorsNumber, sizeof(Sensor) );
+    newActuator->sensorsList = (Sensor*) Arena_Calloc( newActuator->sensorsNumber, sizeof(Sensor) );
+    newActuator->measureRowsList = (MeasureRow*) Arena_Calloc( newActuator->sensorsNumber, sizeof(MeasureRow) );
+    if( newActuator->sensorsList == NULL || newActuator->measureRowsList == NULL )
+    {
+      newActuator->sensorsNumber = 0;
+      loadSuccess = false;
+    }
     for( size_t sensorIndex = 0; sensorIndex < newActuator->sensorsNumber; sensorIndex++ )
     {
       const char* sensorName = DataIO_GetStringValue( configuration, "", KEY_SENSORS ".%lu." KEY_CONFIG, sensorIndex );
       if( (newActuator->sensorsList[ sensorIndex ] = Sensor_Init( sensorName )) == NULL ) loadSuccess = false;
       DEBUG_PRINT( "loading sensor %s success: %s", sensorName, loadSuccess ? "true" : "false" );
+      MeasureRow* measureRow = &(newActuator->measureRowsList[ sensorIndex ]);
       const char* sensorType = DataIO_GetStringValue( configuration, "", KEY_SENSORS ".%lu." KEY_VARIABLE, sensorIndex );
-      double measurementDeviation = DataIO_GetNumericValue( configuration, 1.0, KEY_SENSORS ".%lu." KEY_DEVIATION, sensorIndex );
-      for( int controlModeIndex = 0; controlModeIndex < CONTROL_VARS_NUMBER; controlModeIndex++ )
-        if( strcmp( sensorType, CONTROL_MODE_NAMES[ controlModeIndex ] ) == 0 ) 
-          Kalman_SetMeasureWeight( newActuator->motionFilter, sensorIndex, controlModeIndex, measurementDeviation );
+      measureRow->variable = (size_t) GetControlVariable( sensorType );
+      measureRow->weight = DataIO_GetNumericValue( configuration, 1.0, KEY_SENSORS ".%lu." KEY_DEVIATION, sensorIndex );
     }
   }
   
@@ -89,11 +158,28 @@ Actuator Actuator_Init( const char* configName )
   if( (newActuator->motor = Motor_Init( motorName )) == NULL ) loadSuccess = false;
   DEBUG_PRINT( "loading motor %s success: %s", motorName, loadSuccess ? "true" : "false" ); 
   const char* controlModeName = DataIO_GetStringValue( configuration, (char*) CONTROL_MODE_NAMES[ 0 ], KEY_MOTOR "." KEY_VARIABLE );
-  for( newActuator->controlMode = 0; newActuator->controlMode < CONTROL_VARS_NUMBER; newActuator->controlMode++ )
-    if( strcmp( controlModeName, CONTROL_MODE_NAMES[ newActuator->controlMode ] ) == 0 ) break;
+  newActuator->controlMode = GetControlVariable( controlModeName );
   DEBUG_PRINT( "control mode: %s", CONTROL_MODE_NAMES[ newActuator->controlMode ] );
   newActuator->setpointLimit = DataIO_GetNumericValue( configuration, -1.0, KEY_MOTOR "." KEY_LIMIT  );
   
+  if( DataIO_HasKey( configuration, KEY_INNER_LOOP ) )
+  {
+    if( (newActuator->innerLoop = (InnerLoop*) Arena_Calloc( 1, sizeof(InnerLoop) )) == NULL ) loadSuccess = false;
+  }
+  
+  if( newActuator->innerLoop != NULL )
+  {
+    newActuator->innerLoop->thread = THREAD_INVALID_HANDLE;
+    newActuator->innerLoop->stateLock = ThreadLock_Create();
+    double innerLoopRate = DataIO_GetNumericValue( configuration, 1000.0, KEY_INNER_LOOP "." KEY_RATE );
+    newActuator->innerLoop->timeStep = ( innerLoopRate > 0.0 ) ? 1.0 / innerLoopRate : 0.001;
+    const char* innerVariableName = DataIO_GetStringValue( configuration, (char*) CONTROL_MODE_NAMES[ FORCE ], KEY_INNER_LOOP "." KEY_VARIABLE );
+    if( (newActuator->innerLoop->variable = GetControlVariable( innerVariableName )) >= CONTROL_VARS_NUMBER ) loadSuccess = false;
+    for( size_t gainIndex = 0; gainIndex < GAINS_NUMBER; gainIndex++ )
+      newActuator->innerLoop->gainsList[ gainIndex ] = (Scalar) DataIO_GetNumericValue( configuration, 0.0, KEY_INNER_LOOP "." KEY_GAINS ".%lu", gainIndex );
+    DEBUG_PRINT( "inner loop: %s control at %g Hz", innerVariableName, innerLoopRate );
+  }
+  
   if( DataIO_HasKey( configuration, KEY_LOG ) )
     newActuator->log = Log_Init( DataIO_GetBooleanValue( configuration, false, KEY_LOG "." KEY_FILE ) ? configName : "", 
                                  (size_t) DataIO_GetNumericValue( configuration, 3, KEY_LOG "." KEY_PRECISION ) );
@@ -108,7 +194,7 @@ Actuator Actuator_Init( const char* configName )
     return NULL;
   }
   //DEBUG_PRINT( "reseting actuator %s", configName );
-  Kalman_Reset( newActuator->motionFilter );
+  ResetMotionFilter( &(newActuator->motionFilter) );
   //DEBUG_PRINT( "actuator %s ready", configName );
   return newActuator;
 }
@@ -117,26 +203,52 @@ void Actuator_End( Actuator actuator )
 {
   if( actuator == NULL ) return;
   
-  Kalman_DiscardFilter( actuator->motionFilter );
+  StopInnerLoop( actuator );
+  
+  if( actuator->innerLoop != NULL ) ThreadLock_Discard( actuator->innerLoop->stateLock );
+  Arena_Free( actuator->innerLoop );
   
   Motor_End( actuator->motor );
   for( size_t sensorIndex = 0; sensorIndex < actuator->sensorsNumber; sensorIndex++ )
     Sensor_End( actuator->sensorsList[ sensorIndex ] );
+  Arena_Free( actuator->sensorsList );
+  Arena_Free( actuator->measureRowsList );
   
   Log_End( actuator->log );
+  
+  Arena_Free( actuator );
 }
 
 bool Actuator_Enable( Actuator actuator )
 {
   if( actuator == NULL ) return false;
   
-  return Motor_Enable( actuator->motor );     
+  if( !Motor_Enable( actuator->motor ) ) return false;
+  
+  // On simulated time, inner loop steps are run along with robot setpoints (see Actuator_SetSetpoints)
+  InnerLoop* innerLoop = actuator->innerLoop;
+  if( innerLoop != NULL && !(innerLoop->isRunning) && Clock_GetSource() == CLOCK_SOURCE_SYSTEM )
+  {
+    innerLoop->errorIntegral = 0.0;
+    innerLoop->hasLastError = false;
+    innerLoop->isRunning = true;
+    innerLoop->thread = Thread_Start( AsyncInnerLoop, actuator, THREAD_JOINABLE );
+    if( innerLoop->thread == THREAD_INVALID_HANDLE ) 
+    {
+      innerLoop->isRunning = false;
+      return false;
+    }
+  }
+  
+  return true;
 }
 
 void Actuator_Disable( Actuator actuator )
 {
   if( actuator == NULL ) return;
-    
+  
+  StopInnerLoop( actuator );
+  
   Motor_Disable( actuator->motor );
 }
 
@@ -148,9 +260,31 @@ bool Actuator_SetControlState( Actuator actuator, enum ControlState newState )
   
   if( newState >= CONTROL_STATES_NUMBER ) return false;
   
-  Kalman_Reset( actuator->motionFilter );
-  
   DEBUG_PRINT( "setting actuator state to %s", ( newState == CONTROL_OFFSET ) ? "offset" : ( ( newState == CONTROL_CALIBRATION ) ? "calibration" : "operation" ) );
+  
+  // A running inner loop accesses sensors and motor on its own (real-time priority) thread, which takes the change on its next step
+  InnerLoop* innerLoop = actuator->innerLoop;
+  if( innerLoop != NULL && innerLoop->isRunning )
+  {
+    ThreadLock_Aquire( innerLoop->stateLock );
+    actuator->controlState = newState;
+    innerLoop->isStateChanged = true;
+    ThreadLock_Release( innerLoop->stateLock );
+    return true;
+  }
+  
+  actuator->controlState = newState;
+  ApplyControlState( actuator );
+  
+  return true;
+}
+
+static void ApplyControlState( Actuator actuator )
+{
+  enum ControlState newState = actuator->controlState;
+  
+  ResetMotionFilter( &(actuator->motionFilter) );
+  
   if( newState == CONTROL_OFFSET )
   {
     for( size_t sensorIndex = 0; sensorIndex < actuator->sensorsNumber; sensorIndex++ )
@@ -170,9 +304,93 @@ bool Actuator_SetControlState( Actuator actuator, enum ControlState newState )
     Motor_SetOperation( actuator->motor );
   }
   
-  actuator->controlState = newState;
+  if( actuator->innerLoop != NULL )
+  {
+    actuator->innerLoop->errorIntegral = 0.0;
+    actuator->innerLoop->hasLastError = false;
+  }
+}
+
+static void ResetMotionFilter( MotionFilter* filter )
+{
+  memset( filter, 0, sizeof(MotionFilter) );
+  for( size_t stateIndex = 0; stateIndex < CONTROL_VARS_NUMBER; stateIndex++ )
+    filter->covariance[ stateIndex ][ stateIndex ] = 1.0;
+}
+
+static void PredictMotion( MotionFilter* filter, double timeDelta )
+{
+  const double transition[ CONTROL_VARS_NUMBER ][ CONTROL_VARS_NUMBER ] = { [ POSITION ] = { [ POSITION ] = 1.0, [ VELOCITY ] = timeDelta, [ ACCELERATION ] = timeDelta * timeDelta / 2.0 },
+                                                                            [ VELOCITY ] = { [ VELOCITY ] = 1.0, [ ACCELERATION ] = timeDelta },
+                                                                            [ ACCELERATION ] = { [ ACCELERATION ] = 1.0 }, [ FORCE ] = { [ FORCE ] = 1.0 } };
+  double predictedState[ CONTROL_VARS_NUMBER ] = { 0.0 };
+  double transitionCovariance[ CONTROL_VARS_NUMBER ][ CONTROL_VARS_NUMBER ] = { { 0.0 } };
+  for( size_t rowIndex = 0; rowIndex < CONTROL_VARS_NUMBER; rowIndex++ )
+  {
+    for( size_t columnIndex = 0; columnIndex < CONTROL_VARS_NUMBER; columnIndex++ )
+    {
+      predictedState[ rowIndex ] += transition[ rowIndex ][ columnIndex ] * filter->state[ columnIndex ];
+      for( size_t sumIndex = 0; sumIndex < CONTROL_VARS_NUMBER; sumIndex++ )
+        transitionCovariance[ rowIndex ][ columnIndex ] += transition[ rowIndex ][ sumIndex ] * filter->covariance[ sumIndex ][ columnIndex ];
+    }
+  }
+  memcpy( filter->state, predictedState, sizeof(predictedState) );
+  // P = F * P * F' + Q
+  for( size_t rowIndex = 0; rowIndex < CONTROL_VARS_NUMBER; rowIndex++ )
+  {
+    for( size_t columnIndex = 0; columnIndex < CONTROL_VARS_NUMBER; columnIndex++ )
+    {
+      double covariance = ( rowIndex == columnIndex ) ? MOTION_PREDICTION_NOISE : 0.0;
+      for( size_t sumIndex = 0; sumIndex < CONTROL_VARS_NUMBER; sumIndex++ )
+        covariance += transitionCovariance[ rowIndex ][ sumIndex ] * transition[ columnIndex ][ sumIndex ];
+      filter->covariance[ rowIndex ][ columnIndex ] = covariance;
+    }
+  }
+}
+
+static void CorrectMotion( MotionFilter* filter, const MeasureRow* measureRow )
+{
+  // Single row measurement model (only measured variable weight is not null): innovation covariance is scalar, and no matrix inversion is needed
+  size_t variable = measureRow->variable;
+  double weight = measureRow->weight;
+  double innovationCovariance = weight * weight * filter->covariance[ variable ][ variable ] + MOTION_MEASURE_NOISE;
+  if( innovationCovariance <= 0.0 ) return;
   
-  return true;
+  double innovation = measureRow->measure - weight * filter->state[ variable ];
+  double gainsList[ CONTROL_VARS_NUMBER ], measuredCovariancesList[ CONTROL_VARS_NUMBER ];
+  for( size_t stateIndex = 0; stateIndex < CONTROL_VARS_NUMBER; stateIndex++ )
+  {
+    gainsList[ stateIndex ] = weight * filter->covariance[ stateIndex ][ variable ] / innovationCovariance;
+    measuredCovariancesList[ stateIndex ] = weight * filter->covariance[ variable ][ stateIndex ];
+  }
+  // x = x + K * y, P = P - K * H * P
+  for( size_t rowIndex = 0; rowIndex < CONTROL_VARS_NUMBER; rowIndex++ )
+  {
+    filter->state[ rowIndex ] += gainsList[ rowIndex ] * innovation;
+    for( size_t columnIndex = 0; columnIndex < CONTROL_VARS_NUMBER; columnIndex++ )
+      filter->covariance[ rowIndex ][ columnIndex ] -= gainsList[ rowIndex ] * measuredCovariancesList[ columnIndex ];
+  }
+}
+
+static void ReadMeasures( Actuator actuator, double timeDelta, double* filteredMeasures )
+{
+  PROFILER_START( stageTime );
+  
+  for( size_t sensorIndex = 0; sensorIndex < actuator->sensorsNumber; sensorIndex++ )
+  {
+    MeasureRow* measureRow = &(actuator->measureRowsList[ sensorIndex ]);
+    measureRow->measure = Sensor_Update( actuator->sensorsList[ sensorIndex ], &(measureRow->hasNewSample) );
+  }
+  PROFILER_REGISTER( PROFILER_SENSORS, stageTime );
+  PredictMotion( &(actuator->motionFilter), timeDelta );
+  // Sensors slower than control passes only correct the estimate when they get new samples: updates are sequential, so stale ones cost nothing
+  for( size_t sensorIndex = 0; sensorIndex < actuator->sensorsNumber; sensorIndex++ )
+  {
+    MeasureRow* measureRow = &(actuator->measureRowsList[ sensorIndex ]);
+    if( measureRow->hasNewSample && measureRow->variable < CONTROL_VARS_NUMBER ) CorrectMotion( &(actuator->motionFilter), measureRow );
+  }
+  memcpy( filteredMeasures, actuator->motionFilter.state, sizeof(actuator->motionFilter.state) );
+  PROFILER_REGISTER( PROFILER_FILTERING, stageTime );
 }
 
 bool Actuator_GetMeasures( Actuator actuator, DoFVariables* ref_measures, double timeDelta )
@@ -182,16 +400,29 @@ bool Actuator_GetMeasures( Actuator actuator, DoFVariables* ref_measures, double
   //DEBUG_PRINT( "reading measures from %lu sensors", actuator->sensorsNumber );
   double filteredMeasures[ CONTROL_VARS_NUMBER ];
   
-  Kalman_SetTransitionFactor( actuator->motionFilter, POSITION, VELOCITY, timeDelta );
-  Kalman_SetTransitionFactor( actuator->motionFilter, POSITION, ACCELERATION, timeDelta * timeDelta / 2.0 );
-  Kalman_SetTransitionFactor( actuator->motionFilter, VELOCITY, ACCELERATION, timeDelta );
-  for( size_t sensorIndex = 0; sensorIndex < actuator->sensorsNumber; sensorIndex++ )
+  // Inner loop actuators only pick up latest measures published by their own thread
+  InnerLoop* innerLoop = actuator->innerLoop;
+  if( innerLoop != NULL && innerLoop->isRunning )
   {
-    double sensorMeasure = Sensor_Update( actuator->sensorsList[ sensorIndex ] );
-    Kalman_SetMeasure( actuator->motionFilter, sensorIndex, sensorMeasure );
+    uint32_t sequence;
+    do {
+      sequence = SeqLock_BeginRead( &(innerLoop->measuresLock) );
+      memcpy( filteredMeasures, innerLoop->measuresList, sizeof(filteredMeasures) );
+    } while( !SeqLock_EndRead( &(innerLoop->measuresLock), sequence ) );
+  }
+  else
+  {
+    // Without running thread (simulated time), this reading is the first of the inner steps taken along with setpoints (see Actuator_SetSetpoints)
+    if( innerLoop != NULL ) 
+    {
+      innerLoop->passTime = timeDelta;
+      timeDelta = innerLoop->timeStep;
+    }
+    ReadMeasures( actuator, timeDelta, filteredMeasures );
+    if( innerLoop != NULL ) memcpy( innerLoop->measuresList, filteredMeasures, sizeof(filteredMeasures) );
   }
-  (void) Kalman_Predict( actuator->motionFilter, NULL, (double*) filteredMeasures );
-  (void) Kalman_Update( actuator->motionFilter, NULL, (double*) filteredMeasures );
+  
+  PROFILER_START( stageTime );
   
   //DEBUG_PRINT( "p=%.5f, v=%.5f, f=%.5f", filteredMeasures[ POSITION ], filteredMeasures[ VELOCITY ], filteredMeasures[ FORCE ] );
   ref_measures->position = filteredMeasures[ POSITION ];
@@ -199,17 +430,25 @@ bool Actuator_GetMeasures( Actuator actuator, DoFVariables* ref_measures, double
   ref_measures->acceleration = filteredMeasures[ ACCELERATION ];
   ref_measures->force = filteredMeasures[ FORCE ];
   
-  Log_EnterNewLine( actuator->log, Time_GetExecSeconds() );
+  Log_EnterNewLine( actuator->log, Clock_GetExecSeconds() );
   Log_RegisterList( actuator->log, CONTROL_VARS_NUMBER, (double*) filteredMeasures );
+  PROFILER_REGISTER( PROFILER_LOGGING, stageTime );
   
   return true;
 }
 
-double Actuator_SetSetpoints( Actuator actuator, DoFVariables* ref_setpoints )
+void Actuator_PrefetchInputs( Actuator actuator )
 {
-  if( actuator == NULL ) return 0.0;
+  if( actuator == NULL ) return;
   
-  double motorSetpoint = ( (double*) ref_setpoints )[ actuator->controlMode ];
+  if( actuator->innerLoop != NULL ) return;
+  
+  for( size_t sensorIndex = 0; sensorIndex < actuator->sensorsNumber; sensorIndex++ )
+    Sensor_PrefetchInputs( actuator->sensorsList[ sensorIndex ] );
+}
+
+static double WriteMotorSetpoint( Actuator actuator, double motorSetpoint )
+{
   if( actuator->setpointLimit > 0.0 )
   {
     if( motorSetpoint < -actuator->setpointLimit ) motorSetpoint = -actuator->setpointLimit;
@@ -221,3 +460,181 @@ double Actuator_SetSetpoints( Actuator actuator, DoFVariables* ref_setpoints )
   //DEBUG_PRINT( "setpoint %g written to motor", motorSetpoint );
   return motorSetpoint;
 }
+
+static double RunInnerLoopStep( Actuator actuator, double timeDelta, bool readSensors );
+
+double Actuator_SetSetpoints( Actuator actuator, DoFVariables* ref_setpoints )
+{
+  if( actuator == NULL ) return 0.0;
+  
+  InnerLoop* innerLoop = actuator->innerLoop;
+  if( innerLoop == NULL ) return WriteMotorSetpoint( actuator, ( (double*) ref_setpoints )[ actuator->controlMode ] );
+  
+  SeqLock_BeginWrite( &(innerLoop->setpointsLock) );
+  innerLoop->setpoints = *ref_setpoints;
+  SeqLock_EndWrite( &(innerLoop->setpointsLock) );
+  
+  // Without running thread (simulated time), all inner steps of the robot cycle are taken at once, each one with its own sensors reading
+  // (except the first one, using measures just read by Actuator_GetMeasures)
+  if( !(innerLoop->isRunning) ) 
+  {
+    size_t stepsNumber = (size_t) ( innerLoop->passTime / innerLoop->timeStep + 0.5 );
+    double motorSetpoint = RunInnerLoopStep( actuator, innerLoop->timeStep, false );
+    for( size_t stepIndex = 1; stepIndex < stepsNumber; stepIndex++ )
+      motorSetpoint = RunInnerLoopStep( actuator, innerLoop->timeStep, true );
+    return motorSetpoint;
+  }
+  
+  return ( (double*) ref_setpoints )[ actuator->controlMode ];
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+/////                          ASYNCHRONOUS CONTROL                         /////
+/////////////////////////////////////////////////////////////////////////////////
+
+static enum ControlVariable GetControlVariable( const char* variableName )
+{
+  enum ControlVariable variable = 0;
+  for( ; variable < CONTROL_VARS_NUMBER; variable++ )
+    if( strcmp( variableName, CONTROL_MODE_NAMES[ variable ] ) == 0 ) break;
+  return variable;
+}
+
+// Motor output = feedforward (robot setpoint of motor variable) + PID on inner loop variable error
+static double RunInnerLoopStep( Actuator actuator, double timeDelta, bool readSensors )
+{
+  InnerLoop* innerLoop = actuator->innerLoop;
+  double measuresList[ CONTROL_VARS_NUMBER ];
+  DoFVariables setpoints;
+  
+  // Only the state change request is taken under the lock, so that the robot thread is never blocked by sensor/motor access
+  ThreadLock_Aquire( innerLoop->stateLock );
+  bool isStateChanged = innerLoop->isStateChanged;
+  innerLoop->isStateChanged = false;
+  ThreadLock_Release( innerLoop->stateLock );
+  if( isStateChanged ) ApplyControlState( actuator );
+  
+  if( readSensors )
+  {
+    ReadMeasures( actuator, timeDelta, measuresList );
+    SeqLock_BeginWrite( &(innerLoop->measuresLock) );
+    memcpy( innerLoop->measuresList, measuresList, sizeof(measuresList) );
+    SeqLock_EndWrite( &(innerLoop->measuresLock) );
+  }
+  else memcpy( measuresList, innerLoop->measuresList, sizeof(measuresList) );
+  
+  uint32_t sequence;
+  do {
+    sequence = SeqLock_BeginRead( &(innerLoop->setpointsLock) );
+    setpoints = innerLoop->setpoints;
+  } while( !SeqLock_EndRead( &(innerLoop->setpointsLock), sequence ) );
+  
+  Scalar stepTime = (Scalar) timeDelta;
+  Scalar error = (Scalar) ( ( (double*) &setpoints )[ innerLoop->variable ] - measuresList[ innerLoop->variable ] );
+  innerLoop->errorIntegral += error * stepTime;
+  if( !(innerLoop->hasLastError) ) innerLoop->lastError = error;
+  innerLoop->hasLastError = true;
+  Scalar errorDerivative = ( stepTime > 0 ) ? ( error - innerLoop->lastError ) / stepTime : 0;
+  innerLoop->lastError = error;
+  
+  double motorSetpoint = ( (double*) &setpoints )[ actuator->controlMode ] + (double) ( innerLoop->gainsList[ PROPORTIONAL ] * error 
+                         + innerLoop->gainsList[ INTEGRAL ] * innerLoop->errorIntegral + innerLoop->gainsList[ DERIVATIVE ] * errorDerivative );
+  motorSetpoint = WriteMotorSetpoint( actuator, motorSetpoint );
+  
+  return motorSetpoint;
+}
+
+static void StopInnerLoop( Actuator actuator )
+{
+  InnerLoop* innerLoop = actuator->innerLoop;
+  if( innerLoop == NULL || innerLoop->thread == THREAD_INVALID_HANDLE ) return;
+  
+  innerLoop->isRunning = false;
+  Thread_WaitExit( innerLoop->thread, 5000 );
+  innerLoop->thread = THREAD_INVALID_HANDLE;
+  
+  // State change requested too late for the thread to take it
+  if( innerLoop->isStateChanged ) ApplyControlState( actuator );
+  innerLoop->isStateChanged = false;
+  
+  Motor_WriteControl( actuator->motor, 0.0 );
+}
+
+static void* AsyncInnerLoop( void* ref_actuator )
+{
+  Actuator actuator = (Actuator) ref_actuator;
+  InnerLoop* innerLoop = actuator->innerLoop;
+  
+#ifdef __linux__
+  // Best effort: real-time priority above the (default priority) robot loop, usually requiring elevated privileges.
+  // Otherwise, the loop keeps running with default scheduling (and just less precise timing)
+  struct sched_param schedulingParameters = { .sched_priority = sched_get_priority_max( SCHED_FIFO ) - 1 };
+  if( pthread_setschedparam( pthread_self(), SCHED_FIFO, &schedulingParameters ) != 0 ) 
+  {
+    DEBUG_PRINT( "%s", "could not set real-time inner loop priority: using default scheduling" );
+    schedulingParameters.sched_priority = 0;
+    (void) pthread_setschedparam( pthread_self(), SCHED_OTHER, &schedulingParameters );
+  }
+#endif
+  
+  DEBUG_PRINT( "starting inner loop for actuator %p", actuator );
+  
+  Arena_SetHeapTrap( true );
+  
+  // First step is taken as a regular one, instead of with (almost) null time delta
+  double stepTime = Clock_GetExecSeconds() - innerLoop->timeStep;
+#ifdef __linux__
+  // Thread always sleeps until the absolute deadline of its next step, so that it never keeps a (real-time priority) core busy
+  long stepNanoseconds = (long) ( innerLoop->timeStep * 1e9 );
+  struct timespec nextStepTime, currentTime;
+  clock_gettime( CLOCK_MONOTONIC, &nextStepTime );
+#else
+  double nextStepTime = stepTime + innerLoop->timeStep;
+#endif
+  while( innerLoop->isRunning )
+  {
+    double execTime = Clock_GetExecSeconds();
+    (void) RunInnerLoopStep( actuator, execTime - stepTime, true );
+    stepTime = execTime;
+    
+#ifdef __linux__
+    nextStepTime.tv_nsec += stepNanoseconds;
+    while( nextStepTime.tv_nsec >= 1000000000L ) 
+    {
+      nextStepTime.tv_nsec -= 1000000000L;
+      nextStepTime.tv_sec++;
+    }
+    clock_gettime( CLOCK_MONOTONIC, &currentTime );
+    // Overrun: no attempt to catch up
+    if( currentTime.tv_sec > nextStepTime.tv_sec || ( currentTime.tv_sec == nextStepTime.tv_sec && currentTime.tv_nsec > nextStepTime.tv_nsec ) ) nextStepTime = currentTime;
+    else while( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &nextStepTime, NULL ) == EINTR && innerLoop->isRunning );
+#else
+    // Sleep most of the interval and spin the rest, as sub-millisecond delays are not available (no real-time priority is set here)
+    nextStepTime += innerLoop->timeStep;
+    double remainingTime = nextStepTime - Clock_GetExecSeconds();
+    if( remainingTime < 0.0 ) nextStepTime = Clock_GetExecSeconds();     // Overrun: no attempt to catch up
+    else if( remainingTime > 0.001 ) Clock_Delay( remainingTime - 0.001 );
+    while( Clock_GetExecSeconds() < nextStepTime && innerLoop->isRunning );
+#endif
+  }
+  
+  Arena_SetHeapTrap( false );
+  
+  return NULL;
+}
+
+bool Actuator_AddToBatch( Actuator actuator, OutputBatch batch )
+{
+  if( actuator == NULL ) return false;
+  
+  if( actuator->innerLoop != NULL ) return false;
+  
+  return Motor_AddToBatch( actuator->motor, batch );
+}
+
+size_t Actuator_GetSuppressedWritesNumber( Actuator actuator )
+{
+  if( actuator == NULL ) return 0;
+  
+  return Motor_GetSuppressedWritesNumber( actuator->motor );
+}
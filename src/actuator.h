@@ -50,6 +50,12 @@
 ///     "config": "<motor_identifier>",     // Motor string identifier (configuration file path) or inline configuration object 
 ///     "limit": -1.0                       // [o] Absolute maximum allowed for control motor setpoint/output
 ///   },
+///   "inner_loop": {                     // [o] Run sensors reading, filtering and motor writing on a dedicated (higher priority) thread, at its own rate
+///     "rate": 1000.0,                     // [o] Inner loop frequency (in Hz), usually higher than robot control one
+///                                         //     (devices advancing on each reading, like PlantSimulator with fixed "step", must use 1/rate step)
+///     "variable": "FORCE",                // [o] Dimension/variable controlled locally (POSITION, VELOCITY, FORCE or ACCELERATION)
+///     "gains": [ 0.0, 0.0, 0.0 ]          // [o] Proportional, integral and derivative gains on controlled variable error, added to motor variable setpoint (feedforward)
+///   },
 ///   "log": {                            // [o] Set logging of measurement and setpoint numeric data over time
 ///     "to_file": false,                   // [o] Save data logging to <log_dir>/[<user_name>-]<actuator_name>-<time_stamp>.log, to log file 
 ///                                         //     Default value will set terminal logging
@@ -63,6 +69,7 @@
 #define ACTUATOR_H 
 
 #include "robot_control/robot_control.h"
+#include "output.h"
 
 #include <stdbool.h>
 
@@ -101,11 +108,26 @@ bool Actuator_SetControlState( Actuator actuator, enum ControlState controlState
 /// @return true if new measurements were taken, false otherwise
 bool Actuator_GetMeasures( Actuator actuator, DoFVariables* ref_measures, double timeDelta );
 
+/// @brief Reads raw samples of all sensors of given actuator ahead of its next measurement (see Input_Prefetch)
+/// @param[in] actuator reference to actuator (no effect for actuators with inner control loop, which read their sensors on their own thread)
+void Actuator_PrefetchInputs( Actuator actuator );
+
 /// @brief Writes possible motor setpoint values for given actuator       
 /// @param[in] actuator reference to actuator
 /// @param[in] ref_setpoints pointer/reference to variables structure with the new setpoints
 /// @return control action applied on motor of given actuator (control variable specified in @ref actuator_config)
 double Actuator_SetSetpoints( Actuator actuator, DoFVariables* ref_setpoints );
 
+/// @brief Adds motor output of given actuator to outputs batch, committed along with other outputs of the same device (see output.h)
+/// @param[in] actuator reference to actuator (not added for actuators with inner control loop, which write their motor on their own thread)
+/// @param[in] batch reference to outputs batch
+/// @return true if motor output was added, false otherwise
+bool Actuator_AddToBatch( Actuator actuator, OutputBatch batch );
+
+/// @brief Gets number of motor output writes skipped by given actuator, for values inside its motor write deadband (see Motor_GetSuppressedWritesNumber)
+/// @param[in] actuator reference to actuator
+/// @return number of suppressed writes since actuator initialization
+size_t Actuator_GetSuppressedWritesNumber( Actuator actuator );
+
 
 #endif // ACTUATOR_H
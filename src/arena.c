@@ -0,0 +1,255 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "arena.h"
+#include "capacity.h"
+
+#include "debug/data_logging.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+// Enough for any fundamental type (and SIMD friendly)
+#define ARENA_ALIGNMENT 16
+
+struct _ArenaData
+{
+  uint8_t* block;
+  size_t size;
+  size_t usedSize;
+  size_t overflowsNumber;
+  Arena next;                           // Live arenas list (for releases outside of current arena)
+};
+
+static Arena currentArena = NULL;
+
+#ifdef ROBOT_FIXED_CAPACITY
+
+// Arenas taken from static memory pool (no heap fallback)
+static ArenaData arenasList[ ROBOT_MAX_ROBOTS ];
+// Blocks of long double elements, to get the strictest fundamental type alignment
+static long double arenaBlocksList[ ROBOT_MAX_ROBOTS ][ ( ROBOT_ARENA_SIZE + sizeof(long double) - 1 ) / sizeof(long double) ];
+
+Arena Arena_Create( size_t size )
+{
+  if( size > ROBOT_ARENA_SIZE ) 
+  {
+    DEBUG_PRINT( "arena size %lu exceeds capacity (%d)", size, ROBOT_ARENA_SIZE );
+    return NULL;
+  }
+  
+  for( size_t arenaIndex = 0; arenaIndex < ROBOT_MAX_ROBOTS; arenaIndex++ )
+  {
+    Arena arena = &(arenasList[ arenaIndex ]);
+    if( arena->block != NULL ) continue;
+    
+    arena->block = (uint8_t*) arenaBlocksList[ arenaIndex ];
+    arena->size = ROBOT_ARENA_SIZE & ~((size_t) ARENA_ALIGNMENT - 1);
+    arena->usedSize = arena->overflowsNumber = 0;
+    memset( arena->block, 0, arena->size );
+    return arena;
+  }
+  
+  DEBUG_PRINT( "no free arena (%d robots)", ROBOT_MAX_ROBOTS );
+  return NULL;
+}
+
+void Arena_Discard( Arena arena )
+{
+  if( arena == NULL ) return;
+  
+  if( currentArena == arena ) currentArena = NULL;
+  
+  arena->block = NULL;
+}
+
+static Arena FindArena( void* data )
+{
+  for( size_t arenaIndex = 0; arenaIndex < ROBOT_MAX_ROBOTS; arenaIndex++ )
+  {
+    Arena arena = &(arenasList[ arenaIndex ]);
+    if( arena->block != NULL && (uint8_t*) data >= arena->block && (uint8_t*) data < arena->block + arena->size ) return arena;
+  }
+  
+  return NULL;
+}
+
+#else
+
+static Arena liveArenasList = NULL;
+
+Arena Arena_Create( size_t size )
+{
+  Arena newArena = (Arena) calloc( 1, sizeof(ArenaData) );
+  if( newArena == NULL ) return NULL;
+  
+  newArena->size = ( size + ARENA_ALIGNMENT - 1 ) & ~((size_t) ARENA_ALIGNMENT - 1);
+  if( (newArena->block = (uint8_t*) calloc( newArena->size, 1 )) == NULL )
+  {
+    free( newArena );
+    return NULL;
+  }
+  
+  newArena->next = liveArenasList;
+  liveArenasList = newArena;
+  
+  return newArena;
+}
+
+void Arena_Discard( Arena arena )
+{
+  if( arena == NULL ) return;
+  
+  if( currentArena == arena ) currentArena = NULL;
+  
+  for( Arena* ref_arena = &liveArenasList; *ref_arena != NULL; ref_arena = &((*ref_arena)->next) )
+  {
+    if( *ref_arena != arena ) continue;
+    *ref_arena = arena->next;
+    break;
+  }
+  
+  free( arena->block );
+  free( arena );
+}
+
+static Arena FindArena( void* data )
+{
+  for( Arena arena = liveArenasList; arena != NULL; arena = arena->next )
+  {
+    if( (uint8_t*) data >= arena->block && (uint8_t*) data < arena->block + arena->size ) return arena;
+  }
+  
+  return NULL;
+}
+
+#endif
+
+void* Arena_Allocate( Arena arena, size_t size )
+{
+  if( arena == NULL ) return NULL;
+  
+  size_t alignedSize = ( size + ARENA_ALIGNMENT - 1 ) & ~((size_t) ARENA_ALIGNMENT - 1);
+  if( alignedSize > arena->size - arena->usedSize ) return NULL;
+  
+  // Block is zeroed on creation and never reused
+  void* data = arena->block + arena->usedSize;
+  arena->usedSize += alignedSize;
+  
+  return data;
+}
+
+size_t Arena_GetUsedSize( Arena arena )
+{
+  if( arena == NULL ) return 0;
+  
+  return arena->usedSize;
+}
+
+size_t Arena_GetOverflowsNumber( Arena arena )
+{
+  if( arena == NULL ) return 0;
+  
+  return arena->overflowsNumber;
+}
+
+void Arena_SetCurrent( Arena arena )
+{
+  currentArena = arena;
+}
+
+void* Arena_Calloc( size_t elementsNumber, size_t elementSize )
+{
+  if( elementsNumber == 0 || elementSize == 0 ) return NULL;
+  
+  if( currentArena != NULL )
+  {
+    void* data = Arena_Allocate( currentArena, elementsNumber * elementSize );
+    if( data != NULL ) return data;
+    
+    if( currentArena->overflowsNumber++ == 0 ) DEBUG_PRINT( "arena %p full (%lu bytes)", currentArena, currentArena->size );
+  }
+  
+#ifdef ROBOT_FIXED_CAPACITY
+  return NULL;
+#else
+  return calloc( elementsNumber, elementSize );
+#endif
+}
+
+void Arena_Free( void* data )
+{
+  // Memory of any live arena (not only the current one) is only released with the whole arena
+  if( data == NULL || FindArena( data ) != NULL ) return;
+  
+#ifndef ROBOT_FIXED_CAPACITY
+  free( data );
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+/////                         HEAP ALLOCATION TRAP                          /////
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifdef ARENA_HEAP_TRAP
+
+// Linker replaces heap calls with the __wrap_ versions, and __real_ ones refer to the original implementations
+void* __real_malloc( size_t );
+void* __real_calloc( size_t, size_t );
+void* __real_realloc( void*, size_t );
+
+static __thread bool isHeapTrapEnabled = false;
+
+static void TrapHeapAllocation( const char* functionName, size_t size )
+{
+  isHeapTrapEnabled = false;
+  fprintf( stderr, "heap allocation trapped on control thread: %s( %lu bytes )\n", functionName, size );
+  abort();
+}
+
+void* __wrap_malloc( size_t size )
+{
+  if( isHeapTrapEnabled ) TrapHeapAllocation( "malloc", size );
+  return __real_malloc( size );
+}
+
+void* __wrap_calloc( size_t elementsNumber, size_t elementSize )
+{
+  if( isHeapTrapEnabled ) TrapHeapAllocation( "calloc", elementsNumber * elementSize );
+  return __real_calloc( elementsNumber, elementSize );
+}
+
+void* __wrap_realloc( void* data, size_t size )
+{
+  if( isHeapTrapEnabled ) TrapHeapAllocation( "realloc", size );
+  return __real_realloc( data, size );
+}
+
+void Arena_SetHeapTrap( bool enabled ) { isHeapTrapEnabled = enabled; }
+
+#else
+
+void Arena_SetHeapTrap( bool enabled ) { (void) enabled; }
+
+#endif
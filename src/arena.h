@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file arena.h
+/// @brief Per-robot memory arena functions
+///
+/// Robot, actuator, sensor, motor, input and output data structures (and their lists) are allocated sequentially from a single memory block, created with the robot,
+/// so that each actuator's data stays contiguous and the whole set is released at once on robot termination. While an arena is set as current, allocations 
+/// of those modules come from it (falling back to the heap when it is exhausted). Releases of memory inside any existing arena are ignored, whichever arena is current.
+/// On fixed-capacity builds (see capacity.h), arenas are taken from a static pool instead, and there is no heap fallback.
+///
+/// On debug builds with ARENA_HEAP_TRAP defined (and heap functions wrapped by the linker, with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc), 
+/// any heap allocation on threads that enabled the trap (like running control loops) aborts the program with an error message.
+
+#ifndef ARENA_H
+#define ARENA_H
+
+
+#include <stddef.h>
+#include <stdbool.h>
+
+
+typedef struct _ArenaData ArenaData;    ///< Memory arena internal data structure
+typedef ArenaData* Arena;               ///< Opaque reference to memory arena internal data structure
+
+
+/// @brief Creates memory arena with fixed capacity
+/// @param[in] size total memory block size (in bytes)
+/// @return reference to newly created arena (NULL on errors)
+Arena Arena_Create( size_t size );
+
+/// @brief Releases all memory of given arena at once
+/// @param[in] arena reference to arena
+void Arena_Discard( Arena arena );
+
+/// @brief Gets zeroed (and aligned) memory from given arena
+/// @param[in] arena reference to arena
+/// @param[in] size requested memory size (in bytes)
+/// @return pointer to allocated memory (NULL if arena capacity is exceeded)
+void* Arena_Allocate( Arena arena, size_t size );
+
+/// @brief Gets amount of memory already taken from given arena
+/// @param[in] arena reference to arena
+/// @return used size (in bytes)
+size_t Arena_GetUsedSize( Arena arena );
+
+/// @brief Gets number of allocations that didn't fit in given arena (and were taken from the heap instead)
+/// @param[in] arena reference to arena
+/// @return heap allocations count
+size_t Arena_GetOverflowsNumber( Arena arena );
+
+/// @brief Sets arena used by subsequent Arena_Calloc/Arena_Free calls (NULL for plain heap usage)
+/// @param[in] arena reference to arena
+void Arena_SetCurrent( Arena arena );
+
+/// @brief Allocates zeroed list from current arena, or from the heap if none is set (or it is full)
+/// @param[in] elementsNumber number of list elements
+/// @param[in] elementSize size of each element (in bytes)
+/// @return pointer to allocated memory (NULL on errors)
+void* Arena_Calloc( size_t elementsNumber, size_t elementSize );
+
+/// @brief Releases memory allocated with Arena_Calloc (no effect for memory inside any existing arena)
+/// @param[in] data pointer to allocated memory
+void Arena_Free( void* data );
+
+/// @brief Enables or disables trapping of heap allocations on calling thread (no effect without ARENA_HEAP_TRAP)
+/// @param[in] enabled true for aborting on heap allocations, false otherwise
+void Arena_SetHeapTrap( bool enabled );
+
+
+#endif // ARENA_H
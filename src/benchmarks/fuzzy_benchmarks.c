@@ -0,0 +1,102 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file fuzzy_benchmarks.c
+/// @brief Fuzzy force controller inference accuracy and speed measurement program
+///
+/// Compares direct fuzzy inference against precomputed surface evaluation (for different table resolutions) over the same random inputs,
+/// printing average evaluation times and interpolation errors as CSV lines
+
+#include "fuzzy_inference.h"
+
+#include "timing/timing.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+const double SETS_WIDTH = 0.2;
+const size_t DEFAULT_SAMPLES_NUMBER = 100000;
+const size_t TABLE_RESOLUTIONS[] = { 16, 32, 64, 128, 256, 512 };
+#define TABLE_RESOLUTIONS_NUMBER ( sizeof(TABLE_RESOLUTIONS) / sizeof(size_t) )
+
+
+/* Program entry-point */
+int main( int argc, char* argv[] )
+{
+  size_t samplesNumber = ( argc > 1 ) ? (size_t) strtoul( argv[ 1 ], NULL, 10 ) : DEFAULT_SAMPLES_NUMBER;
+  if( samplesNumber == 0 ) samplesNumber = 1;
+  
+  double* positionErrorsList = (double*) calloc( samplesNumber, sizeof(double) );
+  double* forceErrorsList = (double*) calloc( samplesNumber, sizeof(double) );
+  double* referenceOutputsList = (double*) calloc( samplesNumber, sizeof(double) );
+  
+  // Inputs are drawn from the table range (direct inference output is numerically meaningless far from all membership sets anyway)
+  srand( 0 );
+  for( size_t sampleIndex = 0; sampleIndex < samplesNumber; sampleIndex++ )
+  {
+    positionErrorsList[ sampleIndex ] = FUZZY_INPUT_LIMIT * ( 2.0 * rand() / RAND_MAX - 1.0 );
+    forceErrorsList[ sampleIndex ] = FUZZY_INPUT_LIMIT * ( 2.0 * rand() / RAND_MAX - 1.0 );
+  }
+  
+  double startTime = Time_GetExecSeconds();
+  for( size_t sampleIndex = 0; sampleIndex < samplesNumber; sampleIndex++ )
+    referenceOutputsList[ sampleIndex ] = FuzzyInference_Evaluate( SETS_WIDTH, positionErrorsList[ sampleIndex ], forceErrorsList[ sampleIndex ] );
+  double directTime = Time_GetExecSeconds() - startTime;
+  
+  printf( "method,resolution,setup_ms,eval_ns,max_error,rms_error\n" );
+  printf( "direct,0,0.0,%.3f,0.0,0.0\n", 1e9 * directTime / samplesNumber );
+  
+  for( size_t resolutionIndex = 0; resolutionIndex < TABLE_RESOLUTIONS_NUMBER; resolutionIndex++ )
+  {
+    startTime = Time_GetExecSeconds();
+    FuzzySurface surface = FuzzySurface_Create( SETS_WIDTH, TABLE_RESOLUTIONS[ resolutionIndex ] );
+    double setupTime = Time_GetExecSeconds() - startTime;
+    
+    // Accumulating outputs keeps evaluations from being optimized away
+    double outputsSum = 0.0;
+    startTime = Time_GetExecSeconds();
+    for( size_t sampleIndex = 0; sampleIndex < samplesNumber; sampleIndex++ )
+      outputsSum += FuzzySurface_Evaluate( surface, positionErrorsList[ sampleIndex ], forceErrorsList[ sampleIndex ] );
+    double surfaceTime = Time_GetExecSeconds() - startTime;
+    
+    double maxError = 0.0, squaredErrorsSum = 0.0;
+    for( size_t sampleIndex = 0; sampleIndex < samplesNumber; sampleIndex++ )
+    {
+      double outputError = fabs( FuzzySurface_Evaluate( surface, positionErrorsList[ sampleIndex ], forceErrorsList[ sampleIndex ] ) - referenceOutputsList[ sampleIndex ] );
+      if( outputError > maxError ) maxError = outputError;
+      squaredErrorsSum += outputError * outputError;
+    }
+    
+    printf( "surface,%lu,%.3f,%.3f,%g,%g\n", TABLE_RESOLUTIONS[ resolutionIndex ], 1e3 * setupTime, 1e9 * surfaceTime / samplesNumber, 
+            maxError, sqrt( squaredErrorsSum / samplesNumber ) );
+    fprintf( stderr, "(outputs sum: %g)\n", outputsSum );
+    
+    FuzzySurface_Discard( surface );
+  }
+  
+  free( positionErrorsList );
+  free( forceErrorsList );
+  free( referenceOutputsList );
+  
+  return 0;
+}
@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file opensim_benchmarks.c
+/// @brief OpenSim model kinematics speed and accuracy measurement program
+///
+/// For each given model file, times forward kinematics (with Jacobian) and warm started inverse kinematics over random coordinate trajectories,
+/// and checks the Jacobian against finite differences, printing results as CSV lines
+
+#include "opensim_model.h"
+
+#include "timing/timing.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+const size_t DEFAULT_SAMPLES_NUMBER = 10000;
+const double COORDINATE_AMPLITUDE = 0.5;
+const double COORDINATE_STEP = 0.01;
+const double FINITE_DIFFERENCE = 1e-6;
+const double IK_DAMPING = 0.01;
+const size_t IK_MAX_ITERATIONS = 10;
+const double IK_TOLERANCE = 1e-4;
+
+
+/* Program entry-point */
+int main( int argc, char* argv[] )
+{
+  if( argc < 2 )
+  {
+    fprintf( stderr, "usage: %s <osim_file> [<osim_file> ...] [<samples_number>]\n", argv[ 0 ] );
+    return -1;
+  }
+  
+  size_t samplesNumber = (size_t) strtoul( argv[ argc - 1 ], NULL, 10 );
+  if( samplesNumber > 0 ) argc--;
+  else samplesNumber = DEFAULT_SAMPLES_NUMBER;
+  
+  printf( "model,coordinates,axes,fk_us,ik_us,ik_iterations,ik_rms_error,jacobian_max_error\n" );
+  
+  for( int fileIndex = 1; fileIndex < argc; fileIndex++ )
+  {
+    OpenSimModel model = OpenSimModel_Load( argv[ fileIndex ] );
+    if( model == NULL ) continue;
+    
+    size_t coordinatesNumber = OpenSimModel_GetCoordinatesNumber( model );
+    size_t axesNumber = OpenSimModel_GetAxesNumber( model );
+    
+    // Smooth random walk of coordinates, and its corresponding axis positions (IK targets)
+    double* coordinatesList = (double*) calloc( samplesNumber * coordinatesNumber, sizeof(double) );
+    double* targetsList = (double*) calloc( samplesNumber * axesNumber, sizeof(double) );
+    srand( 0 );
+    for( size_t sampleIndex = 1; sampleIndex < samplesNumber; sampleIndex++ )
+    {
+      for( size_t coordinateIndex = 0; coordinateIndex < coordinatesNumber; coordinateIndex++ )
+      {
+        double coordinate = coordinatesList[ ( sampleIndex - 1 ) * coordinatesNumber + coordinateIndex ] + COORDINATE_STEP * ( 2.0 * rand() / RAND_MAX - 1.0 );
+        coordinatesList[ sampleIndex * coordinatesNumber + coordinateIndex ] = fmax( -COORDINATE_AMPLITUDE, fmin( coordinate, COORDINATE_AMPLITUDE ) );
+      }
+    }
+    
+    double startTime = Time_GetExecSeconds();
+    for( size_t sampleIndex = 0; sampleIndex < samplesNumber; sampleIndex++ )
+    {
+      OpenSimModel_SetCoordinates( model, coordinatesList + sampleIndex * coordinatesNumber );
+      const double* axisPositionsList = OpenSimModel_GetAxisPositions( model );
+      for( size_t axisIndex = 0; axisIndex < axesNumber; axisIndex++ )
+        targetsList[ sampleIndex * axesNumber + axisIndex ] = axisPositionsList[ axisIndex ];
+    }
+    double fkTime = Time_GetExecSeconds() - startTime;
+    
+    // Jacobian check on last configuration
+    double* referencePositionsList = (double*) calloc( axesNumber, sizeof(double) );
+    double* jacobian = (double*) calloc( axesNumber * coordinatesNumber, sizeof(double) );
+    double* perturbedCoordinatesList = coordinatesList + ( samplesNumber - 1 ) * coordinatesNumber;
+    OpenSimModel_SetCoordinates( model, perturbedCoordinatesList );
+    for( size_t index = 0; index < axesNumber * coordinatesNumber; index++ )
+      jacobian[ index ] = OpenSimModel_GetJacobian( model )[ index ];
+    for( size_t axisIndex = 0; axisIndex < axesNumber; axisIndex++ )
+      referencePositionsList[ axisIndex ] = OpenSimModel_GetAxisPositions( model )[ axisIndex ];
+    double maxJacobianError = 0.0;
+    for( size_t coordinateIndex = 0; coordinateIndex < coordinatesNumber; coordinateIndex++ )
+    {
+      perturbedCoordinatesList[ coordinateIndex ] += FINITE_DIFFERENCE;
+      OpenSimModel_SetCoordinates( model, perturbedCoordinatesList );
+      perturbedCoordinatesList[ coordinateIndex ] -= FINITE_DIFFERENCE;
+      for( size_t axisIndex = 0; axisIndex < axesNumber; axisIndex++ )
+      {
+        double derivative = ( OpenSimModel_GetAxisPositions( model )[ axisIndex ] - referencePositionsList[ axisIndex ] ) / FINITE_DIFFERENCE;
+        maxJacobianError = fmax( maxJacobianError, fabs( derivative - jacobian[ axisIndex * coordinatesNumber + coordinateIndex ] ) );
+      }
+    }
+    
+    // Inverse kinematics tracking, warm started from previous solution (as on control cycles)
+    double* solutionList = (double*) calloc( coordinatesNumber, sizeof(double) );
+    size_t iterationsNumber = 0;
+    double squaredErrorsSum = 0.0;
+    startTime = Time_GetExecSeconds();
+    for( size_t sampleIndex = 0; sampleIndex < samplesNumber; sampleIndex++ )
+      iterationsNumber += OpenSimModel_SolveIK( model, targetsList + sampleIndex * axesNumber, solutionList, IK_DAMPING, IK_MAX_ITERATIONS, IK_TOLERANCE );
+    double ikTime = Time_GetExecSeconds() - startTime;
+    for( size_t axisIndex = 0; axisIndex < axesNumber; axisIndex++ )
+    {
+      double axisError = OpenSimModel_GetAxisPositions( model )[ axisIndex ] - targetsList[ ( samplesNumber - 1 ) * axesNumber + axisIndex ];
+      squaredErrorsSum += axisError * axisError;
+    }
+    
+    printf( "%s,%lu,%lu,%.3f,%.3f,%.2f,%g,%g\n", argv[ fileIndex ], (unsigned long) coordinatesNumber, (unsigned long) axesNumber, 
+            1e6 * fkTime / samplesNumber, 1e6 * ikTime / samplesNumber, (double) iterationsNumber / samplesNumber, 
+            sqrt( squaredErrorsSum / axesNumber ), maxJacobianError );
+    
+    free( solutionList );
+    free( jacobian );
+    free( referencePositionsList );
+    free( coordinatesList );
+    free( targetsList );
+    OpenSimModel_Discard( model );
+  }
+  
+  return 0;
+}
@@ -0,0 +1,437 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file robot_benchmarks.c
+/// @brief Control pass stage costs measurement program
+///
+/// Generates synthetic robot configurations (N joints, M sensors per actuator, different sensor transform expressions), all of them read from DummyIO devices,
+/// loads each one through the regular system initialization path and runs control passes on simulated time, printing per-stage execution times as CSV lines
+///
+/// On closed-loop mode, a given (existing) robot configuration, usually with PlantSimulator devices, is run instead, with a position step setpoint for all axes,
+/// and tracking performance (RMS error and settling time) is printed along with control pass cost
+///
+/// Closed-loop runs may also be recorded (axis measures on each cycle) and checked against a previous recording, usually taken from a double precision build when 
+/// assessing the numerical accuracy of a single precision one (ROBOT_SINGLE_PRECISION build option), with maximum and RMS deviations of axis variables printed
+///
+/// When plugins are linked statically (STATIC_PLUGINS build option), the --dynamic option forces all of them to be loaded as dynamic modules instead, for comparing both call paths
+///
+/// With the --read-latency option, sensor inputs are read from VirtualIO devices taking the given time on each access, and the --pipelined option makes generated
+/// robots read inputs for each control pass on a separate thread (see robot_config), so that effective reading latency (io_wait and sensors stages) and achievable
+/// control rate (back-to-back control passes) of blocking and pipelined reading can be compared. With the --async option, inputs are read from DummyIO devices 
+/// with the same access time instead, through the asynchronous signal I/O extension (see signal_io_extensions.h)
+///
+/// Similarly, the --write-latency option makes motors of all joints write to a single DummyIO device taking the given time on each access, so that the setpoints
+/// stage cost of per-channel writes (static plugins) and per-device multi-channel writes (--dynamic option, see output.h) can be compared
+
+#include "system.h"
+#include "robot.h"
+#include "clock.h"
+#include "profiler.h"
+#include "static_plugins.h"
+#include "scalar.h"
+
+#include "config_keys.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#ifdef WIN32
+#include <direct.h>
+#include "getopt.h"
+#define MAKE_DIRECTORY( dirName ) _mkdir( dirName )
+#else
+#include <sys/stat.h>
+#include <getopt.h>
+#define MAKE_DIRECTORY( dirName ) mkdir( dirName, 0755 )
+#endif
+
+#define BENCHMARK_DIR "benchmark"
+
+#define EXPRESSIONS_NUMBER 2
+
+const char* EXPRESSION_NAMES[ EXPRESSIONS_NUMBER ] = { "linear", "nonlinear" };
+const size_t EXPRESSION_INPUTS_NUMBERS[ EXPRESSIONS_NUMBER ] = { 1, 2 };
+const char* EXPRESSION_FORMULAS[ EXPRESSIONS_NUMBER ] = { "( 2 * pi / 4096 ) * in0", "0.5 * tanh( 3 * in0 ) + sqrt( in1 * in1 + 1 ) - 1" };
+
+const char* SENSOR_VARIABLE_NAMES[] = { "POSITION", "VELOCITY", "FORCE", "ACCELERATION" };
+#define SENSOR_VARIABLES_NUMBER ( sizeof(SENSOR_VARIABLE_NAMES) / sizeof(const char*) )
+
+const size_t DEFAULT_MAX_JOINTS_NUMBER = 128;
+const size_t DEFAULT_MAX_SENSORS_NUMBER = 4;
+const size_t DEFAULT_CYCLES_NUMBER = 1000;
+const size_t WARMUP_CYCLES_NUMBER = 100;
+const double DEFAULT_STEP_AMPLITUDE = 1.0;
+const double SETTLING_TOLERANCE = 0.02;
+
+
+static bool WriteSensorConfig( size_t expressionIndex, double readLatency, bool isAsync )
+{
+  char filePath[ 256 ];
+  sprintf( filePath, KEY_CONFIG "/" KEY_SENSORS "/" BENCHMARK_DIR "/%s.json", EXPRESSION_NAMES[ expressionIndex ] );
+  FILE* configFile = fopen( filePath, "w" );
+  if( configFile == NULL ) return false;
+  
+  fprintf( configFile, "{\n  \"" KEY_INPUTS "\": [\n" );
+  for( size_t inputIndex = 0; inputIndex < EXPRESSION_INPUTS_NUMBERS[ expressionIndex ]; inputIndex++ )
+  {
+    if( readLatency > 0.0 && isAsync )
+      fprintf( configFile, "    %s{ \"" KEY_INTERFACE "\": { \"" KEY_TYPE "\": \"DummyIO\", \"" KEY_CONFIG "\": \"latency=%g\", \"" KEY_CHANNEL "\": %lu } }\n", 
+               ( inputIndex > 0 ) ? "," : "", 1e6 * readLatency, inputIndex );
+    else if( readLatency > 0.0 )
+      fprintf( configFile, "    %s{ \"" KEY_INTERFACE "\": { \"" KEY_TYPE "\": \"VirtualIO\", \"" KEY_CONFIG "\": \"channels=%lu read_latency=fixed:%g\", \"" KEY_CHANNEL "\": %lu } }\n", 
+               ( inputIndex > 0 ) ? "," : "", EXPRESSION_INPUTS_NUMBERS[ expressionIndex ], 1e6 * readLatency, inputIndex );
+    else
+      fprintf( configFile, "    %s{ \"" KEY_INTERFACE "\": { \"" KEY_TYPE "\": \"DummyIO\", \"" KEY_CONFIG "\": \"NULL\", \"" KEY_CHANNEL "\": %lu } }\n", 
+               ( inputIndex > 0 ) ? "," : "", inputIndex );
+  }
+  fprintf( configFile, "  ],\n  \"" KEY_OUTPUT "\": \"%s\"\n}\n", EXPRESSION_FORMULAS[ expressionIndex ] );
+  
+  fclose( configFile );
+  return true;
+}
+
+static bool WriteMotorConfig( double writeLatency )
+{
+  FILE* configFile = fopen( KEY_CONFIG "/" KEY_MOTORS "/" BENCHMARK_DIR "/motor.json", "w" );
+  if( configFile == NULL ) return false;
+  
+  if( writeLatency > 0.0 )
+    fprintf( configFile, "{\n  \"" KEY_INTERFACE "\": { \"" KEY_TYPE "\": \"DummyIO\", \"" KEY_CONFIG "\": \"latency=%g bus=1\", \"" KEY_CHANNEL "\": 0 },\n", 1e6 * writeLatency );
+  else
+    fprintf( configFile, "{\n  \"" KEY_INTERFACE "\": { \"" KEY_TYPE "\": \"DummyIO\", \"" KEY_CONFIG "\": \"NULL\", \"" KEY_CHANNEL "\": 0 },\n" );
+  fprintf( configFile, "  \"" KEY_OUTPUT "\": \"set\"\n}\n" );
+  
+  fclose( configFile );
+  return true;
+}
+
+static bool WriteActuatorConfig( size_t sensorsNumber, size_t expressionIndex )
+{
+  char filePath[ 256 ];
+  sprintf( filePath, KEY_CONFIG "/" KEY_ACTUATORS "/" BENCHMARK_DIR "/%s_%lu.json", EXPRESSION_NAMES[ expressionIndex ], sensorsNumber );
+  FILE* configFile = fopen( filePath, "w" );
+  if( configFile == NULL ) return false;
+  
+  fprintf( configFile, "{\n  \"" KEY_SENSORS "\": [\n" );
+  for( size_t sensorIndex = 0; sensorIndex < sensorsNumber; sensorIndex++ )
+    fprintf( configFile, "    %s{ \"" KEY_VARIABLE "\": \"%s\", \"" KEY_CONFIG "\": \"" BENCHMARK_DIR "/%s\", \"" KEY_DEVIATION "\": 1.0 }\n", ( sensorIndex > 0 ) ? "," : "",
+             SENSOR_VARIABLE_NAMES[ sensorIndex % SENSOR_VARIABLES_NUMBER ], EXPRESSION_NAMES[ expressionIndex ] );
+  fprintf( configFile, "  ],\n  \"" KEY_MOTOR "\": { \"" KEY_VARIABLE "\": \"FORCE\", \"" KEY_CONFIG "\": \"" BENCHMARK_DIR "/motor\" }\n}\n" );
+  
+  fclose( configFile );
+  return true;
+}
+
+static bool WriteRobotConfig( const char* robotName, size_t jointsNumber, size_t sensorsNumber, size_t expressionIndex, bool isPipelined )
+{
+  char filePath[ 256 ];
+  sprintf( filePath, KEY_CONFIG "/" KEY_ROBOTS "/%s.json", robotName );
+  FILE* configFile = fopen( filePath, "w" );
+  if( configFile == NULL ) return false;
+  
+  fprintf( configFile, "{\n  \"" KEY_CONTROLLER "\": { \"" KEY_TYPE "\": \"SyntheticJoints\", \"" KEY_CONFIG "\": \"%lu 1.0 0.1\", \"" KEY_PIPELINED_IO "\": %s },\n", 
+           jointsNumber, isPipelined ? "true" : "false" );
+  fprintf( configFile, "  \"" KEY_ACTUATORS "\": [ " );
+  for( size_t jointIndex = 0; jointIndex < jointsNumber; jointIndex++ )
+    fprintf( configFile, "%s\"" BENCHMARK_DIR "/%s_%lu\"", ( jointIndex > 0 ) ? ", " : "", EXPRESSION_NAMES[ expressionIndex ], sensorsNumber );
+  fprintf( configFile, " ],\n  \"" KEY_LOG "\": { \"" KEY_FILE "\": true, \"" KEY_PRECISION "\": 5 }\n}\n" );
+  
+  fclose( configFile );
+  return true;
+}
+
+static void RunBenchmark( FILE* outputFile, const char* pluginsMode, bool isPipelined, size_t jointsNumber, size_t sensorsNumber, size_t expressionIndex, size_t cyclesNumber )
+{
+  char robotName[ 128 ];
+  sprintf( robotName, BENCHMARK_DIR "/robot_%s_%lu_%lu", EXPRESSION_NAMES[ expressionIndex ], jointsNumber, sensorsNumber );
+  
+  if( !WriteRobotConfig( robotName, jointsNumber, sensorsNumber, expressionIndex, isPipelined ) ) return;
+  
+  if( !System_SetRobot( robotName ) )
+  {
+    fprintf( stderr, "failed to load benchmark robot %s\n", robotName );
+    return;
+  }
+  
+  Robot robot = System_GetRobot( 0 );
+  Robot_Enable( robot );
+  Robot_SetControlState( robot, CONTROL_OPERATION );
+  
+  for( size_t cycleIndex = 0; cycleIndex < WARMUP_CYCLES_NUMBER; cycleIndex++ )
+    System_Update();
+  
+  Profiler_Reset();
+  double startTime = Profiler_GetTime();
+  for( size_t cycleIndex = 0; cycleIndex < cyclesNumber; cycleIndex++ )
+    System_Update();
+  double totalTime = Profiler_GetTime() - startTime;
+  
+  // Average times per control cycle, in microseconds (passes run back-to-back, so that cycle time gives the achievable control rate)
+  fprintf( outputFile, "%s,%s,%lu,%lu,%s,%lu,%.3f,%.1f", pluginsMode, isPipelined ? "pipelined" : "blocking", jointsNumber, sensorsNumber, EXPRESSION_NAMES[ expressionIndex ], 
+           cyclesNumber, 1e6 * totalTime / cyclesNumber, cyclesNumber / totalTime );
+  for( int stageIndex = 0; stageIndex < PROFILER_STAGES_NUMBER; stageIndex++ )
+    fprintf( outputFile, ",%.3f", 1e6 * Profiler_GetStageTime( stageIndex ) / cyclesNumber );
+  fprintf( outputFile, "\n" );
+  fflush( outputFile );
+  
+  Robot_Disable( robot );
+}
+
+enum { RECORD_POSITION, RECORD_VELOCITY, RECORD_FORCE, RECORD_VARIABLES_NUMBER };
+
+static bool RunClosedLoopBenchmark( FILE* outputFile, const char* robotName, size_t cyclesNumber, double stepAmplitude, FILE* recordFile, FILE* referenceFile, double tolerance )
+{
+  if( !System_SetRobot( robotName ) )
+  {
+    fprintf( stderr, "failed to load robot %s\n", robotName );
+    return false;
+  }
+  
+  Robot robot = System_GetRobot( 0 );
+  size_t axesNumber = Robot_GetAxesNumber( robot );
+  double* squaredErrorsList = (double*) calloc( axesNumber, sizeof(double) );
+  double* settlingTimesList = (double*) calloc( axesNumber, sizeof(double) );
+  double* maxDeviationsList = (double*) calloc( axesNumber * RECORD_VARIABLES_NUMBER, sizeof(double) );
+  double* squaredDeviationsList = (double*) calloc( axesNumber * RECORD_VARIABLES_NUMBER, sizeof(double) );
+  size_t referenceCyclesNumber = 0;
+  
+  Robot_Enable( robot );
+  Robot_SetControlState( robot, CONTROL_OPERATION );
+  
+  DoFVariables stepSetpoints = { .position = stepAmplitude };
+  for( size_t axisIndex = 0; axisIndex < axesNumber; axisIndex++ )
+    Robot_SetAxisSetpoints( robot, axisIndex, &stepSetpoints );
+  
+  size_t startSuppressedWritesNumber = Robot_GetSuppressedWritesNumber( robot );
+  double startSimulationTime = Clock_GetExecSeconds();
+  double totalCycleTime = 0.0;
+  for( size_t cycleIndex = 0; cycleIndex < cyclesNumber; cycleIndex++ )
+  {
+    double cycleStartTime = Profiler_GetTime();
+    System_Update();
+    totalCycleTime += Profiler_GetTime() - cycleStartTime;
+    
+    for( size_t axisIndex = 0; axisIndex < axesNumber; axisIndex++ )
+    {
+      DoFVariables axisMeasures = { 0 };
+      (void) Robot_GetAxisMeasures( robot, axisIndex, &axisMeasures );
+      double trackingError = stepAmplitude - axisMeasures.position;
+      squaredErrorsList[ axisIndex ] += trackingError * trackingError;
+      // Settling time is the last instant the error is outside tolerance band
+      if( fabs( trackingError ) > SETTLING_TOLERANCE * fabs( stepAmplitude ) )
+        settlingTimesList[ axisIndex ] = Clock_GetExecSeconds() - startSimulationTime;
+      
+      double recordValues[ RECORD_VARIABLES_NUMBER ] = { axisMeasures.position, axisMeasures.velocity, axisMeasures.force };
+      if( recordFile != NULL ) 
+        fprintf( recordFile, "%lu,%lu,%.17g,%.17g,%.17g\n", cycleIndex, axisIndex, recordValues[ RECORD_POSITION ], recordValues[ RECORD_VELOCITY ], recordValues[ RECORD_FORCE ] );
+      
+      unsigned long referenceCycle, referenceAxis;
+      double referenceValues[ RECORD_VARIABLES_NUMBER ];
+      if( referenceFile != NULL && fscanf( referenceFile, "%lu,%lu,%lf,%lf,%lf", &referenceCycle, &referenceAxis, 
+                                           &(referenceValues[ RECORD_POSITION ]), &(referenceValues[ RECORD_VELOCITY ]), &(referenceValues[ RECORD_FORCE ]) ) == 5 )
+      {
+        if( referenceCycle != cycleIndex || referenceAxis != axisIndex ) continue;
+        for( size_t variableIndex = 0; variableIndex < RECORD_VARIABLES_NUMBER; variableIndex++ )
+        {
+          double deviation = fabs( recordValues[ variableIndex ] - referenceValues[ variableIndex ] );
+          double* ref_maxDeviation = &(maxDeviationsList[ axisIndex * RECORD_VARIABLES_NUMBER + variableIndex ]);
+          if( deviation > *ref_maxDeviation ) *ref_maxDeviation = deviation;
+          squaredDeviationsList[ axisIndex * RECORD_VARIABLES_NUMBER + variableIndex ] += deviation * deviation;
+        }
+        if( axisIndex == 0 ) referenceCyclesNumber++;
+      }
+    }
+  }
+  
+  // Motor writes skipped inside write deadbands (whole robot, repeated for each axis row)
+  size_t suppressedWritesNumber = Robot_GetSuppressedWritesNumber( robot ) - startSuppressedWritesNumber;
+  for( size_t axisIndex = 0; axisIndex < axesNumber; axisIndex++ )
+  {
+    fprintf( outputFile, "%s,%lu,%lu,%.3f,%g,%g,%lu", robotName, axisIndex, cyclesNumber, 1e6 * totalCycleTime / cyclesNumber, 
+             sqrt( squaredErrorsList[ axisIndex ] / cyclesNumber ), settlingTimesList[ axisIndex ], suppressedWritesNumber );
+    if( referenceFile != NULL )
+    {
+      fprintf( outputFile, ",%s,%lu", ( sizeof(Scalar) == sizeof(float) ) ? "single" : "double", referenceCyclesNumber );
+      for( size_t variableIndex = 0; variableIndex < RECORD_VARIABLES_NUMBER; variableIndex++ )
+      {
+        size_t deviationIndex = axisIndex * RECORD_VARIABLES_NUMBER + variableIndex;
+        fprintf( outputFile, ",%g,%g", maxDeviationsList[ deviationIndex ], 
+                 ( referenceCyclesNumber > 0 ) ? sqrt( squaredDeviationsList[ deviationIndex ] / referenceCyclesNumber ) : 0.0 );
+      }
+    }
+    fprintf( outputFile, "\n" );
+  }
+  fflush( outputFile );
+  
+  // With a given tolerance, any (absolute) deviation above it, or a reference not covering all cycles, fails the comparison
+  bool isWithinTolerance = true;
+  if( tolerance >= 0.0 )
+  {
+    if( referenceFile == NULL || referenceCyclesNumber < cyclesNumber ) isWithinTolerance = false;
+    for( size_t deviationIndex = 0; deviationIndex < axesNumber * RECORD_VARIABLES_NUMBER; deviationIndex++ )
+    {
+      if( maxDeviationsList[ deviationIndex ] > tolerance ) isWithinTolerance = false;
+    }
+    if( !isWithinTolerance ) fprintf( stderr, "reference comparison failed (tolerance %g, %lu of %lu cycles compared)\n", tolerance, referenceCyclesNumber, cyclesNumber );
+  }
+  
+  Robot_Disable( robot );
+  
+  free( squaredErrorsList );
+  free( settlingTimesList );
+  free( maxDeviationsList );
+  free( squaredDeviationsList );
+  
+  return isWithinTolerance;
+}
+
+/* Program entry-point */
+int main( int argc, char* argv[] )
+{
+  size_t maxJointsNumber = DEFAULT_MAX_JOINTS_NUMBER;
+  size_t maxSensorsNumber = DEFAULT_MAX_SENSORS_NUMBER;
+  size_t cyclesNumber = DEFAULT_CYCLES_NUMBER;
+  const char* outputFileName = NULL;
+  const char* closedLoopRobotName = NULL;
+  double stepAmplitude = DEFAULT_STEP_AMPLITUDE;
+  const char* pluginsMode = "static";
+  const char* recordFileName = NULL;
+  const char* referenceFileName = NULL;
+  double tolerance = -1.0;
+  double readLatency = 0.0;
+  double writeLatency = 0.0;
+  bool isPipelined = false;
+  bool isAsync = false;
+  
+  static struct option longOptions[] =
+  {
+    { "help", no_argument, NULL, 'h' },
+    { "joints", required_argument, NULL, 'j' },
+    { "sensors", required_argument, NULL, 's' },
+    { "cycles", required_argument, NULL, 'n' },
+    { "output", required_argument, NULL, 'o' },
+    { "closed-loop", required_argument, NULL, 'c' },
+    { "step", required_argument, NULL, 'a' },
+    { "dynamic", no_argument, NULL, 'd' },
+    { "record", required_argument, NULL, 'r' },
+    { "reference", required_argument, NULL, 'f' },
+    { "tolerance", required_argument, NULL, 't' },
+    { "read-latency", required_argument, NULL, 'l' },
+    { "pipelined", no_argument, NULL, 'p' },
+    { "async", no_argument, NULL, 'y' },
+    { "write-latency", required_argument, NULL, 'w' },
+    { NULL, 0, NULL, 0 }
+  };
+  
+  int optionChar;
+  int optionIndex;
+  while( (optionChar = getopt_long( argc, argv, "hj:s:n:o:c:a:dr:f:t:l:pyw:", longOptions, &optionIndex )) != -1 )
+  {
+    if( optionChar == 'h' )
+    {
+      printf( "usage: %s [--joints <max_joints_number>] [--sensors <max_sensors_number>] [--cycles <cycles_number>] [--output <csv_file>] [--closed-loop <robot_name> [--step <amplitude>] [--record <csv_file>] [--reference <csv_file> [--tolerance <max_deviation>]]] [--dynamic] [--read-latency <microseconds> [--async]] [--pipelined] [--write-latency <microseconds>]\n", argv[ 0 ] );
+      return 0;
+    }
+    else if( optionChar == 'j' ) maxJointsNumber = (size_t) strtoul( optarg, NULL, 10 );
+    else if( optionChar == 's' ) maxSensorsNumber = (size_t) strtoul( optarg, NULL, 10 );
+    else if( optionChar == 'n' ) cyclesNumber = (size_t) strtoul( optarg, NULL, 10 );
+    else if( optionChar == 'o' ) outputFileName = optarg;
+    else if( optionChar == 'c' ) closedLoopRobotName = optarg;
+    else if( optionChar == 'a' ) stepAmplitude = strtod( optarg, NULL );
+    else if( optionChar == 'd' ) pluginsMode = "dynamic";
+    else if( optionChar == 'r' ) recordFileName = optarg;
+    else if( optionChar == 'f' ) referenceFileName = optarg;
+    else if( optionChar == 't' ) tolerance = strtod( optarg, NULL );
+    else if( optionChar == 'l' ) readLatency = 1e-6 * strtod( optarg, NULL );
+    else if( optionChar == 'p' ) isPipelined = true;
+    else if( optionChar == 'y' ) isAsync = true;
+    else if( optionChar == 'w' ) writeLatency = 1e-6 * strtod( optarg, NULL );
+  }
+  if( cyclesNumber == 0 ) cyclesNumber = 1;
+  
+  StaticPlugins_SetEnabled( ( strcmp( pluginsMode, "static" ) == 0 ) );
+  
+  FILE* outputFile = ( outputFileName != NULL ) ? fopen( outputFileName, "w" ) : stdout;
+  if( outputFile == NULL ) return -1;
+  
+  // Robot system reads its own (simulated time) options
+  const char* systemArgs[] = { argv[ 0 ], "--sim", "--log", "./" KEY_LOGS "/" };
+  optind = 1;
+  
+  if( closedLoopRobotName != NULL )
+  {
+    FILE* recordFile = ( recordFileName != NULL ) ? fopen( recordFileName, "w" ) : NULL;
+    FILE* referenceFile = ( referenceFileName != NULL ) ? fopen( referenceFileName, "r" ) : NULL;
+    if( referenceFileName != NULL && referenceFile == NULL ) fprintf( stderr, "failed to open reference file %s\n", referenceFileName );
+    if( !System_Init( sizeof(systemArgs) / sizeof(const char*), systemArgs ) ) return -1;
+    fprintf( outputFile, "robot,axis,cycles,cycle_us,rms_error,settling_time,suppressed_writes" );
+    if( referenceFile != NULL ) 
+      fprintf( outputFile, ",precision,reference_cycles,max_position_deviation,rms_position_deviation,max_velocity_deviation,rms_velocity_deviation,max_force_deviation,rms_force_deviation" );
+    fprintf( outputFile, "\n" );
+    bool isPassing = RunClosedLoopBenchmark( outputFile, closedLoopRobotName, cyclesNumber, stepAmplitude, recordFile, referenceFile, tolerance );
+    System_End();
+    if( recordFile != NULL ) fclose( recordFile );
+    if( referenceFile != NULL ) fclose( referenceFile );
+    if( outputFile != stdout ) fclose( outputFile );
+    return isPassing ? 0 : 1;
+  }
+  
+  MAKE_DIRECTORY( KEY_CONFIG "/" KEY_ROBOTS "/" BENCHMARK_DIR );
+  MAKE_DIRECTORY( KEY_CONFIG "/" KEY_ACTUATORS "/" BENCHMARK_DIR );
+  MAKE_DIRECTORY( KEY_CONFIG "/" KEY_SENSORS "/" BENCHMARK_DIR );
+  MAKE_DIRECTORY( KEY_CONFIG "/" KEY_MOTORS "/" BENCHMARK_DIR );
+  MAKE_DIRECTORY( KEY_LOGS );
+  MAKE_DIRECTORY( KEY_LOGS "/" BENCHMARK_DIR );
+  
+  if( !WriteMotorConfig( writeLatency ) ) return -1;
+  for( size_t expressionIndex = 0; expressionIndex < EXPRESSIONS_NUMBER; expressionIndex++ )
+  {
+    if( !WriteSensorConfig( expressionIndex, readLatency, isAsync ) ) return -1;
+    for( size_t sensorsNumber = 1; sensorsNumber <= maxSensorsNumber; sensorsNumber *= 2 )
+    {
+      if( !WriteActuatorConfig( sensorsNumber, expressionIndex ) ) return -1;
+    }
+  }
+  
+  if( !System_Init( sizeof(systemArgs) / sizeof(const char*), systemArgs ) ) return -1;
+  
+  fprintf( outputFile, "plugins,io,joints,sensors,expression,cycles,cycle_us,max_rate_hz" );
+  for( int stageIndex = 0; stageIndex < PROFILER_STAGES_NUMBER; stageIndex++ )
+    fprintf( outputFile, ",%s_us", PROFILER_STAGE_NAMES[ stageIndex ] );
+  fprintf( outputFile, "\n" );
+  
+  for( size_t expressionIndex = 0; expressionIndex < EXPRESSIONS_NUMBER; expressionIndex++ )
+  {
+    for( size_t sensorsNumber = 1; sensorsNumber <= maxSensorsNumber; sensorsNumber *= 2 )
+    {
+      for( size_t jointsNumber = 1; jointsNumber <= maxJointsNumber; jointsNumber *= 2 )
+        RunBenchmark( outputFile, pluginsMode, isPipelined, jointsNumber, sensorsNumber, expressionIndex, cyclesNumber );
+    }
+  }
+  
+  System_End();
+  
+  if( outputFile != stdout ) fclose( outputFile );
+  
+  return 0;
+}
@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "robot_control/robot_control.h"
+#include "robot_control_extensions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DOFS_MAX_NUMBER 256
+
+typedef struct _ControlData
+{
+  char dofNamesData[ DOFS_MAX_NUMBER ][ 16 ];
+  const char* dofNamesList[ DOFS_MAX_NUMBER ];
+  size_t dofsNumber;
+  double proportionalGain, derivativeGain;
+}
+ControlData;
+
+
+DECLARE_MODULE_INTERFACE( ROBOT_CONTROL_CONTEXT_INTERFACE );
+
+
+ControllerContext CreateController( const char* configurationString ) 
+{
+  // Configuration string: "<dofs_number> [<proportional_gain> <derivative_gain>]"
+  char* parameterEnd;
+  size_t dofsNumber = (size_t) strtoul( configurationString, &parameterEnd, 10 );
+  if( dofsNumber == 0 || dofsNumber > DOFS_MAX_NUMBER ) return NULL;
+  
+  ControlData* controlData = (ControlData*) calloc( 1, sizeof(ControlData) );
+  if( controlData == NULL ) return NULL;
+  
+  controlData->dofsNumber = dofsNumber;
+  controlData->proportionalGain = strtod( parameterEnd, &parameterEnd );
+  controlData->derivativeGain = strtod( parameterEnd, &parameterEnd );
+  
+  for( size_t dofIndex = 0; dofIndex < dofsNumber; dofIndex++ )
+  {
+    snprintf( controlData->dofNamesData[ dofIndex ], 16, "dof_%lu", dofIndex );
+    controlData->dofNamesList[ dofIndex ] = controlData->dofNamesData[ dofIndex ];
+  }
+  
+  return controlData; 
+}
+
+void DiscardController( ControllerContext context ) 
+{ 
+  free( context ); 
+}
+
+size_t GetControllerJointsNumber( ControllerContext context ) { return ((ControlData*) context)->dofsNumber; }
+
+const char** GetControllerJointNamesList( ControllerContext context ) { return ((ControlData*) context)->dofNamesList; }
+
+size_t GetControllerAxesNumber( ControllerContext context ) { return ((ControlData*) context)->dofsNumber; }
+
+const char** GetControllerAxisNamesList( ControllerContext context ) { return ((ControlData*) context)->dofNamesList; }
+
+size_t GetControllerExtraInputsNumber( ControllerContext context ) { return 0; }
+      
+void SetControllerExtraInputsList( ControllerContext context, double* inputsList ) { return; }
+
+size_t GetControllerExtraOutputsNumber( ControllerContext context ) { return 0; }
+         
+void GetControllerExtraOutputsList( ControllerContext context, double* outputsList ) { return; }
+
+void SetControllerState( ControllerContext context, enum ControlState newControlState ) { return; }
+
+void RunControllerStep( ControllerContext context, DoFVariables** jointMeasuresList, DoFVariables** axisMeasuresList, DoFVariables** jointSetpointsList, DoFVariables** axisSetpointsList, double timeDelta )
+{
+  ControlData* controlData = (ControlData*) context;
+  
+  // Joints are mapped 1:1 to axes, with a PD force law, so that control cost grows linearly with DoFs number
+  for( size_t dofIndex = 0; dofIndex < controlData->dofsNumber; dofIndex++ )
+  {
+    *(axisMeasuresList[ dofIndex ]) = *(jointMeasuresList[ dofIndex ]);
+    
+    double positionError = axisSetpointsList[ dofIndex ]->position - axisMeasuresList[ dofIndex ]->position;
+    double velocityError = axisSetpointsList[ dofIndex ]->velocity - axisMeasuresList[ dofIndex ]->velocity;
+    
+    *(jointSetpointsList[ dofIndex ]) = *(axisSetpointsList[ dofIndex ]);
+    jointSetpointsList[ dofIndex ]->force = axisSetpointsList[ dofIndex ]->force + controlData->proportionalGain * positionError + controlData->derivativeGain * velocityError;
+  }
+}
@@ -0,0 +1,68 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file capacity.h
+/// @brief Fixed-capacity build profile limits
+///
+/// For constrained real-time targets, building with ROBOT_FIXED_CAPACITY defined takes all robot data from statically allocated arenas (see arena.h), never from the heap,
+/// so that memory usage is known at compile time. Robot configurations are then checked against the limits below (which may be overridden on the compiler command line) 
+/// before anything is allocated, and rejected when exceeding them.
+/// Internal buffers of the external libraries (Kalman filter, linearizer, signal processing, expression parser and data logging) are still created on initialization.
+
+#ifndef CAPACITY_H
+#define CAPACITY_H
+
+
+#ifdef ROBOT_FIXED_CAPACITY
+
+#ifndef ROBOT_MAX_ROBOTS
+#define ROBOT_MAX_ROBOTS 1                  ///< Number of robots that may be loaded at the same time (one static arena each)
+#endif
+
+#ifndef ROBOT_MAX_JOINTS
+#define ROBOT_MAX_JOINTS 8                  ///< Maximum number of joints (actuators) per robot
+#endif
+
+#ifndef ROBOT_MAX_AXES
+#define ROBOT_MAX_AXES 8                    ///< Maximum number of axes per robot
+#endif
+
+#ifndef ROBOT_MAX_SENSORS
+#define ROBOT_MAX_SENSORS 4                 ///< Maximum number of sensors per actuator
+#endif
+
+#ifndef ROBOT_MAX_INPUTS
+#define ROBOT_MAX_INPUTS 2                  ///< Maximum number of inputs per sensor
+#endif
+
+#ifndef ROBOT_MAX_TRAJECTORY_POINTS
+#define ROBOT_MAX_TRAJECTORY_POINTS 128     ///< Maximum (and default) trajectory buffer capacity per axis
+#endif
+
+#ifndef ROBOT_ARENA_SIZE
+#define ROBOT_ARENA_SIZE ( 128 * 1024 )     ///< Static memory block size (in bytes) for each robot
+#endif
+
+#endif // ROBOT_FIXED_CAPACITY
+
+
+#endif // CAPACITY_H
@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "clock.h"
+
+#include "seqlock.h"
+
+#include "timing/timing.h"
+
+// Real time between virtual time checks of threads waiting on simulated mode
+const unsigned long VIRTUAL_TIME_POLL_INTERVAL_MS = 1;
+
+static enum ClockSource clockSource = CLOCK_SOURCE_SYSTEM;
+// Only written by the simulation driver, and read consistently (doubles are not atomic everywhere) by any thread
+static double virtualTime = 0.0;
+static SeqLock virtualTimeLock;
+
+
+static double GetVirtualTime( void )
+{
+  double time;
+  uint32_t sequence;
+  do {
+    sequence = SeqLock_BeginRead( &virtualTimeLock );
+    time = virtualTime;
+  } while( !SeqLock_EndRead( &virtualTimeLock, sequence ) );
+  
+  return time;
+}
+
+static void SetVirtualTime( double time )
+{
+  SeqLock_BeginWrite( &virtualTimeLock );
+  virtualTime = time;
+  SeqLock_EndWrite( &virtualTimeLock );
+}
+
+
+void Clock_SetSource( enum ClockSource newSource )
+{
+  if( newSource >= CLOCK_SOURCES_NUMBER ) return;
+
+  SetVirtualTime( 0.0 );
+
+  clockSource = newSource;
+}
+
+enum ClockSource Clock_GetSource( void )
+{
+  return clockSource;
+}
+
+double Clock_GetExecSeconds( void )
+{
+  if( clockSource == CLOCK_SOURCE_SIMULATED ) return GetVirtualTime();
+
+  return Time_GetExecSeconds();
+}
+
+unsigned long Clock_GetExecMilliseconds( void )
+{
+  if( clockSource == CLOCK_SOURCE_SIMULATED ) return (unsigned long) ( 1000.0 * GetVirtualTime() );
+
+  return Time_GetExecMilliseconds();
+}
+
+void Clock_Delay( double timeInterval )
+{
+  if( timeInterval <= 0.0 ) return;
+
+  if( clockSource == CLOCK_SOURCE_SIMULATED )
+  {
+    // Virtual time is never moved here: waiting threads sleep until the driver takes it past their target
+    double targetTime = GetVirtualTime() + timeInterval;
+    while( clockSource == CLOCK_SOURCE_SIMULATED && GetVirtualTime() < targetTime ) Time_Delay( VIRTUAL_TIME_POLL_INTERVAL_MS );
+  }
+  else Time_Delay( (unsigned long) ( 1000 * timeInterval ) );
+}
+
+void Clock_Advance( double timeDelta )
+{
+  if( clockSource != CLOCK_SOURCE_SIMULATED ) return;
+
+  if( timeDelta > 0.0 ) SetVirtualTime( virtualTime + timeDelta );
+}
@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file clock.h
+/// @brief Control time source functions
+///
+/// Interface for the clock used by control, actuation and logging code. By default, time is read from the system (wall) clock, through [Precise Timing](https://github.com/AeroTechLab/Precise-Timing) calls.
+/// On simulated mode, time is virtual and only moves forward when explicitly advanced by its (single) driver thread, so that control passes run as fast as possible, with exactly reproducible time steps.
+/// Any other thread may read it, or wait for it to reach a given value with delay calls.
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+
+#include <stdbool.h>
+
+
+/// Possible sources for control time values
+enum ClockSource { CLOCK_SOURCE_SYSTEM, CLOCK_SOURCE_SIMULATED, CLOCK_SOURCES_NUMBER };
+
+
+/// @brief Sets time source for all subsequent clock calls (virtual time is reset to 0 on simulated mode)
+/// @param[in] source new time source
+void Clock_SetSource( enum ClockSource source );
+
+/// @brief Gets current time source
+/// @return time source set for clock calls
+enum ClockSource Clock_GetSource( void );
+
+/// @brief Gets time passed since program (or simulation) start
+/// @return time value (in seconds)
+double Clock_GetExecSeconds( void );
+
+/// @brief Gets time passed since program (or simulation) start
+/// @return time value (in milliseconds)
+unsigned long Clock_GetExecMilliseconds( void );
+
+/// @brief Waits for the given time interval (on simulated mode, until the driver advances virtual time past it, so it must not be called by the driver itself)
+/// @param[in] timeInterval time (in seconds) to be waited
+void Clock_Delay( double timeInterval );
+
+/// @brief Moves virtual time forward (no effect on system clock mode, and only to be called by the simulation driver thread)
+/// @param[in] timeDelta time (in seconds) to be added to virtual time
+void Clock_Advance( double timeDelta );
+
+
+#endif // CLOCK_H
@@ -0,0 +1,46 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "compiled_config.h"
+
+#include <string.h>
+
+// Lists generated by ConfigCompiler, terminated by entries with NULL name
+extern const CompiledSensor COMPILED_SENSORS_LIST[];
+extern const CompiledMotor COMPILED_MOTORS_LIST[];
+
+
+const CompiledSensor* CompiledConfig_GetSensor( const char* configName )
+{
+  for( const CompiledSensor* entry = COMPILED_SENSORS_LIST; entry->name != NULL; entry++ )
+    if( strcmp( entry->name, configName ) == 0 ) return entry;
+  
+  return NULL;
+}
+
+const CompiledMotor* CompiledConfig_GetMotor( const char* configName )
+{
+  for( const CompiledMotor* entry = COMPILED_MOTORS_LIST; entry->name != NULL; entry++ )
+    if( strcmp( entry->name, configName ) == 0 ) return entry;
+  
+  return NULL;
+}
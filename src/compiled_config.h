@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file compiled_config.h
+/// @brief Build-time specialized robot configuration entries
+///
+/// The **ConfigCompiler** tool reads robot configurations (and their actuator, sensor and motor files) and generates a C translation unit with their transform expressions
+/// translated to C code (with constant inputs number). Applications built with COMPILED_CONFIG defined link it
+/// and look entries up by configuration name, falling back to generic (runtime evaluated) processing for missing or outdated ones
+
+#ifndef COMPILED_CONFIG_H
+#define COMPILED_CONFIG_H
+
+
+#include "input.h"
+
+#include <stddef.h>
+
+
+typedef double (*CompiledSensorUpdate)( Input* inputsList );             ///< Reads all sensor inputs and returns transformed measurement
+typedef double (*CompiledMotorTransform)( double setpoint, double reference );  ///< Converts motor setpoint (and reference offset) to output value
+
+/// Sensor with compiled inputs reading and transform
+typedef struct _CompiledSensor
+{
+  const char* name;                   ///< Sensor configuration name
+  const char* expression;             ///< Original output expression (checked against current configuration)
+  size_t inputsNumber;                ///< Constant inputs number
+  CompiledSensorUpdate Update;        ///< Specialized update function
+}
+CompiledSensor;
+
+/// Motor with compiled output transform
+typedef struct _CompiledMotor
+{
+  const char* name;                   ///< Motor configuration name
+  const char* expression;             ///< Original output expression (checked against current configuration)
+  CompiledMotorTransform Transform;   ///< Specialized transform function
+}
+CompiledMotor;
+
+
+
+/// @brief Gets compiled entry for given sensor
+/// @param[in] configName sensor configuration name
+/// @return pointer to compiled sensor entry (NULL if not compiled)
+const CompiledSensor* CompiledConfig_GetSensor( const char* configName );
+
+/// @brief Gets compiled entry for given motor
+/// @param[in] configName motor configuration name
+/// @return pointer to compiled motor entry (NULL if not compiled)
+const CompiledMotor* CompiledConfig_GetMotor( const char* configName );
+
+
+#endif // COMPILED_CONFIG_H
@@ -14,10 +14,13 @@
 #define KEY_ID                    "id"
 #define KEY_JOINTS                "joints"
 #define KEY_AXES                  "axes"
+#define KEY_FIRST_AXIS            "first_axis"
 #define KEY_SIGNAL_IO             "signal_io"
 #define KEY_ROBOT_CONTROL         "robot_control"
 #define KEY_CONTROLLER            "controller"
 #define KEY_TIME_STEP             "time_step"
+#define KEY_CPU                   "cpu"
+#define KEY_PIPELINED_IO          "pipelined_io"
 #define KEY_INTERFACE             "interface"
 #define KEY_TYPE                  "type"
 #define KEY_CHANNEL               "channel"
@@ -38,6 +41,19 @@
 #define KEY_MAX_FREQUENCY         "max_" KEY_FREQUENCY
 #define KEY_RECTIFIED             "rectified"
 #define KEY_NORMALIZED            "normalized"
+#define KEY_ACQUISITION           "acquisition"
+#define KEY_ENVELOPE_FREQUENCY    "envelope_" KEY_FREQUENCY
+#define KEY_DECIMATION            "decimation"
+#define KEY_INNER_LOOP            "inner_loop"
+#define KEY_RATE                  "rate"
+#define KEY_GAINS                 "gains"
+#define KEY_WRITE                 "write"
+#define KEY_DEADBAND              "deadband"
+#define KEY_REFRESH_INTERVAL      "refresh_interval"
+#define KEY_TRAJECTORY            "trajectory"
+#define KEY_MAX_POINTS            "max_points"
+#define KEY_MEMORY                "memory"
+#define KEY_ARENA_SIZE            "arena_size"
 #define KEY_LOG                   "log"
 #define KEY_LOGS                  KEY_LOG "s"
 #define KEY_FILE                  "to_file"
@@ -22,10 +22,18 @@
 
 #include "input.h"
 
+#include "seqlock.h"
+
 #include "signal_io/signal_io.h"
+#include "static_plugins.h"
+#include "signal_io_extensions.h"
+#include "arena.h"
+#include "threads/threads.h"
+#include "timing/timing.h"
 #include "debug/data_logging.h"
 
 #include "config_keys.h"
+#include "scalar.h"
 
 #include <math.h>
 #include <stdio.h>
@@ -33,16 +41,59 @@
 #include <stdlib.h>
 #include <string.h>
 
+#define ACQUIRED_INPUTS_MAX_NUMBER 64
+
+const unsigned long ACQUISITION_IDLE_INTERVAL_MS = 1;
+
+// Second order (Butterworth) IIR filter section
+typedef struct _BiquadFilter
+{
+  Scalar b0, b1, b2, a1, a2;
+  Scalar z1, z2;
+}
+BiquadFilter;
+
+// Band-pass -> rectification -> low-pass envelope -> decimation, run on acquisition thread
+typedef struct _EnvelopeStage
+{
+  BiquadFilter highPassFilter, lowPassFilter, envelopeFilter;
+  size_t decimationFactor, decimationCount;
+  double envelope;
+  SeqLock envelopeLock;
+}
+EnvelopeStage;
+
 struct _InputData
 {
   DECLARE_MODULE_INTERFACE_REF( SIGNAL_IO_INTERFACE );
+  DECLARE_MODULE_INTERFACE_REF( SIGNAL_IO_ASYNC_INTERFACE );
+  bool isReadPending;
   long int deviceID;
   unsigned int channel;
   double* buffer;
+  size_t prefetchedSamplesNumber;
+  volatile bool isPrefetched;
   double value;
+  bool hasNewSamples;                           // Set if last update got samples not processed before
+  uint32_t envelopeSequence;
   SignalProcessor processor;
+  EnvelopeStage* envelopeStage;
 };
 
+// List lock is only held while adding, removing or picking inputs, never during (possibly blocking) device readings
+static Input acquiredInputsList[ ACQUIRED_INPUTS_MAX_NUMBER ];
+static size_t acquiredInputsNumber = 0;
+static ThreadLock acquisitionLock = THREAD_INVALID_HANDLE;
+static ThreadLock readingLock = THREAD_INVALID_HANDLE;               // Held by acquisition thread during each reading (taken along with list lock)
+static Thread acquisitionThread = THREAD_INVALID_HANDLE;
+static volatile bool isAcquiring = false;
+
+static void SetupBiquadFilter( BiquadFilter*, double, bool );
+static EnvelopeStage* CreateEnvelopeStage( DataHandle );
+static bool StartAcquisition( Input );
+static void StopAcquisition( Input );
+static void* AsyncAcquisition( void* );
+
 
 Input Input_Init( DataHandle configuration )
 {
@@ -50,18 +101,25 @@ Input Input_Init( DataHandle configuration )
   
   //DEBUG_PRINT( "input configuration found on data handle %p", configuration );
   
-  Input newInput = (Input) malloc( sizeof(InputData) );
-  memset( newInput, 0, sizeof(InputData) ); 
+  Input newInput = (Input) Arena_Calloc( 1, sizeof(InputData) );
+  if( newInput == NULL ) return NULL;
   
   newInput->deviceID = SIGNAL_IO_DEVICE_INVALID_ID;
   
   bool loadSuccess;
   char filePath[ DATA_IO_MAX_PATH_LENGTH ];
-  sprintf( filePath, KEY_MODULES "/" KEY_SIGNAL_IO "/%s", DataIO_GetStringValue( configuration, "", KEY_INTERFACE "." KEY_TYPE ) );
+  const char* typeName = DataIO_GetStringValue( configuration, "", KEY_INTERFACE "." KEY_TYPE );
+  sprintf( filePath, KEY_MODULES "/" KEY_SIGNAL_IO "/%s", typeName );
   //DEBUG_PRINT( "trying to read signal IO module %s", filePath );
-  LOAD_MODULE_IMPLEMENTATION( SIGNAL_IO_INTERFACE, filePath, newInput, &loadSuccess );
+  LOAD_SIGNAL_IO_PLUGIN( typeName, filePath, newInput, &loadSuccess );
   if( loadSuccess )
   {
+    // Asynchronous extension is optional
+    bool isAsync = false;
+    LOAD_SIGNAL_IO_ASYNC_PLUGIN( typeName, filePath, newInput, &isAsync );
+    if( !isAsync ) newInput->ReadAsync = NULL;
+    DEBUG_PRINT( "%s input reading", isAsync ? "asynchronous" : "synchronous" );
+
     //PRINT_PLUGIN_FUNCTIONS( SIGNAL_IO_INTERFACE, newInput );
     newInput->deviceID = newInput->InitDevice( DataIO_GetStringValue( configuration, "", KEY_INTERFACE "." KEY_CONFIG ) );
     if( newInput->deviceID != SIGNAL_IO_DEVICE_INVALID_ID )
@@ -70,7 +128,7 @@ Input Input_Init( DataHandle configuration )
       loadSuccess = newInput->CheckInputChannel( newInput->deviceID, newInput->channel );
       DEBUG_PRINT( "new device ID: %ld %p", newInput->deviceID, newInput->deviceID );
       size_t maxInputSamplesNumber = newInput->GetMaxInputSamplesNumber( newInput->deviceID );
-      newInput->buffer = (double*) calloc( maxInputSamplesNumber, sizeof(double) );
+      newInput->buffer = (double*) Arena_Calloc( maxInputSamplesNumber, sizeof(double) );
       
       uint8_t signalProcessingFlags = 0x00;
       if( DataIO_GetBooleanValue( configuration, false, KEY_SIGNAL_PROCESSING "." KEY_RECTIFIED ) ) signalProcessingFlags |= SIG_PROC_RECTIFY;
@@ -83,6 +141,14 @@ Input Input_Init( DataHandle configuration )
       SignalProcessor_SetMaxFrequency( newInput->processor, relativeMaxCutFrequency );
       
       newInput->Reset( newInput->deviceID );
+      
+      if( DataIO_HasKey( configuration, KEY_ACQUISITION ) )
+      {
+        newInput->envelopeStage = CreateEnvelopeStage( DataIO_GetSubData( configuration, KEY_ACQUISITION ) );
+        loadSuccess = ( newInput->envelopeStage != NULL ) ? StartAcquisition( newInput ) : false;
+      }
+      
+      if( newInput->buffer == NULL && maxInputSamplesNumber > 0 ) loadSuccess = false;
     }
   }
   
@@ -99,22 +165,81 @@ void Input_End( Input input )
 {
   if( input == NULL ) return;
   
+  StopAcquisition( input );
+  
   if( input->EndDevice != NULL ) input->EndDevice( input->deviceID );
   
   SignalProcessor_Discard( input->processor );
   
-  free( input->buffer );
+  Arena_Free( input->envelopeStage );
+  
+  Arena_Free( input->buffer );
 
-  free( input );
+  Arena_Free( input );
 }
 
 double Input_Update( Input input )
 {
   if( input == NULL ) return 0.0;
   
-  size_t aquiredSamplesNumber = input->Read( input->deviceID, input->channel, input->buffer );
+  // Threaded inputs only pick up latest published envelope value
+  if( input->envelopeStage != NULL )
+  {
+    double envelope;
+    uint32_t sequence;
+    do {
+      sequence = SeqLock_BeginRead( &(input->envelopeStage->envelopeLock) );
+      envelope = input->envelopeStage->envelope;
+    } while( !SeqLock_EndRead( &(input->envelopeStage->envelopeLock), sequence ) );
+    input->hasNewSamples = ( sequence != input->envelopeSequence );
+    input->envelopeSequence = sequence;
     
-  return SignalProcessor_UpdateSignal( input->processor, input->buffer, aquiredSamplesNumber );
+    return SignalProcessor_UpdateSignal( input->processor, &envelope, 1 );
+  }
+  
+  if( input->ReadAsync != NULL )
+  {
+    // Samples of the reading requested on the previous update are collected (if already available) before requesting the next one
+    size_t aquiredSamplesNumber = 0;
+    if( input->isReadPending && input->PollRead( input->deviceID, input->channel, input->buffer, &aquiredSamplesNumber ) ) input->isReadPending = false;
+    if( !(input->isReadPending) ) input->isReadPending = input->ReadAsync( input->deviceID, input->channel );
+    input->hasNewSamples = ( aquiredSamplesNumber > 0 );
+    // Last value is kept while samples are not available, and synchronous reading is used only if requests are refused
+    if( aquiredSamplesNumber > 0 ) input->value = SignalProcessor_UpdateSignal( input->processor, input->buffer, aquiredSamplesNumber );
+    if( input->isReadPending || aquiredSamplesNumber > 0 ) return input->value;
+  }
+  
+  size_t aquiredSamplesNumber;
+  if( input->isPrefetched )
+  {
+    aquiredSamplesNumber = input->prefetchedSamplesNumber;
+    input->isPrefetched = false;
+  }
+  else aquiredSamplesNumber = CALL_SIGNAL_IO_FUNCTION( input, Read, input->deviceID, input->channel, input->buffer );
+  input->hasNewSamples = ( aquiredSamplesNumber > 0 );
+    
+  input->value = SignalProcessor_UpdateSignal( input->processor, input->buffer, aquiredSamplesNumber );
+  
+  return input->value;
+}
+
+bool Input_HasNewSamples( Input input )
+{
+  if( input == NULL ) return false;
+  
+  return input->hasNewSamples;
+}
+
+void Input_Prefetch( Input input )
+{
+  if( input == NULL ) return;
+  
+  // Threaded and asynchronous inputs already don't block control passes
+  if( input->envelopeStage != NULL || input->ReadAsync != NULL ) return;
+  
+  // Samples not processed yet are replaced by newer ones
+  input->prefetchedSamplesNumber = CALL_SIGNAL_IO_FUNCTION( input, Read, input->deviceID, input->channel, input->buffer );
+  input->isPrefetched = true;
 }
   
 bool Input_HasError( Input input )
@@ -138,4 +263,155 @@ void Input_SetState( Input input, enum SigProcState newProcessingState )
   
   SignalProcessor_SetState( input->processor, newProcessingState );
 }
- 
+
+
+/////////////////////////////////////////////////////////////////////////////////
+/////                        ASYNCHRONOUS ACQUISITION                       /////
+/////////////////////////////////////////////////////////////////////////////////
+
+static void SetupBiquadFilter( BiquadFilter* filter, double relativeFrequency, bool isHighPass )
+{
+  memset( filter, 0, sizeof(BiquadFilter) );
+  
+  // Negative or invalid frequencies give a pass-through filter
+  if( relativeFrequency <= 0.0 || relativeFrequency >= 0.5 )
+  {
+    filter->b0 = 1.0;
+    return;
+  }
+  
+  // Bilinear transform of Butterworth (Q = 1/sqrt(2)) prototype
+  double k = tan( M_PI * relativeFrequency );
+  double normalizer = 1.0 / ( 1.0 + sqrt( 2.0 ) * k + k * k );
+  double b0 = isHighPass ? normalizer : k * k * normalizer;
+  filter->b0 = (Scalar) b0;
+  filter->b1 = (Scalar) ( isHighPass ? -2.0 * b0 : 2.0 * b0 );
+  filter->b2 = (Scalar) b0;
+  filter->a1 = (Scalar) ( 2.0 * ( k * k - 1.0 ) * normalizer );
+  filter->a2 = (Scalar) ( ( 1.0 - sqrt( 2.0 ) * k + k * k ) * normalizer );
+}
+
+static inline Scalar UpdateBiquadFilter( BiquadFilter* filter, Scalar input )
+{
+  // Transposed direct form II
+  Scalar output = filter->b0 * input + filter->z1;
+  filter->z1 = filter->b1 * input - filter->a1 * output + filter->z2;
+  filter->z2 = filter->b2 * input - filter->a2 * output;
+  
+  return output;
+}
+
+static EnvelopeStage* CreateEnvelopeStage( DataHandle configuration )
+{
+  EnvelopeStage* newStage = (EnvelopeStage*) Arena_Calloc( 1, sizeof(EnvelopeStage) );
+  if( newStage == NULL ) return NULL;
+  
+  SetupBiquadFilter( &(newStage->highPassFilter), DataIO_GetNumericValue( configuration, -1.0, KEY_MIN_FREQUENCY ), true );
+  SetupBiquadFilter( &(newStage->lowPassFilter), DataIO_GetNumericValue( configuration, -1.0, KEY_MAX_FREQUENCY ), false );
+  SetupBiquadFilter( &(newStage->envelopeFilter), DataIO_GetNumericValue( configuration, -1.0, KEY_ENVELOPE_FREQUENCY ), false );
+  newStage->decimationFactor = (size_t) DataIO_GetNumericValue( configuration, 1, KEY_DECIMATION );
+  if( newStage->decimationFactor == 0 ) newStage->decimationFactor = 1;
+  
+  return newStage;
+}
+
+static void ProcessSamples( EnvelopeStage* stage, const double* samplesList, size_t samplesNumber )
+{
+  for( size_t sampleIndex = 0; sampleIndex < samplesNumber; sampleIndex++ )
+  {
+    Scalar bandSample = UpdateBiquadFilter( &(stage->highPassFilter), (Scalar) samplesList[ sampleIndex ] );
+    bandSample = UpdateBiquadFilter( &(stage->lowPassFilter), bandSample );
+    Scalar envelope = UpdateBiquadFilter( &(stage->envelopeFilter), SCALAR_ABS( bandSample ) );
+    
+    if( ++(stage->decimationCount) >= stage->decimationFactor )
+    {
+      SeqLock_BeginWrite( &(stage->envelopeLock) );
+      stage->envelope = envelope;
+      SeqLock_EndWrite( &(stage->envelopeLock) );
+      stage->decimationCount = 0;
+    }
+  }
+}
+
+static bool StartAcquisition( Input input )
+{
+  if( acquisitionLock == THREAD_INVALID_HANDLE ) acquisitionLock = ThreadLock_Create();
+  if( readingLock == THREAD_INVALID_HANDLE ) readingLock = ThreadLock_Create();
+  
+  ThreadLock_Aquire( acquisitionLock );
+  bool isAdded = ( acquiredInputsNumber < ACQUIRED_INPUTS_MAX_NUMBER );
+  if( isAdded ) acquiredInputsList[ acquiredInputsNumber++ ] = input;
+  ThreadLock_Release( acquisitionLock );
+  
+  if( !isAdded )
+  {
+    DEBUG_PRINT( "input %p rejected: acquisition list full (%d inputs)", input, ACQUIRED_INPUTS_MAX_NUMBER );
+    return false;
+  }
+  
+  if( !isAcquiring )
+  {
+    isAcquiring = true;
+    acquisitionThread = Thread_Start( AsyncAcquisition, NULL, THREAD_JOINABLE );
+    if( acquisitionThread == THREAD_INVALID_HANDLE ) isAcquiring = false;
+  }
+  
+  return isAcquiring;
+}
+
+static void StopAcquisition( Input input )
+{
+  if( input->envelopeStage == NULL || acquisitionLock == THREAD_INVALID_HANDLE ) return;
+  
+  ThreadLock_Aquire( acquisitionLock );
+  for( size_t inputIndex = 0; inputIndex < acquiredInputsNumber; inputIndex++ )
+  {
+    if( acquiredInputsList[ inputIndex ] == input ) acquiredInputsList[ inputIndex-- ] = acquiredInputsList[ --acquiredInputsNumber ];
+  }
+  bool isStopping = ( acquiredInputsNumber == 0 );
+  ThreadLock_Release( acquisitionLock );
+  
+  // Removed input is not picked again, so only a reading already in progress has to finish
+  ThreadLock_Aquire( readingLock );
+  ThreadLock_Release( readingLock );
+  
+  if( isStopping && isAcquiring )
+  {
+    isAcquiring = false;
+    Thread_WaitExit( acquisitionThread, 5000 );
+    acquisitionThread = THREAD_INVALID_HANDLE;
+  }
+}
+
+static void* AsyncAcquisition( void* data )
+{
+  DEBUG_PRINT( "starting inputs acquisition on thread %lx", Thread_GetID() );
+  
+  size_t inputIndex = 0;
+  size_t readSamplesNumber = 0;
+  while( isAcquiring )
+  {
+    ThreadLock_Aquire( acquisitionLock );
+    size_t inputsNumber = acquiredInputsNumber;
+    if( inputIndex >= inputsNumber ) inputIndex = 0;
+    Input input = ( inputIndex < inputsNumber ) ? acquiredInputsList[ inputIndex ] : NULL;
+    if( input != NULL ) ThreadLock_Aquire( readingLock );
+    ThreadLock_Release( acquisitionLock );
+    
+    if( input != NULL )
+    {
+      size_t samplesNumber = input->Read( input->deviceID, input->channel, input->buffer );
+      ProcessSamples( input->envelopeStage, input->buffer, samplesNumber );
+      readSamplesNumber += samplesNumber;
+      ThreadLock_Release( readingLock );
+    }
+    
+    // Avoid busy looping on non-blocking devices with no new data, after each round over all inputs 
+    // (real time sleep, as virtual time is only moved by control passes)
+    if( ++inputIndex < inputsNumber ) continue;
+    if( readSamplesNumber == 0 ) Time_Delay( ACQUISITION_IDLE_INTERVAL_MS );
+    readSamplesNumber = 0;
+  }
+  
+  return NULL;
+}
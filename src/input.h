@@ -53,6 +53,15 @@ void Input_End( Input input );
 /// @return current value of processed signal (0.0 on erros)
 double Input_Update( Input input );
 
+/// @brief Checks if last update of given input processed newly acquired samples (instead of keeping its previous value)
+/// @param[in] input reference to input
+/// @return true if new samples were processed, false otherwise
+bool Input_HasNewSamples( Input input );
+
+/// @brief Reads raw samples of given input ahead of time (e.g. from another thread), to be processed on its next update instead of a new device reading
+/// @param[in] input reference to input (no effect for inputs with their own acquisition thread or asynchronous reading)
+void Input_Prefetch( Input input );
+
 /// @brief Calls underlying signal reading implementation (plugin) to check for errors on given input              
 /// @param[in] input reference to input
 /// @return true on detected error, false otherwise
@@ -33,6 +33,7 @@
 #include "debug/data_logging.h"
 
 #include "system.h"
+#include "clock.h"
 
 const unsigned long UPDATE_INTERVAL_MS = 5;
 
@@ -71,7 +72,8 @@ int main( const int argc, const char* argv[] )
     {
       System_Update();
       
-      nanosleep( &UPDATE_TIMESPEC, NULL ); // Sleep to give the desired loop rate.
+      // Simulated time runs as fast as possible
+      if( Clock_GetSource() != CLOCK_SOURCE_SIMULATED ) nanosleep( &UPDATE_TIMESPEC, NULL ); // Sleep to give the desired loop rate.
     }
   }
   
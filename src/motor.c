@@ -24,19 +24,23 @@
 
 #include "input.h"
 #include "output.h"
+#include "clock.h"
+#include "arena.h"
 #include "tinyexpr/tinyexpr.h"
 
 #include "data_io/interface/data_io.h"
 #include "signal_io/signal_io.h"
 #include "debug/data_logging.h"
-#include "timing/timing.h"
       
 #include "config_keys.h" 
 
+#include "compiled_config.h"
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stddef.h>
 #include <string.h>
+#include <math.h>
       
 const char* SETPOINT_VARIABLE_NAME = "set";
 const char* REFERENCE_VARIABLE_NAME = "ref";
@@ -48,7 +52,12 @@ struct _MotorData
   double setpoint, offset;
   te_variable inputVariables[ 2 ];
   te_expr* transformFunction;
+  CompiledMotorTransform CompiledTransform;
   bool isOffsetting;
+  double writeDeadband, refreshInterval;
+  double lastOutputValue, lastWriteTime;
+  bool isWriteFiltered, isWritten;
+  size_t writesCount, suppressedWritesCount;
   Log log;
 };
 
@@ -61,8 +70,12 @@ Motor Motor_Init( const char* configName )
   DataHandle configuration = DataIO_LoadStorageData( filePath );
   if( configuration == NULL ) return NULL;
   
-  Motor newMotor = (Motor) malloc( sizeof(MotorData) );
-  memset( newMotor, 0, sizeof(MotorData) );
+  Motor newMotor = (Motor) Arena_Calloc( 1, sizeof(MotorData) );
+  if( newMotor == NULL )
+  {
+    DataIO_UnloadData( configuration );
+    return NULL;
+  }
 
   newMotor->output = Output_Init( configuration );
   
@@ -80,6 +93,14 @@ Motor Motor_Init( const char* configName )
   newMotor->transformFunction = te_compile( transformExpression, newMotor->inputVariables, 2, &expressionError ); 
   if( expressionError > 0 ) loadSuccess = false;
   DEBUG_PRINT( "transform function: out= %s (error: %d)", transformExpression, expressionError );
+  newMotor->writeDeadband = DataIO_GetNumericValue( configuration, 0.0, KEY_WRITE "." KEY_DEADBAND );
+  newMotor->refreshInterval = DataIO_GetNumericValue( configuration, 0.0, KEY_WRITE "." KEY_REFRESH_INTERVAL );
+  newMotor->isWriteFiltered = ( newMotor->writeDeadband > 0.0 || newMotor->refreshInterval > 0.0 );
+#ifdef COMPILED_CONFIG
+  const CompiledMotor* compiledMotor = CompiledConfig_GetMotor( configName );
+  if( compiledMotor != NULL && strcmp( compiledMotor->expression, transformExpression ) == 0 ) newMotor->CompiledTransform = compiledMotor->Transform;
+  else DEBUG_PRINT( "no up-to-date compiled transform for motor %s", configName );
+#endif
   if( DataIO_HasKey( configuration, KEY_LOG ) )
     newMotor->log = Log_Init( DataIO_GetBooleanValue( configuration, false, KEY_LOG "." KEY_FILE ) ? configName : "", 
                               (size_t) DataIO_GetNumericValue( configuration, 3, KEY_LOG "." KEY_PRECISION ) );
@@ -99,6 +120,8 @@ void Motor_End( Motor motor )
 {
   if( motor == NULL ) return;
   
+  if( motor->isWriteFiltered ) DEBUG_PRINT( "motor %p: %lu outputs written, %lu suppressed", motor, motor->writesCount, motor->suppressedWritesCount );
+  
   Output_End( motor->output );
   
   Input_End( motor->reference );
@@ -107,7 +130,7 @@ void Motor_End( Motor motor )
   
   Log_End( motor->log );
   
-  free( motor );
+  Arena_Free( motor );
 }
 
 bool Motor_Enable( Motor motor )
@@ -115,6 +138,8 @@ bool Motor_Enable( Motor motor )
   if( motor == NULL ) return false;
 
   Output_Reset( motor->output );
+  
+  motor->isWritten = false;
 
   bool enabled = Output_Enable( motor->output );
   
@@ -151,6 +176,7 @@ void Motor_SetOperation( Motor motor )
   DEBUG_PRINT( "setting motor %p reference state (%g) to operation", motor->offset, motor );
   Input_SetState( motor->reference, SIG_PROC_STATE_MEASUREMENT );
   DEBUG_PRINT( "setting motor %p to initial position", motor );
+  motor->isWritten = false;
   Motor_WriteControl( motor, 0.0 );
 }
 
@@ -159,10 +185,42 @@ void Motor_WriteControl( Motor motor, double setpoint )
   if( motor == NULL ) return;
   motor->setpoint = setpoint;
   //DEBUG_PRINT( "evaluating transform function %p (set=%g, ref=%g)", motor->transformFunction, *((double*) motor->inputVariables[ 0 ].address), *((double*) motor->inputVariables[ 1 ].address) );
-  double outputValue = te_eval( motor->transformFunction );
+  double outputValue = ( motor->CompiledTransform != NULL ) ? motor->CompiledTransform( motor->setpoint, motor->offset ) : te_eval( motor->transformFunction );
   //DEBUG_PRINT( "logging motor data to %p", motor->log );
-  //Log_EnterNewLine( motor->log, Time_GetExecSeconds() );
+  //Log_EnterNewLine( motor->log, Clock_GetExecSeconds() );
   //Log_RegisterValues( motor->log, 3, motor->setpoint, motor->offset, output );
   //DEBUG_PRINT( "writing %g,%g -> %g to output %p", motor->setpoint, motor->offset, outputValue, motor->output );
-  if( ! motor->isOffsetting ) Output_Update( motor->output, outputValue );
+  if( motor->isOffsetting ) return;
+  
+  // Values inside deadband are only written again after the refresh interval (if any)
+  if( motor->isWriteFiltered )
+  {
+    double execTime = Clock_GetExecSeconds();
+    bool isRefreshTime = ( motor->refreshInterval > 0.0 && execTime - motor->lastWriteTime >= motor->refreshInterval );
+    if( motor->isWritten && !isRefreshTime && fabs( outputValue - motor->lastOutputValue ) <= motor->writeDeadband )
+    {
+      motor->suppressedWritesCount++;
+      return;
+    }
+    motor->lastOutputValue = outputValue;
+    motor->lastWriteTime = execTime;
+    motor->isWritten = true;
+  }
+  
+  motor->writesCount++;
+  Output_Update( motor->output, outputValue );
+}
+
+bool Motor_AddToBatch( Motor motor, OutputBatch batch )
+{
+  if( motor == NULL ) return false;
+  
+  return OutputBatch_AddOutput( batch, motor->output );
+}
+
+size_t Motor_GetSuppressedWritesNumber( Motor motor )
+{
+  if( motor == NULL ) return 0;
+  
+  return motor->suppressedWritesCount;
 }
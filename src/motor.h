@@ -44,6 +44,10 @@
 ///   },
 ///   "output": "set",                // [o] String with math expression for conversion from control setpoint ("set") and offset reference ("ref") to output
 ///                                   //     Possible operations are the ones supported by TinyExpr library: https://codeplea.com/tinyexpr
+///   "write": {                      // [o] Suppression of redundant output writes (e.g. for holds over shared buses), disabled with all values set to 0
+///     "deadband": 0.0,                // [o] Minimum change of output value (from the last written one) for it to be written again
+///     "refresh_interval": 0.0         // [o] Maximum time (in seconds) between writes, even with output value inside deadband (0 for no refreshing)
+///   },
 ///   "log": {                        // [o] Set logging of setpoint, offset and output numeric data over time
 ///     "to_file": false,               // [o] Save data logging to <log_dir>/[<user_name>-]<motor_name>-<time_stamp>.log, to log file 
 ///                                     //     Default value will set terminal logging
@@ -56,7 +60,10 @@
 #define MOTOR_H
 
 
+#include "output.h"
+
 #include <stdbool.h>
+#include <stddef.h>
 
 typedef struct _MotorData MotorData;       ///< Single motor internal data structure    
 typedef MotorData* Motor;                  ///< Opaque reference to motor internal data structure
@@ -93,5 +100,16 @@ void Motor_SetOperation( Motor motor );
 /// @param[in] setpoint value to be written/generated
 void Motor_WriteControl( Motor motor, double setpoint );
 
+/// @brief Adds output of given motor to outputs batch, so that its control values may be written along with other outputs of the same device (see output.h)
+/// @param[in] motor reference to motor
+/// @param[in] batch reference to outputs batch
+/// @return true if motor output was added, false otherwise
+bool Motor_AddToBatch( Motor motor, OutputBatch batch );
+
+/// @brief Gets number of output writes skipped by given motor, for values inside its write deadband (see @ref motor_config)
+/// @param[in] motor reference to motor
+/// @return number of suppressed writes since motor initialization
+size_t Motor_GetSuppressedWritesNumber( Motor motor );
+
 
 #endif  // MOTOR_H
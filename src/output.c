@@ -23,6 +23,10 @@
 #include "output.h"
 
 #include "signal_io/signal_io.h"
+#include "static_plugins.h"
+#include "signal_io_extensions.h"
+#include "arena.h"
+#include "clock.h"
 #include "debug/data_logging.h"
       
 #include "config_keys.h" 
@@ -35,8 +39,29 @@
 struct _OutputData
 {
   DECLARE_MODULE_INTERFACE_REF( SIGNAL_IO_INTERFACE );
+  DECLARE_MODULE_INTERFACE_REF( SIGNAL_IO_ASYNC_INTERFACE );
+  DECLARE_MODULE_INTERFACE_REF( SIGNAL_IO_BATCH_INTERFACE );
   long int deviceID;
   unsigned int channel;
+  OutputBatch batch;
+  size_t deviceIndex, pendingIndex;
+  bool isPending;
+};
+
+struct _OutputBatchData
+{
+  Output* outputsList;
+  size_t outputsNumber, maxOutputsNumber;
+  Output* devicesList;                          // First added output of each device, providing its WriteBatch function and ID
+  size_t devicesNumber;
+  Output* pendingOutputsList;                   // Outputs written since batch beginning, in writing order
+  double* pendingValuesList;
+  size_t pendingNumber;
+  size_t* deviceOffsetsList;                    // Pending values grouped by device on commit: channels, values and outputs of each one are contiguous
+  unsigned int* channelsList;
+  double* valuesList;
+  Output* channelOutputsList;
+  volatile bool isDeferring;
 };
 
 
@@ -44,18 +69,25 @@ Output Output_Init( DataHandle configuration )
 {
   if( configuration == NULL ) return NULL;
   
-  Output newOutput = (Output) malloc( sizeof(OutputData) );
-  memset( newOutput, 0, sizeof(OutputData) );
+  Output newOutput = (Output) Arena_Calloc( 1, sizeof(OutputData) );
+  if( newOutput == NULL ) return NULL;
 
   newOutput->deviceID = SIGNAL_IO_DEVICE_INVALID_ID;
   
   bool loadSuccess = true;
   char filePath[ DATA_IO_MAX_PATH_LENGTH ];
-  sprintf( filePath, KEY_MODULES "/" KEY_SIGNAL_IO "/%s", DataIO_GetStringValue( configuration, "", KEY_INTERFACE "." KEY_TYPE ) );
+  const char* typeName = DataIO_GetStringValue( configuration, "", KEY_INTERFACE "." KEY_TYPE );
+  sprintf( filePath, KEY_MODULES "/" KEY_SIGNAL_IO "/%s", typeName );
   //DEBUG_PRINT( "trying to read signal IO module %s", filePath );
-  LOAD_MODULE_IMPLEMENTATION( SIGNAL_IO_INTERFACE, filePath, newOutput, &loadSuccess );
+  LOAD_SIGNAL_IO_PLUGIN( typeName, filePath, newOutput, &loadSuccess );
   if( loadSuccess )
   {
+    // Asynchronous and multi-channel extensions are optional
+    bool isAsync = false, isBatchable = false;
+    LOAD_SIGNAL_IO_ASYNC_PLUGIN( typeName, filePath, newOutput, &isAsync );
+    LOAD_SIGNAL_IO_BATCH_PLUGIN( typeName, filePath, newOutput, &isBatchable );
+    if( !isAsync ) newOutput->WriteAsync = NULL;
+    if( !isBatchable ) newOutput->WriteBatch = NULL;
     //PRINT_PLUGIN_FUNCTIONS( SIGNAL_IO_INTERFACE, newOutput );
     newOutput->deviceID = newOutput->InitDevice( DataIO_GetStringValue( configuration, "", KEY_INTERFACE "." KEY_CONFIG ) );
     if( newOutput->deviceID != SIGNAL_IO_DEVICE_INVALID_ID ) 
@@ -82,7 +114,7 @@ void Output_End( Output output )
   
   if( output->EndDevice != NULL ) output->EndDevice( output->deviceID );
   
-  free( output );
+  Arena_Free( output );
 }
 
 bool Output_Enable( Output output )
@@ -113,9 +145,160 @@ bool Output_HasError( Output output )
   return output->HasError( output->deviceID );
 }
 
+static void WriteValue( Output output, double value )
+{
+  if( output->WriteAsync != NULL && output->WriteAsync( output->deviceID, output->channel, value ) ) return;
+  
+  (void) CALL_SIGNAL_IO_FUNCTION( output, Write, output->deviceID, output->channel, value );
+}
+
 void Output_Update( Output output, double value )
 {
   if( output == NULL ) return;
   //DEBUG_PRINT( "evaluating transform function %p", output->transformFunction );
-  output->Write( output->deviceID, output->channel, value );
+  OutputBatch batch = output->batch;
+  if( batch == NULL || !batch->isDeferring ) 
+  {
+    WriteValue( output, value );
+    return;
+  }
+  
+  // Repeated writes on the same batch only replace the stored value
+  if( !output->isPending )
+  {
+    output->pendingIndex = batch->pendingNumber++;
+    batch->pendingOutputsList[ output->pendingIndex ] = output;
+    output->isPending = true;
+  }
+  batch->pendingValuesList[ output->pendingIndex ] = value;
+}
+
+OutputBatch OutputBatch_Init( size_t maxOutputsNumber )
+{
+  OutputBatch newBatch = (OutputBatch) Arena_Calloc( 1, sizeof(OutputBatchData) );
+  if( newBatch == NULL ) return NULL;
+  
+  newBatch->maxOutputsNumber = maxOutputsNumber;
+  newBatch->outputsList = (Output*) Arena_Calloc( maxOutputsNumber, sizeof(Output) );
+  newBatch->devicesList = (Output*) Arena_Calloc( maxOutputsNumber, sizeof(Output) );
+  newBatch->pendingOutputsList = (Output*) Arena_Calloc( maxOutputsNumber, sizeof(Output) );
+  newBatch->pendingValuesList = (double*) Arena_Calloc( maxOutputsNumber, sizeof(double) );
+  newBatch->deviceOffsetsList = (size_t*) Arena_Calloc( maxOutputsNumber + 1, sizeof(size_t) );
+  newBatch->channelsList = (unsigned int*) Arena_Calloc( maxOutputsNumber, sizeof(unsigned int) );
+  newBatch->valuesList = (double*) Arena_Calloc( maxOutputsNumber, sizeof(double) );
+  newBatch->channelOutputsList = (Output*) Arena_Calloc( maxOutputsNumber, sizeof(Output) );
+  
+  if( maxOutputsNumber > 0 && ( newBatch->outputsList == NULL || newBatch->devicesList == NULL || newBatch->pendingOutputsList == NULL 
+                                || newBatch->pendingValuesList == NULL || newBatch->deviceOffsetsList == NULL || newBatch->channelsList == NULL 
+                                || newBatch->valuesList == NULL || newBatch->channelOutputsList == NULL ) )
+  {
+    OutputBatch_End( newBatch );
+    return NULL;
+  }
+  
+  return newBatch;
+}
+
+void OutputBatch_End( OutputBatch batch )
+{
+  if( batch == NULL ) return;
+  
+  for( size_t outputIndex = 0; outputIndex < batch->outputsNumber; outputIndex++ )
+    batch->outputsList[ outputIndex ]->batch = NULL;
+  
+  Arena_Free( batch->outputsList );
+  Arena_Free( batch->devicesList );
+  Arena_Free( batch->pendingOutputsList );
+  Arena_Free( batch->pendingValuesList );
+  Arena_Free( batch->deviceOffsetsList );
+  Arena_Free( batch->channelsList );
+  Arena_Free( batch->valuesList );
+  Arena_Free( batch->channelOutputsList );
+  
+  Arena_Free( batch );
+}
+
+bool OutputBatch_AddOutput( OutputBatch batch, Output output )
+{
+  if( batch == NULL || output == NULL ) return false;
+  
+  if( output->batch != NULL ) return false;
+  
+  if( output->WriteBatch == NULL )
+  {
+    DEBUG_PRINT( "output %u of interface %d not batched (no multi-channel writes): written immediately", output->channel, output->deviceID );
+    return false;
+  }
+  
+  if( batch->outputsNumber >= batch->maxOutputsNumber ) return false;
+  
+  // Outputs are grouped by device, identified by both plugin and device ID
+  size_t deviceIndex = 0;
+  for( ; deviceIndex < batch->devicesNumber; deviceIndex++ )
+  {
+    Output deviceOutput = batch->devicesList[ deviceIndex ];
+    if( deviceOutput->WriteBatch == output->WriteBatch && deviceOutput->deviceID == output->deviceID ) break;
+  }
+  if( deviceIndex == batch->devicesNumber ) batch->devicesList[ batch->devicesNumber++ ] = output;
+  
+  output->batch = batch;
+  output->deviceIndex = deviceIndex;
+  output->isPending = false;
+  batch->outputsList[ batch->outputsNumber++ ] = output;
+  DEBUG_PRINT( "output %u of interface %d added to batch (device %lu)", output->channel, output->deviceID, deviceIndex );
+  
+  return true;
+}
+
+void OutputBatch_Begin( OutputBatch batch )
+{
+  if( batch == NULL ) return;
+  
+  batch->isDeferring = true;
+}
+
+void OutputBatch_Commit( OutputBatch batch )
+{
+  if( batch == NULL ) return;
+  
+  batch->isDeferring = false;
+  
+  // All devices get the same commit time, taken once per batch
+  double commitTime = Clock_GetExecSeconds();
+  
+  // Pending values are grouped by device in a single pass, after counting channels of each device (offsetsList[ d ] ends as the end of device d slice)
+  size_t* offsetsList = batch->deviceOffsetsList;
+  memset( offsetsList, 0, ( batch->devicesNumber + 1 ) * sizeof(size_t) );
+  for( size_t pendingIndex = 0; pendingIndex < batch->pendingNumber; pendingIndex++ )
+    offsetsList[ batch->pendingOutputsList[ pendingIndex ]->deviceIndex + 1 ]++;
+  for( size_t deviceIndex = 0; deviceIndex < batch->devicesNumber; deviceIndex++ )
+    offsetsList[ deviceIndex + 1 ] += offsetsList[ deviceIndex ];
+  for( size_t pendingIndex = 0; pendingIndex < batch->pendingNumber; pendingIndex++ )
+  {
+    Output output = batch->pendingOutputsList[ pendingIndex ];
+    size_t channelIndex = offsetsList[ output->deviceIndex ]++;
+    batch->channelsList[ channelIndex ] = output->channel;
+    batch->valuesList[ channelIndex ] = batch->pendingValuesList[ pendingIndex ];
+    batch->channelOutputsList[ channelIndex ] = output;
+    output->isPending = false;
+  }
+  batch->pendingNumber = 0;
+  
+  size_t firstChannelIndex = 0;
+  for( size_t deviceIndex = 0; deviceIndex < batch->devicesNumber; deviceIndex++ )
+  {
+    size_t endChannelIndex = offsetsList[ deviceIndex ];
+    size_t channelsNumber = endChannelIndex - firstChannelIndex;
+    if( channelsNumber > 0 )
+    {
+      Output deviceOutput = batch->devicesList[ deviceIndex ];
+      if( !deviceOutput->WriteBatch( deviceOutput->deviceID, batch->channelsList + firstChannelIndex, batch->valuesList + firstChannelIndex, channelsNumber, commitTime ) )
+      {
+        // Devices refusing multi-channel writes get each value separately
+        for( size_t channelIndex = firstChannelIndex; channelIndex < endChannelIndex; channelIndex++ )
+          WriteValue( batch->channelOutputsList[ channelIndex ], batch->valuesList[ channelIndex ] );
+      }
+    }
+    firstChannelIndex = endChannelIndex;
+  }
 }
@@ -24,6 +24,9 @@
 /// @brief Generic output (signal writing/generation) functions
 ///
 /// Interface for configurable output writing (as shown in @ref motor_config)
+///
+/// Outputs may also be added to a batch, so that, between its begin and commit calls, values written to outputs of devices supporting multi-channel writes 
+/// (WriteBatch function of the signal I/O extensions) are only stored, and then written with a single call per device. Other outputs are always written immediately
 
 
 #ifndef OUTPUT_H
@@ -37,6 +40,9 @@
 typedef struct _OutputData OutputData;       ///< Single output internal data structure    
 typedef OutputData* Output;                  ///< Opaque reference to output internal data structure
 
+typedef struct _OutputBatchData OutputBatchData;       ///< Outputs batch internal data structure    
+typedef OutputBatchData* OutputBatch;                  ///< Opaque reference to outputs batch internal data structure
+
                                                               
 /// @brief Creates and initializes output data structure based on given information                                              
 /// @param[in] configuration reference to data object containing configuration parameters, as explained at @ref motor_config
@@ -70,5 +76,28 @@ void Output_Reset( Output output );
 /// @param[in] value value to be written/generated
 void Output_Update( Output output, double value );
 
+/// @brief Creates and initializes outputs batch data structure
+/// @param[in] maxOutputsNumber maximum number of outputs added to the batch
+/// @return reference/pointer to newly created outputs batch data structure
+OutputBatch OutputBatch_Init( size_t maxOutputsNumber );
+
+/// @brief Deallocates internal data of given outputs batch (added outputs are detached, but not deallocated)
+/// @param[in] batch reference to outputs batch
+void OutputBatch_End( OutputBatch batch );
+
+/// @brief Adds output to given batch, if its device supports multi-channel writes
+/// @param[in] batch reference to outputs batch
+/// @param[in] output reference to output
+/// @return true if output was added, false otherwise (output keeps being written immediately)
+bool OutputBatch_AddOutput( OutputBatch batch, Output output );
+
+/// @brief Starts deferring values written to outputs of given batch
+/// @param[in] batch reference to outputs batch
+void OutputBatch_Begin( OutputBatch batch );
+
+/// @brief Writes all values stored since batch beginning, with one call per device (or per output, for devices failing it), and stops deferring them
+/// @param[in] batch reference to outputs batch
+void OutputBatch_Commit( OutputBatch batch );
+
 
 #endif  // OUTPUT_H
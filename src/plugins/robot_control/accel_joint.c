@@ -26,7 +26,7 @@
 
 #define DOFS_NUMBER 3
 
-const char* DOF_NAMES[ DOFS_NUMBER ] = { "X", "Y", "Z" };
+static const char* DOF_NAMES[ DOFS_NUMBER ] = { "X", "Y", "Z" };
 
 DECLARE_MODULE_INTERFACE( ROBOT_CONTROL_INTERFACE );
 
@@ -20,95 +20,134 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 
-#include "robot_control_interface.h"
+/// @file anklebot.c
+/// @brief Anklebot (2 parallel linear actuators) ankle impedance controller
+///
+/// Dorsiflexion/plantarflexion (DP) and inversion/eversion (IE) angles are computed in closed form from actuator lengths, and
+/// joint velocities, accelerations and forces are mapped to axis space (and axis torques back to actuator forces) through the analytic Jacobian.
+/// Configuration string (optional): "<default_dp_stiffness>", used while no DP stiffness setpoint is given (default: "10.0")
+
+#include "robot_control/robot_control.h"
+#include "robot_control_extensions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
 
 #define DOFS_NUMBER 2
 
-const char* AXIS_NAMES[ DOFS_NUMBER ] = { "DP", "IE" };
-const char* JOINT_NAMES[ DOFS_NUMBER ] = { "RIGHT", "LEFT" };
+enum { DP, IE };
+enum { RIGHT, LEFT };
+
+static const char* AXIS_NAMES[ DOFS_NUMBER ] = { "DP", "IE" };
+static const char* JOINT_NAMES[ DOFS_NUMBER ] = { "RIGHT", "LEFT" };
 
-DECLARE_MODULE_INTERFACE( ROBOT_CONTROL_INTERFACE )
+static const double BALL_LENGTH = 0.14;
+static const double BALL_BALL_WIDTH = 0.19;
+static const double SHIN_LENGTH = 0.42;
+static const double ACTUATOR_LENGTH = 0.443;
 
-RobotController InitController( const char* configurationString )
+// Lower bound for DP angle cosine, avoiding the (unreachable) singularity at +-90 degrees
+static const double MIN_DP_COSINE = 1e-3;
+
+typedef struct _ControlData
 {
-  return NULL;
+  double defaultDPStiffness;
 }
+ControlData;
 
-void EndController( RobotController controller )
-{
 
-}
+DECLARE_MODULE_INTERFACE( ROBOT_CONTROL_CONTEXT_INTERFACE );
 
-size_t GetJointsNumber( RobotController controller )
-{
-  return DOFS_NUMBER;
-}
 
-const char** GetJointNamesList( RobotController controller )
+ControllerContext CreateController( const char* configurationString )
 {
-  return (const char**) JOINT_NAMES;
+  ControlData* controlData = (ControlData*) calloc( 1, sizeof(ControlData) );
+  if( controlData == NULL ) return NULL;
+  
+  controlData->defaultDPStiffness = 10.0;
+  if( configurationString != NULL && *configurationString != '\0' ) controlData->defaultDPStiffness = strtod( configurationString, NULL );
+  
+  return controlData;
 }
 
-size_t GetAxesNumber( RobotController controller )
-{
-  return DOFS_NUMBER;
+void DiscardController( ControllerContext context ) 
+{ 
+  free( context ); 
 }
 
-const char** GetAxisNamesList( RobotController controller )
-{
-  return (const char**) AXIS_NAMES;
-}
+size_t GetControllerJointsNumber( ControllerContext context ) { return DOFS_NUMBER; }
+
+const char** GetControllerJointNamesList( ControllerContext context ) { return JOINT_NAMES; }
+
+size_t GetControllerAxesNumber( ControllerContext context ) { return DOFS_NUMBER; }
 
-void SetControlState( RobotController controller, enum RobotState controlState )
+const char** GetControllerAxisNamesList( ControllerContext context ) { return AXIS_NAMES; }
+
+size_t GetControllerExtraInputsNumber( ControllerContext context ) { return 0; }
+      
+void SetControllerExtraInputsList( ControllerContext context, double* inputsList ) { return; }
+
+size_t GetControllerExtraOutputsNumber( ControllerContext context ) { return 0; }
+         
+void GetControllerExtraOutputsList( ControllerContext context, double* outputsList ) { return; }
+
+void SetControllerState( ControllerContext context, enum ControlState newControlState )
 {
-  fprintf( stderr, "Setting robot control phase: %x\n", controlState );
+  fprintf( stderr, "Setting robot control phase: %x\n", newControlState );
 }
 
-void RunControlStep( RobotController controller, RobotVariables** jointMeasuresTable, RobotVariables** axisMeasuresTable, RobotVariables** jointSetpointsTable, RobotVariables** axisSetpointsTable, double timeDelta )
+void RunControllerStep( ControllerContext context, DoFVariables** jointMeasuresList, DoFVariables** axisMeasuresList, DoFVariables** jointSetpointsList, DoFVariables** axisSetpointsList, double timeDelta )
 {
-  const double BALL_LENGTH = 0.14;
-  const double BALL_BALL_WIDTH = 0.19;
-  const double SHIN_LENGTH = 0.42;
-  const double ACTUATOR_LENGTH = 0.443;
-
-  double positionMean = ( jointMeasuresTable[ 0 ]->position + jointMeasuresTable[ 1 ]->position ) / 2.0;
-  double dpSin = ( pow( BALL_LENGTH, 2 ) + pow( SHIN_LENGTH, 2 ) - pow( ACTUATOR_LENGTH - positionMean, 2 ) ) / ( 2 * BALL_LENGTH * SHIN_LENGTH );
+  ControlData* controlData = (ControlData*) context;
+  
+  // Forward kinematics: DP from mean actuator length (law of cosines), IE from actuators length difference
+  double positionMean = ( jointMeasuresList[ RIGHT ]->position + jointMeasuresList[ LEFT ]->position ) / 2.0;
+  double actuatorLength = ACTUATOR_LENGTH - positionMean;
+  double dpSin = ( BALL_LENGTH * BALL_LENGTH + SHIN_LENGTH * SHIN_LENGTH - actuatorLength * actuatorLength ) / ( 2 * BALL_LENGTH * SHIN_LENGTH );
   if( dpSin > 1.0 ) dpSin = 1.0;
   else if( dpSin < -1.0 ) dpSin = -1.0;
-  double dpPosition = asin( dpSin ); // + dpOffset; ?
-  axisMeasuresTable[ 0 ]->velocity = ( dpPosition - axisMeasuresTable[ 0 ]->position ) / timeDelta;
-  axisMeasuresTable[ 0 ]->position = dpPosition;
-
-  double positionDiff = ( jointMeasuresTable[ 0 ]->position - jointMeasuresTable[ 1 ]->position );
-  double iePosition = atan( positionDiff / BALL_BALL_WIDTH );  // + ieOffset; ?
-  axisMeasuresTable[ 1 ]->velocity = ( iePosition - axisMeasuresTable[ 1 ]->position ) / timeDelta;
-  axisMeasuresTable[ 1 ]->position = iePosition;
-
-  double rightForce = jointMeasuresTable[ 0 ]->force;
-  double leftForce = jointMeasuresTable[ 1 ]->force;
-  axisMeasuresTable[ 0 ]->force = ( leftForce + rightForce ) * BALL_LENGTH;
-  axisMeasuresTable[ 1 ]->force = ( leftForce - rightForce ) * BALL_BALL_WIDTH / 2.0;
-
-  double dpRefStiffness = 10.0;//axisSetpointsTable[ 0 ]->stiffness;
-  double dpPositionError = axisSetpointsTable[ 0 ]->position - axisMeasuresTable[ 0 ]->position;
-  double dpRefDamping = axisSetpointsTable[ 0 ]->damping;
-  double dpVelocity = axisMeasuresTable[ 0 ]->velocity;
-  double dpRefTorque = dpRefStiffness * dpPositionError - dpRefDamping * dpVelocity;
-  axisSetpointsTable[ 0 ]->force = dpRefTorque;
-
-  double ieRefStiffness = axisSetpointsTable[ 1 ]->stiffness;
-  double iePositionError = axisSetpointsTable[ 1 ]->position - axisMeasuresTable[ 1 ]->position;
-  double ieRefDamping = axisSetpointsTable[ 1 ]->damping;
-  double ieVelocity = axisMeasuresTable[ 1 ]->velocity;
-  double ieRefTorque = ieRefStiffness * iePositionError - ieRefDamping * ieVelocity;
-  axisSetpointsTable[ 1 ]->force = ieRefTorque;
-
-  // measured force = setpoint force
-  axisMeasuresTable[ 0 ]->force = axisSetpointsTable[ 0 ]->force;
-  axisMeasuresTable[ 1 ]->force = axisSetpointsTable[ 1 ]->force;
-
-  double dpRefForce = dpRefTorque / BALL_LENGTH;
-  double ieRefForce = ieRefTorque / ( BALL_BALL_WIDTH / 2.0 );
-  jointSetpointsTable[ 0 ]->force = ( -dpRefForce - ieRefForce ) / 2.0;
-  jointSetpointsTable[ 1 ]->force = ( -dpRefForce + ieRefForce ) / 2.0;
+  double dpCos = sqrt( 1.0 - dpSin * dpSin );
+  if( dpCos < MIN_DP_COSINE ) dpCos = MIN_DP_COSINE;
+  
+  double positionDiff = jointMeasuresList[ RIGHT ]->position - jointMeasuresList[ LEFT ]->position;
+  
+  axisMeasuresList[ DP ]->position = asin( dpSin );
+  axisMeasuresList[ IE ]->position = atan( positionDiff / BALL_BALL_WIDTH );
+  
+  // Analytic Jacobian J = [ dpGain dpGain ; ieGain -ieGain ]
+  double dpGain = actuatorLength / ( 2 * BALL_LENGTH * SHIN_LENGTH * dpCos );
+  double ieGain = BALL_BALL_WIDTH / ( BALL_BALL_WIDTH * BALL_BALL_WIDTH + positionDiff * positionDiff );
+  
+  // Axis velocities (and accelerations, neglecting Jacobian derivative term) from filtered joint ones: xdot = J * qdot
+  double velocitySum = jointMeasuresList[ RIGHT ]->velocity + jointMeasuresList[ LEFT ]->velocity;
+  double velocityDiff = jointMeasuresList[ RIGHT ]->velocity - jointMeasuresList[ LEFT ]->velocity;
+  axisMeasuresList[ DP ]->velocity = dpGain * velocitySum;
+  axisMeasuresList[ IE ]->velocity = ieGain * velocityDiff;
+  double accelerationSum = jointMeasuresList[ RIGHT ]->acceleration + jointMeasuresList[ LEFT ]->acceleration;
+  double accelerationDiff = jointMeasuresList[ RIGHT ]->acceleration - jointMeasuresList[ LEFT ]->acceleration;
+  axisMeasuresList[ DP ]->acceleration = dpGain * accelerationSum;
+  axisMeasuresList[ IE ]->acceleration = ieGain * accelerationDiff;
+  
+  // Axis torques from actuator forces, solving f = -J^T * tau (actuator forces sign is opposite to axis torques one)
+  double forceSum = jointMeasuresList[ RIGHT ]->force + jointMeasuresList[ LEFT ]->force;
+  double forceDiff = jointMeasuresList[ RIGHT ]->force - jointMeasuresList[ LEFT ]->force;
+  axisMeasuresList[ DP ]->force = -forceSum / ( 2 * dpGain );
+  axisMeasuresList[ IE ]->force = -forceDiff / ( 2 * ieGain );
+  
+  // Impedance control on axis space
+  for( size_t axisIndex = 0; axisIndex < DOFS_NUMBER; axisIndex++ )
+  {
+    double stiffness = axisSetpointsList[ axisIndex ]->stiffness;
+    if( axisIndex == DP && stiffness == 0.0 ) stiffness = controlData->defaultDPStiffness;
+    double positionError = axisSetpointsList[ axisIndex ]->position - axisMeasuresList[ axisIndex ]->position;
+    double velocity = axisMeasuresList[ axisIndex ]->velocity;
+    axisSetpointsList[ axisIndex ]->force = stiffness * positionError - axisSetpointsList[ axisIndex ]->damping * velocity;
+  }
+  
+  // Actuator forces from axis torques: f = -J^T * tau
+  double dpForce = dpGain * axisSetpointsList[ DP ]->force;
+  double ieForce = ieGain * axisSetpointsList[ IE ]->force;
+  jointSetpointsList[ RIGHT ]->force = -dpForce - ieForce;
+  jointSetpointsList[ LEFT ]->force = -dpForce + ieForce;
 }
@@ -19,21 +19,23 @@
 //                                                                            //
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <stdlib.h>
 #include <string.h>
 #include <math.h>
 
 #include "robot_control/robot_control.h"
+#include "robot_control_extensions.h"
 
 #include "debug/data_logging.h"
 
 #define DOFS_NUMBER 2
 #define DELAY_SETPOINTS_NUMBER 1//5
 
-const double MIN_WAVE_IMPEDANCE = 1.0;
+static const double MIN_WAVE_IMPEDANCE = 1.0;
 
-const char* DOF_NAMES[ DOFS_NUMBER ] = { "angle1", "angle2" };
+static const char* DOF_NAMES[ DOFS_NUMBER ] = { "angle1", "angle2" };
 
-static struct
+typedef struct _ControlData
 {
   double setpointsTable[ DOFS_NUMBER ][ DELAY_SETPOINTS_NUMBER ];
   double lastInputWavesList[ DOFS_NUMBER ];
@@ -43,69 +45,75 @@ static struct
   double elapsedTime;
   Log samplingLog;
 }
-controlData;
+ControlData;
 
 
-DECLARE_MODULE_INTERFACE( ROBOT_CONTROL_INTERFACE );
+DECLARE_MODULE_INTERFACE( ROBOT_CONTROL_CONTEXT_INTERFACE );
 
 
-bool InitController( const char* configurationString )
+ControllerContext CreateController( const char* configurationString )
 {
-  memset( &controlData, 0, sizeof(controlData) );
+  ControlData* controlData = (ControlData*) calloc( 1, sizeof(ControlData) );
+  if( controlData == NULL ) return NULL;
   
   Log_SetDirectory( "" );
-  controlData.samplingLog = Log_Init( "motor_sampling", 8 );
+  controlData->samplingLog = Log_Init( "motor_sampling", 8 );
   
-  controlData.elapsedTime = 0.0;
+  controlData->elapsedTime = 0.0;
   
-  controlData.state = CONTROL_PASSIVE;
+  controlData->state = CONTROL_PASSIVE;
   
-  return true;
+  return controlData;
 }
 
-void EndController()
+void DiscardController( ControllerContext context )
 {
-  Log_End( controlData.samplingLog );
+  ControlData* controlData = (ControlData*) context;
+  
+  Log_End( controlData->samplingLog );
+  free( controlData );
 }
 
-size_t GetJointsNumber()
+size_t GetControllerJointsNumber( ControllerContext context )
 {
   return DOFS_NUMBER;
 }
 
-const char** GetJointNamesList()
+const char** GetControllerJointNamesList( ControllerContext context )
 {
   return (const char**) DOF_NAMES;
 }
 
-size_t GetAxesNumber()
+size_t GetControllerAxesNumber( ControllerContext context )
 {
   return DOFS_NUMBER;
 }
 
-const char** GetAxisNamesList()
+const char** GetControllerAxisNamesList( ControllerContext context )
 {
   return (const char**) DOF_NAMES;
 }
 
-size_t GetExtraInputsNumber( void ) { return 0; }
+size_t GetControllerExtraInputsNumber( ControllerContext context ) { return 0; }
       
-void SetExtraInputsList( double* inputsList ) { }
+void SetControllerExtraInputsList( ControllerContext context, double* inputsList ) { }
 
-size_t GetExtraOutputsNumber( void ) { return 0; }
+size_t GetControllerExtraOutputsNumber( ControllerContext context ) { return 0; }
          
-void GetExtraOutputsList( double* outputsList ) { }
+void GetControllerExtraOutputsList( ControllerContext context, double* outputsList ) { }
 
-void SetControlState( enum ControlState newControlState )
+void SetControllerState( ControllerContext context, enum ControlState newControlState )
 {
+  ControlData* controlData = (ControlData*) context;
+  
   fprintf( stderr, "Setting robot control phase: %x\n", newControlState );
   
-  if( newControlState == CONTROL_PREPROCESSING ) controlData.elapsedTime = 0.0;
+  if( newControlState == CONTROL_PREPROCESSING ) controlData->elapsedTime = 0.0;
   
-  controlData.state = newControlState;
+  controlData->state = newControlState;
 }
 
-void ControlJoint( DoFVariables* ref_jointMeasures, DoFVariables* ref_axisMeasures, DoFVariables* ref_jointSetpoints, DoFVariables* ref_axisSetpoints )
+static void ControlJoint( DoFVariables* ref_jointMeasures, DoFVariables* ref_axisMeasures, DoFVariables* ref_jointSetpoints, DoFVariables* ref_axisSetpoints )
 {
   ref_axisMeasures->acceleration = ref_jointMeasures->acceleration;
   ref_axisMeasures->velocity = ref_jointMeasures->velocity;
@@ -133,8 +141,10 @@ void ControlJoint( DoFVariables* ref_jointMeasures, DoFVariables* ref_axisMeasur
   //fprintf( stderr, "position=%.5f, setpoint=%.5f, control force=%.5f\n", ref_jointMeasures->position, ref_jointSetpoints->position, ref_jointSetpoints->force );
 }
 
-void RunControlStep( DoFVariables** jointMeasuresList, DoFVariables** axisMeasuresList, DoFVariables** jointSetpointsList, DoFVariables** axisSetpointsList, double timeDelta )
+void RunControllerStep( ControllerContext context, DoFVariables** jointMeasuresList, DoFVariables** axisMeasuresList, DoFVariables** jointSetpointsList, DoFVariables** axisSetpointsList, double timeDelta )
 {
+  ControlData* controlData = (ControlData*) context;
+  
   axisSetpointsList[ 0 ]->position = 0.0;//jointMeasuresList[ 1 ]->position;
   axisSetpointsList[ 1 ]->position = 0.0;//jointMeasuresList[ 0 ]->position;
   axisSetpointsList[ 0 ]->velocity = 0.0;//jointMeasuresList[ 1 ]->velocity;
@@ -145,7 +155,7 @@ void RunControlStep( DoFVariables** jointMeasuresList, DoFVariables** axisMeasur
   
   fprintf( stderr, "position 1=%.5f, position 2=%.5f\n", axisMeasuresList[ 0 ]->position, axisMeasuresList[ 1 ]->position );
   
-  controlData.elapsedTime += timeDelta;
+  controlData->elapsedTime += timeDelta;
   
-  //if( controlData.state != ROBOT_OPERATION && controlData.state != ROBOT_PREPROCESSING ) jointSetpointsList[ 0 ]->force = jointSetpointsList[ 1 ]->force = 0.0;
+  //if( controlData->state != ROBOT_OPERATION && controlData->state != ROBOT_PREPROCESSING ) jointSetpointsList[ 0 ]->force = jointSetpointsList[ 1 ]->force = 0.0;
 }
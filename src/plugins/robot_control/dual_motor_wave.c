@@ -19,26 +19,28 @@
 //                                                                            //
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <stdlib.h>
 #include <string.h>
 #include <math.h>
 
 #include "robot_control/robot_control.h"
+#include "robot_control_extensions.h"
 
 #include "debug/data_logging.h"
 
 #define DOFS_NUMBER 2
 #define DELAY_SETPOINTS_NUMBER 5
 
-const double MAX_WAVE_IMPEDANCE = 10.0;
-const double MIN_WAVE_IMPEDANCE_FACTOR = 0.1;
+static const double MAX_WAVE_IMPEDANCE = 10.0;
+static const double MIN_WAVE_IMPEDANCE_FACTOR = 0.1;
 
-const double MAX_WAVE_BANDWIDTH = 0.2;
-const double MIN_WAVE_BANDWIDTH_FACTOR = 0.1;
-const double MAX_WAVE_BANDWIDTH_FACTOR = 1.0;
+static const double MAX_WAVE_BANDWIDTH = 0.2;
+static const double MIN_WAVE_BANDWIDTH_FACTOR = 0.1;
+static const double MAX_WAVE_BANDWIDTH_FACTOR = 1.0;
 
-const char* DOF_NAMES[ DOFS_NUMBER ] = { "angle1", "angle2" };
+static const char* DOF_NAMES[ DOFS_NUMBER ] = { "angle1", "angle2" };
 
-static struct
+typedef struct _ControlData
 {
   double wavesTable[ DOFS_NUMBER ][ DELAY_SETPOINTS_NUMBER ];
   double inputPositionsTable[ DOFS_NUMBER ][ DELAY_SETPOINTS_NUMBER ];
@@ -49,69 +51,75 @@ static struct
   double elapsedTime;
   Log samplingLog;
 }
-controlData;
+ControlData;
 
 
-DECLARE_MODULE_INTERFACE( ROBOT_CONTROL_INTERFACE );
+DECLARE_MODULE_INTERFACE( ROBOT_CONTROL_CONTEXT_INTERFACE );
 
 
-bool InitController( const char* configurationString )
+ControllerContext CreateController( const char* configurationString )
 {
-  memset( &controlData, 0, sizeof(controlData) );
+  ControlData* controlData = (ControlData*) calloc( 1, sizeof(ControlData) );
+  if( controlData == NULL ) return NULL;
   
   Log_SetDirectory( "" );
-  controlData.samplingLog = Log_Init( "motor_sampling", 8 );
+  controlData->samplingLog = Log_Init( "motor_sampling", 8 );
   
-  controlData.elapsedTime = 0.0;
+  controlData->elapsedTime = 0.0;
   
-  controlData.state = CONTROL_PASSIVE;
+  controlData->state = CONTROL_PASSIVE;
   
-  return true;
+  return controlData;
 }
 
-void EndController()
+void DiscardController( ControllerContext context )
 {
-  Log_End( controlData.samplingLog );
+  ControlData* controlData = (ControlData*) context;
+  
+  Log_End( controlData->samplingLog );
+  free( controlData );
 }
 
-size_t GetJointsNumber()
+size_t GetControllerJointsNumber( ControllerContext context )
 {
   return DOFS_NUMBER;
 }
 
-const char** GetJointNamesList()
+const char** GetControllerJointNamesList( ControllerContext context )
 {
   return (const char**) DOF_NAMES;
 }
 
-size_t GetAxesNumber()
+size_t GetControllerAxesNumber( ControllerContext context )
 {
   return DOFS_NUMBER;
 }
 
-const char** GetAxisNamesList()
+const char** GetControllerAxisNamesList( ControllerContext context )
 {
   return (const char**) DOF_NAMES;
 }
 
-size_t GetExtraInputsNumber( void ) { return 0; }
+size_t GetControllerExtraInputsNumber( ControllerContext context ) { return 0; }
       
-void SetExtraInputsList( double* inputsList ) { }
+void SetControllerExtraInputsList( ControllerContext context, double* inputsList ) { }
 
-size_t GetExtraOutputsNumber( void ) { return 0; }
+size_t GetControllerExtraOutputsNumber( ControllerContext context ) { return 0; }
          
-void GetExtraOutputsList( double* outputsList ) { }
+void GetControllerExtraOutputsList( ControllerContext context, double* outputsList ) { }
 
-void SetControlState( enum ControlState newControlState )
+void SetControllerState( ControllerContext context, enum ControlState newControlState )
 {
+  ControlData* controlData = (ControlData*) context;
+  
   fprintf( stderr, "Setting robot control phase: %x\n", newControlState );
   
-  if( newControlState == CONTROL_PREPROCESSING ) controlData.elapsedTime = 0.0;
+  if( newControlState == CONTROL_PREPROCESSING ) controlData->elapsedTime = 0.0;
   
-  controlData.state = newControlState;
+  controlData->state = newControlState;
 }
 
-double FilterWave( double inputWave, double* ref_lastInputWave, double* ref_lastFilteredWave, double bandwidth )
+static double FilterWave( double inputWave, double* ref_lastInputWave, double* ref_lastFilteredWave, double bandwidth )
 {
   double lastInputWave = (*ref_lastInputWave);
   double lastFilteredWave = (*ref_lastFilteredWave);
@@ -121,7 +129,7 @@ double FilterWave( double inputWave, double* ref_lastInputWave, double* ref_last
   return filteredWave;
 }
 
-double CorrectWave( double inputWave, double waveImpedance, double inputPosition, double currentPosition, double bandwidth )
+static double CorrectWave( double inputWave, double waveImpedance, double inputPosition, double currentPosition, double bandwidth )
 {
   double positionError = inputPosition - currentPosition;
   double waveCorrection = sqrt( 2.0 * waveImpedance ) * bandwidth * positionError;
@@ -132,28 +140,28 @@ double CorrectWave( double inputWave, double waveImpedance, double inputPosition
   return inputWave;
 }
 
-double ExtractForce( double inputWave, double waveImpedance, double inputVelocity )
+static double ExtractForce( double inputWave, double waveImpedance, double inputVelocity )
 {
   double outputForce = -( waveImpedance * inputVelocity - sqrt( 2.0 * waveImpedance ) * inputWave );
   
   return outputForce;
 }
 
-double ExtractVelocity( double inputWave, double waveImpedance, double inputForce )
+static double ExtractVelocity( double inputWave, double waveImpedance, double inputForce )
 {
   double outputVelocity = ( sqrt( 2.0 * waveImpedance ) * inputWave + inputForce ) / waveImpedance;
   
   return outputVelocity;
 }
 
-double BuildWave( double waveImpedance, double velocity, double force )
+static double BuildWave( double waveImpedance, double velocity, double force )
 {
   double outputWave = ( waveImpedance * velocity - force ) / sqrt( 2.0 * waveImpedance );
   
   return outputWave;
 }
 
-void ControlJoint( DoFVariables* ref_jointMeasures, DoFVariables* ref_axisMeasures, DoFVariables* ref_jointSetpoints, DoFVariables* ref_axisSetpoints )
+static void ControlJoint( DoFVariables* ref_jointMeasures, DoFVariables* ref_axisMeasures, DoFVariables* ref_jointSetpoints, DoFVariables* ref_axisSetpoints )
 {
   ref_axisMeasures->acceleration = ref_jointMeasures->acceleration;
   ref_axisMeasures->velocity = ref_jointMeasures->velocity;
@@ -172,9 +180,11 @@ void ControlJoint( DoFVariables* ref_jointMeasures, DoFVariables* ref_axisMeasur
   //fprintf( stderr, "position=%.5f, setpoint=%.5f, control force=%.5f\n", ref_jointMeasures->position, ref_jointSetpoints->position, ref_jointSetpoints->force );
 }
 
-void RunControlStep( DoFVariables** jointMeasuresList, DoFVariables** axisMeasuresList, DoFVariables** jointSetpointsList, DoFVariables** axisSetpointsList, double timeDelta )
+void RunControllerStep( ControllerContext context, DoFVariables** jointMeasuresList, DoFVariables** axisMeasuresList, DoFVariables** jointSetpointsList, DoFVariables** axisSetpointsList, double timeDelta )
 {
-  size_t setpointIndex = controlData.setpointCount % DELAY_SETPOINTS_NUMBER;
+  ControlData* controlData = (ControlData*) context;
+  
+  size_t setpointIndex = controlData->setpointCount % DELAY_SETPOINTS_NUMBER;
   
   if( axisSetpointsList[ 0 ]->stiffness < MIN_WAVE_BANDWIDTH_FACTOR ) axisSetpointsList[ 0 ]->stiffness = MIN_WAVE_BANDWIDTH_FACTOR;
   if( axisSetpointsList[ 0 ]->stiffness > MAX_WAVE_BANDWIDTH_FACTOR ) axisSetpointsList[ 0 ]->stiffness = MAX_WAVE_BANDWIDTH_FACTOR;
@@ -187,34 +197,34 @@ void RunControlStep( DoFVariables** jointMeasuresList, DoFVariables** axisMeasur
   double waveBandwidth = MAX_WAVE_BANDWIDTH * axisSetpointsList[ 0 ]->stiffness;
   double waveImpedance = MAX_WAVE_IMPEDANCE * axisSetpointsList[ 0 ]->damping;
   
-  double wave_0 = FilterWave( controlData.wavesTable[ 0 ][ setpointIndex ], 
-                              &(controlData.lastInputWavesList[ 0 ]), &(controlData.lastFilteredWavesList[ 0 ]), waveBandwidth );
+  double wave_0 = FilterWave( controlData->wavesTable[ 0 ][ setpointIndex ], 
+                              &(controlData->lastInputWavesList[ 0 ]), &(controlData->lastFilteredWavesList[ 0 ]), waveBandwidth );
 
-  double wave_1 = FilterWave( controlData.wavesTable[ 1 ][ setpointIndex ], 
-                              &(controlData.lastInputWavesList[ 1 ]), &(controlData.lastFilteredWavesList[ 1 ]), waveBandwidth );
+  double wave_1 = FilterWave( controlData->wavesTable[ 1 ][ setpointIndex ], 
+                              &(controlData->lastInputWavesList[ 1 ]), &(controlData->lastFilteredWavesList[ 1 ]), waveBandwidth );
   
-  wave_0 = CorrectWave( wave_0, waveImpedance, controlData.inputPositionsTable[ 0 ][ setpointIndex ], jointMeasuresList[ 0 ]->position, waveBandwidth );
+  wave_0 = CorrectWave( wave_0, waveImpedance, controlData->inputPositionsTable[ 0 ][ setpointIndex ], jointMeasuresList[ 0 ]->position, waveBandwidth );
   axisSetpointsList[ 0 ]->force = ExtractForce( wave_0, waveImpedance, jointMeasuresList[ 0 ]->velocity );
   ControlJoint( jointMeasuresList[ 0 ], axisMeasuresList[ 0 ], jointSetpointsList[ 0 ], axisSetpointsList[ 0 ] );
   
-  controlData.wavesTable[ 1 ][ setpointIndex ] = BuildWave( waveImpedance, jointMeasuresList[ 0 ]->velocity, axisSetpointsList[ 0 ]->force );
-  controlData.inputPositionsTable[ 1 ][ setpointIndex ] = axisMeasuresList[ 0 ]->position;
+  controlData->wavesTable[ 1 ][ setpointIndex ] = BuildWave( waveImpedance, jointMeasuresList[ 0 ]->velocity, axisSetpointsList[ 0 ]->force );
+  controlData->inputPositionsTable[ 1 ][ setpointIndex ] = axisMeasuresList[ 0 ]->position;
   
-  //if( controlData.state == ROBOT_PREPROCESSING )
+  //if( controlData->state == ROBOT_PREPROCESSING )
   //{
-  //  Log_EnterNewLine( controlData.samplingLog, controlData.elapsedTime );
-  //  Log_RegisterValues( controlData.samplingLog, 4, jointMeasuresList[ 0 ]->force, jointMeasuresList[ 0 ]->position, jointMeasuresList[ 0 ]->velocity, jointMeasuresList[ 0 ]->acceleration );
+  //  Log_EnterNewLine( controlData->samplingLog, controlData->elapsedTime );
+  //  Log_RegisterValues( controlData->samplingLog, 4, jointMeasuresList[ 0 ]->force, jointMeasuresList[ 0 ]->position, jointMeasuresList[ 0 ]->velocity, jointMeasuresList[ 0 ]->acceleration );
   //}
   
-  wave_1 = CorrectWave( wave_1, waveImpedance, controlData.inputPositionsTable[ 1 ][ setpointIndex ], jointMeasuresList[ 1 ]->position, waveBandwidth );
+  wave_1 = CorrectWave( wave_1, waveImpedance, controlData->inputPositionsTable[ 1 ][ setpointIndex ], jointMeasuresList[ 1 ]->position, waveBandwidth );
   axisSetpointsList[ 1 ]->force = ExtractForce( wave_1, waveImpedance, jointMeasuresList[ 1 ]->velocity );
   ControlJoint( jointMeasuresList[ 1 ], axisMeasuresList[ 1 ], jointSetpointsList[ 1 ], axisSetpointsList[ 1 ] );
   
-  controlData.wavesTable[ 0 ][ setpointIndex ] = BuildWave( waveImpedance, jointMeasuresList[ 1 ]->velocity, axisSetpointsList[ 1 ]->force );
-  controlData.inputPositionsTable[ 0 ][ setpointIndex ] = axisMeasuresList[ 1 ]->position;
+  controlData->wavesTable[ 0 ][ setpointIndex ] = BuildWave( waveImpedance, jointMeasuresList[ 1 ]->velocity, axisSetpointsList[ 1 ]->force );
+  controlData->inputPositionsTable[ 0 ][ setpointIndex ] = axisMeasuresList[ 1 ]->position;
   
-  controlData.setpointCount++;
-  controlData.elapsedTime += timeDelta;
+  controlData->setpointCount++;
+  controlData->elapsedTime += timeDelta;
   
-  //if( controlData.state != ROBOT_OPERATION && controlData.state != ROBOT_PREPROCESSING ) jointSetpointsList[ 0 ]->force = jointSetpointsList[ 1 ]->force = 0.0;
+  //if( controlData->state != ROBOT_OPERATION && controlData->state != ROBOT_PREPROCESSING ) jointSetpointsList[ 0 ]->force = jointSetpointsList[ 1 ]->force = 0.0;
 }
@@ -0,0 +1,195 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file emg_control.c
+/// @brief Single joint EMG-driven assistive controller
+///
+/// Muscular joint torque and stiffness are estimated from (normalized) EMG signals, read as robot extra inputs (one per muscle), through spline tables built by @ref emg_muscular_model.h.
+/// Configuration string: "<min_angle> <max_angle> <assistance_gain> <muscle_1_config> <muscle_2_config> ...", where muscle configurations (containing "muscle_properties" 
+/// fields, as on config/sensors/emg/template.json) are given relative to [<root_dir>]/config/sensors/
+
+#include "robot_control/robot_control.h"
+#include "robot_control_extensions.h"
+
+#include "emg_muscular_model.h"
+
+#include "data_io/interface/data_io.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DOFS_NUMBER 1
+#define MUSCLES_MAX_NUMBER 32
+#define SPLINE_SEGMENTS_NUMBER 64
+
+static const char* DOF_NAMES[ DOFS_NUMBER ] = { "angle" };
+
+static const char* MUSCLE_CURVE_NAMES[ MUSCLE_CURVES_NUMBER ] = { [ MUSCLE_ACTIVE_FORCE ] = "active_force", [ MUSCLE_PASSIVE_FORCE ] = "passive_force", 
+                                                           [ MUSCLE_MOMENT_ARM ] = "moment_arm", [ MUSCLE_NORMALIZED_LENGTH ] = "normalized_length" };
+
+typedef struct _ControlData
+{
+  enum ControlState controlState;
+  MuscularModel jointModel;
+  size_t musclesNumber;
+  double emgValuesList[ MUSCLES_MAX_NUMBER ];
+  double assistanceGain;
+}
+ControlData;
+
+
+DECLARE_MODULE_INTERFACE( ROBOT_CONTROL_CONTEXT_INTERFACE );
+
+
+static bool LoadMuscleProperties( const char* muscleName, MuscleProperties* ref_properties )
+{
+  char filePath[ DATA_IO_MAX_PATH_LENGTH ];
+  sprintf( filePath, "config/sensors/%s", muscleName );
+  DataHandle configuration = DataIO_LoadStorageData( filePath );
+  if( configuration == NULL ) return false;
+  
+  memset( ref_properties, 0, sizeof(MuscleProperties) );
+  for( int curveIndex = 0; curveIndex < MUSCLE_CURVES_NUMBER; curveIndex++ )
+  {
+    size_t curveOrder = DataIO_GetListSize( configuration, "muscle_properties.curves.%s", MUSCLE_CURVE_NAMES[ curveIndex ] );
+    if( curveOrder > MUSCLE_CURVE_MAX_ORDER ) curveOrder = MUSCLE_CURVE_MAX_ORDER;
+    for( size_t coefficientIndex = 0; coefficientIndex < curveOrder; coefficientIndex++ )
+      ref_properties->curvesList[ curveIndex ][ coefficientIndex ] = DataIO_GetNumericValue( configuration, 0.0, "muscle_properties.curves.%s.%lu", 
+                                                                                             MUSCLE_CURVE_NAMES[ curveIndex ], coefficientIndex );
+    ref_properties->curveOrdersList[ curveIndex ] = curveOrder;
+  }
+  ref_properties->penationAngle = DataIO_GetNumericValue( configuration, 0.0, "muscle_properties.penation_angle" );
+  ref_properties->scaleFactor = DataIO_GetNumericValue( configuration, 1.0, "muscle_properties.scale_factor" );
+  ref_properties->activationFactor = DataIO_GetNumericValue( configuration, 0.0, "muscle_properties.activation_factor" );
+  
+  DataIO_UnloadData( configuration );
+  
+  return true;
+}
+
+static bool LoadConfiguration( ControlData* controlData, const char* configurationString ) 
+{
+  if( configurationString == NULL ) return false;
+  
+  char configBuffer[ 1024 ];
+  strncpy( configBuffer, configurationString, sizeof(configBuffer) - 1 );
+  configBuffer[ sizeof(configBuffer) - 1 ] = '\0';
+  
+  char* minAngleString = strtok( configBuffer, " " );
+  char* maxAngleString = strtok( NULL, " " );
+  char* gainString = strtok( NULL, " " );
+  if( minAngleString == NULL || maxAngleString == NULL || gainString == NULL ) return false;
+  double minAngle = strtod( minAngleString, NULL );
+  double maxAngle = strtod( maxAngleString, NULL );
+  controlData->assistanceGain = strtod( gainString, NULL );
+  
+  MuscleProperties musclePropertiesList[ MUSCLES_MAX_NUMBER ];
+  size_t musclesNumber = 0;
+  for( char* muscleName = strtok( NULL, " " ); muscleName != NULL && musclesNumber < MUSCLES_MAX_NUMBER; muscleName = strtok( NULL, " " ) )
+  {
+    if( !LoadMuscleProperties( muscleName, &(musclePropertiesList[ musclesNumber ]) ) ) 
+    {
+      fprintf( stderr, "EMG control: muscle %s configuration not found\n", muscleName );
+      return false;
+    }
+    musclesNumber++;
+  }
+  
+  controlData->jointModel = MuscularModel_Create( musclesNumber, minAngle, maxAngle, SPLINE_SEGMENTS_NUMBER );
+  if( controlData->jointModel == NULL ) return false;
+  controlData->musclesNumber = musclesNumber;
+  for( size_t muscleIndex = 0; muscleIndex < musclesNumber; muscleIndex++ )
+  {
+    if( !MuscularModel_SetMuscle( controlData->jointModel, muscleIndex, &(musclePropertiesList[ muscleIndex ]) ) ) return false;
+  }
+  
+  return true;
+}
+
+ControllerContext CreateController( const char* configurationString ) 
+{
+  ControlData* controlData = (ControlData*) calloc( 1, sizeof(ControlData) );
+  if( controlData == NULL ) return NULL;
+  
+  controlData->controlState = CONTROL_PASSIVE;
+  
+  if( !LoadConfiguration( controlData, configurationString ) )
+  {
+    DiscardController( controlData );
+    return NULL;
+  }
+  
+  return controlData;
+}
+
+void DiscardController( ControllerContext context ) 
+{ 
+  ControlData* controlData = (ControlData*) context;
+  
+  MuscularModel_Discard( controlData->jointModel );
+  free( controlData );
+}
+
+size_t GetControllerJointsNumber( ControllerContext context ) { return DOFS_NUMBER; }
+
+const char** GetControllerJointNamesList( ControllerContext context ) { return DOF_NAMES; }
+
+size_t GetControllerAxesNumber( ControllerContext context ) { return DOFS_NUMBER; }
+
+const char** GetControllerAxisNamesList( ControllerContext context ) { return DOF_NAMES; }
+
+size_t GetControllerExtraInputsNumber( ControllerContext context ) { return ((ControlData*) context)->musclesNumber; }
+      
+void SetControllerExtraInputsList( ControllerContext context, double* inputsList ) 
+{ 
+  ControlData* controlData = (ControlData*) context;
+  
+  memcpy( controlData->emgValuesList, inputsList, controlData->musclesNumber * sizeof(double) );
+}
+
+size_t GetControllerExtraOutputsNumber( ControllerContext context ) { return 0; }
+         
+void GetControllerExtraOutputsList( ControllerContext context, double* outputsList ) { return; }
+
+void SetControllerState( ControllerContext context, enum ControlState newControlState )
+{
+  ControlData* controlData = (ControlData*) context;
+  
+  controlData->controlState = newControlState;
+}
+
+void RunControllerStep( ControllerContext context, DoFVariables** jointMeasuresList, DoFVariables** axisMeasuresList, DoFVariables** jointSetpointsList, DoFVariables** axisSetpointsList, double timeDelta )
+{
+  ControlData* controlData = (ControlData*) context;
+  
+  *(axisMeasuresList[ 0 ]) = *(jointMeasuresList[ 0 ]);
+  
+  double muscularStiffness;
+  double muscularTorque = MuscularModel_GetTorque( controlData->jointModel, jointMeasuresList[ 0 ]->position, controlData->emgValuesList, &muscularStiffness );
+  // Estimated user contribution is reported on axis measures
+  axisMeasuresList[ 0 ]->force = muscularTorque;
+  axisMeasuresList[ 0 ]->stiffness = muscularStiffness;
+  
+  *(jointSetpointsList[ 0 ]) = *(axisSetpointsList[ 0 ]);
+  if( controlData->controlState == CONTROL_OPERATION ) jointSetpointsList[ 0 ]->force += controlData->assistanceGain * muscularTorque;
+}
@@ -0,0 +1,205 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "emg_muscular_model.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Replaces null activation shape factors, so that the same exponential formula gives a (numerically) linear activation, with no branches
+static const double MIN_ACTIVATION_FACTOR = 1e-6;
+
+enum { SPLINE_A, SPLINE_B, SPLINE_C, SPLINE_D, SPLINE_COEFFS_NUMBER };
+
+// Tables are laid out as [ segment ][ coefficient ][ muscle ], so that all muscles of a segment are contiguous
+struct _MuscularModelData
+{
+  size_t musclesNumber;
+  size_t segmentsNumber;
+  double minAngle, segmentLength;
+  double* activeTorqueTable;      // Joint torque per unit activation
+  double* passiveTorqueTable;     // Joint torque independent from activation
+  double* activationFactorsList;
+  double* activationScalesList;
+  double* activationsList;
+};
+
+
+static double EvaluatePolynomial( const double* coefficientsList, size_t order, double x )
+{
+  double value = 0.0;
+  for( size_t coefficientIndex = order; coefficientIndex > 0; coefficientIndex-- )
+    value = value * x + coefficientsList[ coefficientIndex - 1 ];
+  
+  return value;
+}
+
+// Natural cubic spline through uniformly spaced samples, with local coordinate t in [0,1) along each segment
+static void BuildSplineTable( MuscularModel model, size_t muscleIndex, const double* samplesList, double* table )
+{
+  size_t segmentsNumber = model->segmentsNumber;
+  double* secondDerivativesList = (double*) calloc( segmentsNumber + 1, sizeof(double) );
+  double* auxiliarList = (double*) calloc( segmentsNumber + 1, sizeof(double) );
+  
+  // Thomas algorithm for M[i-1] + 4*M[i] + M[i+1] = 6 * ( y[i+1] - 2*y[i] + y[i-1] ) / h^2, with M[0] = M[n] = 0
+  double stepFactor = 6.0 / ( model->segmentLength * model->segmentLength );
+  for( size_t knotIndex = 1; knotIndex < segmentsNumber; knotIndex++ )
+  {
+    double rightSide = stepFactor * ( samplesList[ knotIndex + 1 ] - 2 * samplesList[ knotIndex ] + samplesList[ knotIndex - 1 ] );
+    double pivot = 4.0 - auxiliarList[ knotIndex - 1 ];
+    auxiliarList[ knotIndex ] = 1.0 / pivot;
+    secondDerivativesList[ knotIndex ] = ( rightSide - secondDerivativesList[ knotIndex - 1 ] ) / pivot;
+  }
+  for( size_t knotIndex = segmentsNumber - 1; knotIndex > 0; knotIndex-- )
+    secondDerivativesList[ knotIndex ] -= auxiliarList[ knotIndex ] * secondDerivativesList[ knotIndex + 1 ];
+  
+  double squaredLength = model->segmentLength * model->segmentLength;
+  for( size_t segmentIndex = 0; segmentIndex < segmentsNumber; segmentIndex++ )
+  {
+    double* coefficientsList = table + segmentIndex * SPLINE_COEFFS_NUMBER * model->musclesNumber + muscleIndex;
+    double startSecondDerivative = secondDerivativesList[ segmentIndex ], endSecondDerivative = secondDerivativesList[ segmentIndex + 1 ];
+    coefficientsList[ SPLINE_A * model->musclesNumber ] = samplesList[ segmentIndex ];
+    coefficientsList[ SPLINE_B * model->musclesNumber ] = ( samplesList[ segmentIndex + 1 ] - samplesList[ segmentIndex ] ) 
+                                                          - squaredLength * ( 2 * startSecondDerivative + endSecondDerivative ) / 6.0;
+    coefficientsList[ SPLINE_C * model->musclesNumber ] = squaredLength * startSecondDerivative / 2.0;
+    coefficientsList[ SPLINE_D * model->musclesNumber ] = squaredLength * ( endSecondDerivative - startSecondDerivative ) / 6.0;
+  }
+  
+  free( secondDerivativesList );
+  free( auxiliarList );
+}
+
+MuscularModel MuscularModel_Create( size_t musclesNumber, double minAngle, double maxAngle, size_t segmentsNumber )
+{
+  if( musclesNumber == 0 || segmentsNumber < 2 || !( maxAngle > minAngle ) ) return NULL;
+  
+  MuscularModel newModel = (MuscularModel) malloc( sizeof(MuscularModelData) );
+  
+  newModel->musclesNumber = musclesNumber;
+  newModel->segmentsNumber = segmentsNumber;
+  newModel->minAngle = minAngle;
+  newModel->segmentLength = ( maxAngle - minAngle ) / segmentsNumber;
+  newModel->activeTorqueTable = (double*) calloc( segmentsNumber * SPLINE_COEFFS_NUMBER * musclesNumber, sizeof(double) );
+  newModel->passiveTorqueTable = (double*) calloc( segmentsNumber * SPLINE_COEFFS_NUMBER * musclesNumber, sizeof(double) );
+  newModel->activationFactorsList = (double*) calloc( musclesNumber, sizeof(double) );
+  newModel->activationScalesList = (double*) calloc( musclesNumber, sizeof(double) );
+  newModel->activationsList = (double*) calloc( musclesNumber, sizeof(double) );
+  
+  for( size_t muscleIndex = 0; muscleIndex < musclesNumber; muscleIndex++ )
+  {
+    newModel->activationFactorsList[ muscleIndex ] = MIN_ACTIVATION_FACTOR;
+    newModel->activationScalesList[ muscleIndex ] = 1.0 / ( exp( MIN_ACTIVATION_FACTOR ) - 1.0 );
+  }
+  
+  return newModel;
+}
+
+void MuscularModel_Discard( MuscularModel model )
+{
+  if( model == NULL ) return;
+  
+  free( model->activeTorqueTable );
+  free( model->passiveTorqueTable );
+  free( model->activationFactorsList );
+  free( model->activationScalesList );
+  free( model->activationsList );
+  
+  free( model );
+}
+
+bool MuscularModel_SetMuscle( MuscularModel model, size_t muscleIndex, const MuscleProperties* properties )
+{
+  if( model == NULL ) return false;
+  if( muscleIndex >= model->musclesNumber ) return false;
+  
+  for( int curveIndex = 0; curveIndex < MUSCLE_CURVES_NUMBER; curveIndex++ )
+  {
+    if( properties->curveOrdersList[ curveIndex ] > MUSCLE_CURVE_MAX_ORDER ) return false;
+  }
+  
+  double* activeSamplesList = (double*) calloc( model->segmentsNumber + 1, sizeof(double) );
+  double* passiveSamplesList = (double*) calloc( model->segmentsNumber + 1, sizeof(double) );
+  
+  double fiberForceFactor = properties->scaleFactor * cos( properties->penationAngle );
+  for( size_t knotIndex = 0; knotIndex <= model->segmentsNumber; knotIndex++ )
+  {
+    double jointAngle = model->minAngle + knotIndex * model->segmentLength;
+    double normalizedLength = EvaluatePolynomial( properties->curvesList[ MUSCLE_NORMALIZED_LENGTH ], properties->curveOrdersList[ MUSCLE_NORMALIZED_LENGTH ], jointAngle );
+    double momentArm = EvaluatePolynomial( properties->curvesList[ MUSCLE_MOMENT_ARM ], properties->curveOrdersList[ MUSCLE_MOMENT_ARM ], jointAngle );
+    double activeForce = EvaluatePolynomial( properties->curvesList[ MUSCLE_ACTIVE_FORCE ], properties->curveOrdersList[ MUSCLE_ACTIVE_FORCE ], normalizedLength );
+    double passiveForce = EvaluatePolynomial( properties->curvesList[ MUSCLE_PASSIVE_FORCE ], properties->curveOrdersList[ MUSCLE_PASSIVE_FORCE ], normalizedLength );
+    activeSamplesList[ knotIndex ] = fiberForceFactor * activeForce * momentArm;
+    passiveSamplesList[ knotIndex ] = fiberForceFactor * passiveForce * momentArm;
+  }
+  
+  BuildSplineTable( model, muscleIndex, activeSamplesList, model->activeTorqueTable );
+  BuildSplineTable( model, muscleIndex, passiveSamplesList, model->passiveTorqueTable );
+  
+  free( activeSamplesList );
+  free( passiveSamplesList );
+  
+  double activationFactor = ( fabs( properties->activationFactor ) > MIN_ACTIVATION_FACTOR ) ? properties->activationFactor : MIN_ACTIVATION_FACTOR;
+  model->activationFactorsList[ muscleIndex ] = activationFactor;
+  model->activationScalesList[ muscleIndex ] = 1.0 / ( exp( activationFactor ) - 1.0 );
+  
+  return true;
+}
+
+double MuscularModel_GetTorque( MuscularModel model, double jointAngle, const double* emgList, double* ref_stiffness )
+{
+  if( model == NULL ) return 0.0;
+  
+  const size_t musclesNumber = model->musclesNumber;
+  
+  // Segment and local coordinate are the same for all muscles
+  double segmentCoordinate = ( jointAngle - model->minAngle ) / model->segmentLength;
+  segmentCoordinate = fmin( fmax( segmentCoordinate, 0.0 ), model->segmentsNumber - 1e-9 );
+  size_t segmentIndex = (size_t) segmentCoordinate;
+  double t = segmentCoordinate - segmentIndex;
+  
+  for( size_t muscleIndex = 0; muscleIndex < musclesNumber; muscleIndex++ )
+    model->activationsList[ muscleIndex ] = ( exp( model->activationFactorsList[ muscleIndex ] * emgList[ muscleIndex ] ) - 1.0 ) * model->activationScalesList[ muscleIndex ];
+  
+  const double* active = model->activeTorqueTable + segmentIndex * SPLINE_COEFFS_NUMBER * musclesNumber;
+  const double* passive = model->passiveTorqueTable + segmentIndex * SPLINE_COEFFS_NUMBER * musclesNumber;
+  const double* activeA = active + SPLINE_A * musclesNumber, * activeB = active + SPLINE_B * musclesNumber;
+  const double* activeC = active + SPLINE_C * musclesNumber, * activeD = active + SPLINE_D * musclesNumber;
+  const double* passiveA = passive + SPLINE_A * musclesNumber, * passiveB = passive + SPLINE_B * musclesNumber;
+  const double* passiveC = passive + SPLINE_C * musclesNumber, * passiveD = passive + SPLINE_D * musclesNumber;
+  const double* activationsList = model->activationsList;
+  
+  double torque = 0.0, torqueDerivative = 0.0;
+  for( size_t muscleIndex = 0; muscleIndex < musclesNumber; muscleIndex++ )
+  {
+    double a = activationsList[ muscleIndex ] * activeA[ muscleIndex ] + passiveA[ muscleIndex ];
+    double b = activationsList[ muscleIndex ] * activeB[ muscleIndex ] + passiveB[ muscleIndex ];
+    double c = activationsList[ muscleIndex ] * activeC[ muscleIndex ] + passiveC[ muscleIndex ];
+    double d = activationsList[ muscleIndex ] * activeD[ muscleIndex ] + passiveD[ muscleIndex ];
+    torque += ( ( d * t + c ) * t + b ) * t + a;
+    torqueDerivative += ( 3 * d * t + 2 * c ) * t + b;
+  }
+  
+  if( ref_stiffness != NULL ) *ref_stiffness = torqueDerivative / model->segmentLength;
+  
+  return torque;
+}
@@ -0,0 +1,83 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file emg_muscular_model.h
+/// @brief EMG-driven joint muscular model functions
+///
+/// Joint torque estimation from muscle activations. Each muscle is described by polynomial curves (ascending order coefficients): normalized fiber length and moment arm
+/// as functions of joint angle, and active/passive normalized forces as functions of fiber length. At muscle setup, their composition (active and passive joint torques per
+/// unit activation) is sampled over the joint angle range and turned into uniformly spaced cubic spline tables, so that all muscles are evaluated on each update by a single,
+/// branch-free loop with no transcendental functions (besides optional nonlinear activation)
+
+#ifndef EMG_MUSCULAR_MODEL_H
+#define EMG_MUSCULAR_MODEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define MUSCLE_CURVE_MAX_ORDER 10     ///< Maximum number of polynomial coefficients per muscle curve
+
+/// Muscle curves (polynomial coefficient lists)
+enum MuscleCurve { MUSCLE_ACTIVE_FORCE, MUSCLE_PASSIVE_FORCE, MUSCLE_MOMENT_ARM, MUSCLE_NORMALIZED_LENGTH, MUSCLE_CURVES_NUMBER };
+
+/// Single muscle parameters
+typedef struct _MuscleProperties
+{
+  double curvesList[ MUSCLE_CURVES_NUMBER ][ MUSCLE_CURVE_MAX_ORDER ];    ///< Polynomial coefficients of each curve
+  size_t curveOrdersList[ MUSCLE_CURVES_NUMBER ];                         ///< Number of coefficients of each curve
+  double penationAngle;                                                   ///< Fiber penation angle (in radians)
+  double scaleFactor;                                                     ///< Maximum isometric force
+  double activationFactor;                                                ///< EMG to activation nonlinear shape factor (0 for linear)
+}
+MuscleProperties;
+
+typedef struct _MuscularModelData MuscularModelData;    ///< Single joint muscular model internal data structure
+typedef MuscularModelData* MuscularModel;               ///< Opaque reference to joint muscular model
+
+/// @brief Creates joint model, with tables allocated for given number of muscles
+/// @param[in] musclesNumber number of muscles acting on joint
+/// @param[in] minAngle lower limit of joint angle range covered by tables (in radians)
+/// @param[in] maxAngle upper limit of joint angle range covered by tables (in radians)
+/// @param[in] segmentsNumber number of spline segments over angle range
+/// @return reference to created model (NULL on errors)
+MuscularModel MuscularModel_Create( size_t musclesNumber, double minAngle, double maxAngle, size_t segmentsNumber );
+
+/// @brief Deallocates internal data of given model
+/// @param[in] model reference to model
+void MuscularModel_Discard( MuscularModel model );
+
+/// @brief Builds spline tables of given muscle from its properties
+/// @param[in] model reference to model
+/// @param[in] muscleIndex index of muscle on model
+/// @param[in] properties pointer to muscle parameters
+/// @return true on success, false otherwise
+bool MuscularModel_SetMuscle( MuscularModel model, size_t muscleIndex, const MuscleProperties* properties );
+
+/// @brief Estimates joint torque (and its derivative) from current angle and all muscles normalized EMG values
+/// @param[in] model reference to model
+/// @param[in] jointAngle current joint angle (clamped to model range, in radians)
+/// @param[in] emgList normalized EMG values list (one per muscle)
+/// @param[out] ref_stiffness pointer to returned joint stiffness (torque derivative in relation to angle, ignored if NULL)
+/// @return estimated total muscular torque on joint
+double MuscularModel_GetTorque( MuscularModel model, double jointAngle, const double* emgList, double* ref_stiffness );
+
+#endif // EMG_MUSCULAR_MODEL_H
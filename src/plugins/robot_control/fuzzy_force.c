@@ -20,83 +20,111 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 
-#include "actuator_control/interface.h"
+/// @file fuzzy_force.c
+/// @brief Single joint fuzzy force/position controller
+///
+/// Velocity setpoint is inferred from normalized position and force errors, by evaluating a fuzzy output surface precomputed at initialization.
+/// Configuration string (all values optional): "<position_error_scale> <force_error_scale> <output_gain> <sets_width> <table_resolution>" (default: "0.3 5.0 600.0 0.2 128")
 
-#include <math.h>
+#include "robot_control/robot_control.h"
+#include "robot_control_extensions.h"
 
-enum { NEGATIVE_HIGH, NEGATIVE_LOW, ZERO, POSITIVE_LOW, POSITIVE_HIGH, FUZZY_SETS_NUMBER };
+#include "fuzzy_inference.h"
 
-#define DISCRETIZATION_INTERVAL 0.01
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
-typedef struct _NormalDistribuitionData
+#define DOFS_NUMBER 1
+
+static const char* DOF_NAMES[ DOFS_NUMBER ] = { "angle" };
+
+typedef struct _ControlData
 {
-  double medianValue;
-  double variance;
+  enum ControlState controlState;
+  double positionErrorScale, forceErrorScale;
+  double outputGain;
+  FuzzySurface outputSurface;
 }
-NormalDistribuitionData;
+ControlData;
 
-const NormalDistribuitionData FUZZY_SETS_LIST[ FUZZY_SETS_NUMBER ] = { {-1, 0.2}, {-0.5, 0.2}, {0, 0.2}, {0.5, 0.2}, {1, 0.2} };
-                                                          
-const int INFERENCE_RULES[ FUZZY_SETS_NUMBER ][ FUZZY_SETS_NUMBER ] = 
-{
-  { POSITIVE_LOW, ZERO, NEGATIVE_LOW, NEGATIVE_LOW, NEGATIVE_HIGH },
-  { POSITIVE_LOW, ZERO, ZERO, NEGATIVE_LOW, NEGATIVE_HIGH },
-  { POSITIVE_HIGH, POSITIVE_LOW, ZERO, NEGATIVE_LOW, NEGATIVE_HIGH },
-  { POSITIVE_HIGH, POSITIVE_LOW, ZERO, ZERO, NEGATIVE_LOW },
-  { POSITIVE_HIGH, POSITIVE_LOW, POSITIVE_LOW, ZERO, NEGATIVE_LOW }
-};
 
-DEFINE_INTERFACE( CONTROL_FUNCTIONS )
+DECLARE_MODULE_INTERFACE( ROBOT_CONTROL_CONTEXT_INTERFACE );
+
 
-double* Run( double measuresList[ CONTROL_VARS_NUMBER ], double setpointsList[ CONTROL_VARS_NUMBER ], double deltaTime, double* ref_error )
+ControllerContext CreateController( const char* configurationString ) 
 {
-  static double outputsList[ CONTROL_VARS_NUMBER ];
+  double setsWidth = 0.2;
+  unsigned long tableResolution = 128;
   
-  double outputSetCutsList[ FUZZY_SETS_NUMBER ] = { 0 };
+  ControlData* controlData = (ControlData*) calloc( 1, sizeof(ControlData) );
+  if( controlData == NULL ) return NULL;
   
-  double positionError = ( setpointsList[ CONTROL_POSITION ] - measuresList[ CONTROL_POSITION ] ) / 0.3;
-  double forceError = ( setpointsList[ CONTROL_FORCE ] - measuresList[ CONTROL_FORCE ] ) / 5;
+  controlData->controlState = CONTROL_PASSIVE;
+  controlData->positionErrorScale = 0.3;
+  controlData->forceErrorScale = 5.0;
+  controlData->outputGain = 600.0;
   
-  for( size_t positionErrorSetIndex = 0; positionErrorSetIndex < FUZZY_SETS_NUMBER; positionErrorSetIndex++ )
+  if( configurationString != NULL ) 
+    sscanf( configurationString, "%lf %lf %lf %lf %lu", &(controlData->positionErrorScale), &(controlData->forceErrorScale), &(controlData->outputGain), &setsWidth, &tableResolution );
+  
+  if( controlData->positionErrorScale != 0.0 && controlData->forceErrorScale != 0.0 ) 
+    controlData->outputSurface = FuzzySurface_Create( setsWidth, (size_t) tableResolution );
+  
+  if( controlData->outputSurface == NULL )
   {
-    double medianPoint = FUZZY_SETS_LIST[ positionErrorSetIndex ].medianValue;
-    double variance = FUZZY_SETS_LIST[ positionErrorSetIndex ].variance;
-    double positionErrorInclusion = exp( -pow( positionError - medianPoint, 2 ) / ( 2 * pow( variance, 2 ) ) );
-    
-    for( size_t forceErrorSetIndex = 0; forceErrorSetIndex < FUZZY_SETS_NUMBER; forceErrorSetIndex++ )
-    {
-      medianPoint = FUZZY_SETS_LIST[ forceErrorSetIndex ].medianValue;
-      variance = FUZZY_SETS_LIST[ forceErrorSetIndex ].variance;
-      double forceErrorInclusion = exp( -pow( forceError - medianPoint, 2 ) / ( 2 * pow( variance, 2 ) ) );   
-        
-      double cutValue = ( positionErrorInclusion < forceErrorInclusion ) ? positionErrorInclusion : forceErrorInclusion;
-      size_t outputSetIndex = INFERENCE_RULES[ positionErrorSetIndex ][ forceErrorSetIndex ];
-      if( cutValue > outputSetCutsList[ outputSetIndex ] ) outputSetCutsList[ outputSetIndex ] = cutValue;
-    }
+    free( controlData );
+    return NULL;
   }
+  
+  return controlData; 
+}
 
-  double outputSum = 0.0;
-  double outputWeightedSum = 0.0;
-  for( double pointPosition = -1.0; pointPosition <= 1.0; pointPosition += DISCRETIZATION_INTERVAL )
-  {
-    double outputPointValue = 0.0;
+void DiscardController( ControllerContext context ) 
+{ 
+  ControlData* controlData = (ControlData*) context;
+  
+  FuzzySurface_Discard( controlData->outputSurface );
+  free( controlData );
+}
 
-    for( size_t outputSetIndex = 0; outputSetIndex < FUZZY_SETS_NUMBER; outputSetIndex++ )
-    {
-      double medianPoint = FUZZY_SETS_LIST[ outputSetIndex ].medianValue;
-      double variance = FUZZY_SETS_LIST[ outputSetIndex ].variance;
-      double outputInclusion = exp( -pow( pointPosition - medianPoint, 2 ) / ( 2 * pow( variance, 2 ) ) );   
-      
-      if( outputInclusion > outputSetCutsList[ outputSetIndex ] ) outputInclusion = outputSetCutsList[ outputSetIndex ];
+size_t GetControllerJointsNumber( ControllerContext context ) { return DOFS_NUMBER; }
+
+const char** GetControllerJointNamesList( ControllerContext context ) { return DOF_NAMES; }
+
+size_t GetControllerAxesNumber( ControllerContext context ) { return DOFS_NUMBER; }
+
+const char** GetControllerAxisNamesList( ControllerContext context ) { return DOF_NAMES; }
+
+size_t GetControllerExtraInputsNumber( ControllerContext context ) { return 0; }
       
-      if( outputPointValue < outputInclusion ) outputPointValue = outputInclusion;
-    }
-    
-    outputSum += outputPointValue;
-    outputWeightedSum += outputPointValue * pointPosition;
-  }
+void SetControllerExtraInputsList( ControllerContext context, double* inputsList ) { return; }
 
-  outputsList[ CONTROL_VELOCITY ] = -( outputWeightedSum / outputSum ) * 600;
+size_t GetControllerExtraOutputsNumber( ControllerContext context ) { return 0; }
+         
+void GetControllerExtraOutputsList( ControllerContext context, double* outputsList ) { return; }
+
+void SetControllerState( ControllerContext context, enum ControlState newControlState )
+{
+  ControlData* controlData = (ControlData*) context;
   
-  return (double*) outputsList;
+  controlData->controlState = newControlState;
+}
+
+void RunControllerStep( ControllerContext context, DoFVariables** jointMeasuresList, DoFVariables** axisMeasuresList, DoFVariables** jointSetpointsList, DoFVariables** axisSetpointsList, double timeDelta )
+{
+  ControlData* controlData = (ControlData*) context;
+  
+  *(axisMeasuresList[ 0 ]) = *(jointMeasuresList[ 0 ]);
+  
+  *(jointSetpointsList[ 0 ]) = *(axisSetpointsList[ 0 ]);
+  jointSetpointsList[ 0 ]->velocity = 0.0;
+  
+  if( controlData->controlState == CONTROL_OPERATION )
+  {
+    double positionError = ( axisSetpointsList[ 0 ]->position - axisMeasuresList[ 0 ]->position ) / controlData->positionErrorScale;
+    double forceError = ( axisSetpointsList[ 0 ]->force - axisMeasuresList[ 0 ]->force ) / controlData->forceErrorScale;
+    
+    jointSetpointsList[ 0 ]->velocity = -FuzzySurface_Evaluate( controlData->outputSurface, positionError, forceError ) * controlData->outputGain;
+  }
 }
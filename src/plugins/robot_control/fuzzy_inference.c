@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "fuzzy_inference.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+enum { NEGATIVE_HIGH, NEGATIVE_LOW, ZERO, POSITIVE_LOW, POSITIVE_HIGH, FUZZY_SETS_NUMBER };
+
+#define DISCRETIZATION_INTERVAL 0.01
+
+static const double FUZZY_SET_MEDIANS[ FUZZY_SETS_NUMBER ] = { -1.0, -0.5, 0.0, 0.5, 1.0 };
+                                                          
+static const int INFERENCE_RULES[ FUZZY_SETS_NUMBER ][ FUZZY_SETS_NUMBER ] = 
+{
+  { POSITIVE_LOW, ZERO, NEGATIVE_LOW, NEGATIVE_LOW, NEGATIVE_HIGH },
+  { POSITIVE_LOW, ZERO, ZERO, NEGATIVE_LOW, NEGATIVE_HIGH },
+  { POSITIVE_HIGH, POSITIVE_LOW, ZERO, NEGATIVE_LOW, NEGATIVE_HIGH },
+  { POSITIVE_HIGH, POSITIVE_LOW, ZERO, ZERO, NEGATIVE_LOW },
+  { POSITIVE_HIGH, POSITIVE_LOW, POSITIVE_LOW, ZERO, NEGATIVE_LOW }
+};
+
+struct _FuzzySurfaceData
+{
+  double* valuesTable;
+  size_t resolution;
+  double gridScale;
+};
+
+
+double FuzzyInference_Evaluate( double setsWidth, double positionError, double forceError )
+{
+  double outputSetCutsList[ FUZZY_SETS_NUMBER ] = { 0 };
+  
+  double variance = setsWidth * setsWidth;
+  
+  for( size_t positionErrorSetIndex = 0; positionErrorSetIndex < FUZZY_SETS_NUMBER; positionErrorSetIndex++ )
+  {
+    double medianPoint = FUZZY_SET_MEDIANS[ positionErrorSetIndex ];
+    double positionErrorInclusion = exp( -pow( positionError - medianPoint, 2 ) / ( 2 * variance ) );
+    
+    for( size_t forceErrorSetIndex = 0; forceErrorSetIndex < FUZZY_SETS_NUMBER; forceErrorSetIndex++ )
+    {
+      medianPoint = FUZZY_SET_MEDIANS[ forceErrorSetIndex ];
+      double forceErrorInclusion = exp( -pow( forceError - medianPoint, 2 ) / ( 2 * variance ) );   
+        
+      double cutValue = ( positionErrorInclusion < forceErrorInclusion ) ? positionErrorInclusion : forceErrorInclusion;
+      size_t outputSetIndex = INFERENCE_RULES[ positionErrorSetIndex ][ forceErrorSetIndex ];
+      if( cutValue > outputSetCutsList[ outputSetIndex ] ) outputSetCutsList[ outputSetIndex ] = cutValue;
+    }
+  }
+
+  double outputSum = 0.0;
+  double outputWeightedSum = 0.0;
+  for( double pointPosition = -1.0; pointPosition <= 1.0; pointPosition += DISCRETIZATION_INTERVAL )
+  {
+    double outputPointValue = 0.0;
+
+    for( size_t outputSetIndex = 0; outputSetIndex < FUZZY_SETS_NUMBER; outputSetIndex++ )
+    {
+      double medianPoint = FUZZY_SET_MEDIANS[ outputSetIndex ];
+      double outputInclusion = exp( -pow( pointPosition - medianPoint, 2 ) / ( 2 * variance ) );   
+      
+      if( outputInclusion > outputSetCutsList[ outputSetIndex ] ) outputInclusion = outputSetCutsList[ outputSetIndex ];
+      
+      if( outputPointValue < outputInclusion ) outputPointValue = outputInclusion;
+    }
+    
+    outputSum += outputPointValue;
+    outputWeightedSum += outputPointValue * pointPosition;
+  }
+  
+  if( outputSum <= 0.0 ) return 0.0;
+  
+  return outputWeightedSum / outputSum;
+}
+
+FuzzySurface FuzzySurface_Create( double setsWidth, size_t resolution )
+{
+  if( resolution < 2 || !( setsWidth > 0.0 ) ) return NULL;
+  
+  FuzzySurface newSurface = (FuzzySurface) malloc( sizeof(FuzzySurfaceData) );
+  
+  newSurface->resolution = resolution;
+  newSurface->gridScale = ( resolution - 1 ) / ( 2 * FUZZY_INPUT_LIMIT );
+  newSurface->valuesTable = (double*) calloc( resolution * resolution, sizeof(double) );
+  
+  // Table is row-major on position error
+  for( size_t positionIndex = 0; positionIndex < resolution; positionIndex++ )
+  {
+    double positionError = positionIndex / newSurface->gridScale - FUZZY_INPUT_LIMIT;
+    for( size_t forceIndex = 0; forceIndex < resolution; forceIndex++ )
+    {
+      double forceError = forceIndex / newSurface->gridScale - FUZZY_INPUT_LIMIT;
+      newSurface->valuesTable[ positionIndex * resolution + forceIndex ] = FuzzyInference_Evaluate( setsWidth, positionError, forceError );
+    }
+  }
+  
+  return newSurface;
+}
+
+void FuzzySurface_Discard( FuzzySurface surface )
+{
+  if( surface == NULL ) return;
+  
+  free( surface->valuesTable );
+  
+  free( surface );
+}
+
+double FuzzySurface_Evaluate( FuzzySurface surface, double positionError, double forceError )
+{
+  if( surface == NULL ) return 0.0;
+  
+  // Continuous grid coordinates, clamped so that the upper cell corner is always inside table
+  double maxCoordinate = surface->resolution - 1.000001;
+  double positionCoordinate = ( positionError + FUZZY_INPUT_LIMIT ) * surface->gridScale;
+  double forceCoordinate = ( forceError + FUZZY_INPUT_LIMIT ) * surface->gridScale;
+  positionCoordinate = ( positionCoordinate < 0.0 ) ? 0.0 : ( ( positionCoordinate > maxCoordinate ) ? maxCoordinate : positionCoordinate );
+  forceCoordinate = ( forceCoordinate < 0.0 ) ? 0.0 : ( ( forceCoordinate > maxCoordinate ) ? maxCoordinate : forceCoordinate );
+  
+  size_t positionIndex = (size_t) positionCoordinate;
+  size_t forceIndex = (size_t) forceCoordinate;
+  double positionFraction = positionCoordinate - positionIndex;
+  double forceFraction = forceCoordinate - forceIndex;
+  
+  const double* lowerRow = surface->valuesTable + positionIndex * surface->resolution + forceIndex;
+  const double* upperRow = lowerRow + surface->resolution;
+  
+  double lowerValue = lowerRow[ 0 ] + forceFraction * ( lowerRow[ 1 ] - lowerRow[ 0 ] );
+  double upperValue = upperRow[ 0 ] + forceFraction * ( upperRow[ 1 ] - upperRow[ 0 ] );
+  
+  return lowerValue + positionFraction * ( upperValue - lowerValue );
+}
@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file fuzzy_inference.h
+/// @brief Fuzzy force controller inference functions
+///
+/// Mamdani inference over normalized position and force errors (5 Gaussian sets each, min-max rules and centroid defuzzification).
+/// Besides the direct computation, the whole 2-D output surface may be precomputed, and then evaluated by bilinear interpolation
+
+#ifndef FUZZY_INFERENCE_H
+#define FUZZY_INFERENCE_H
+
+#include <stddef.h>
+
+#define FUZZY_INPUT_LIMIT 2.0     ///< Normalized inputs are clamped to [-FUZZY_INPUT_LIMIT,FUZZY_INPUT_LIMIT] on surface evaluation
+
+typedef struct _FuzzySurfaceData FuzzySurfaceData;      ///< Single fuzzy output surface internal data structure
+typedef FuzzySurfaceData* FuzzySurface;                 ///< Opaque reference to fuzzy output surface
+
+/// @brief Computes fuzzy controller output directly from (normalized) inputs
+/// @param[in] setsWidth standard deviation of all Gaussian membership functions
+/// @param[in] positionError normalized position error
+/// @param[in] forceError normalized force error
+/// @return normalized controller output (in [-1,1] range)
+double FuzzyInference_Evaluate( double setsWidth, double positionError, double forceError );
+
+/// @brief Creates output surface table, sampling direct computation on evenly spaced grid
+/// @param[in] setsWidth standard deviation of all Gaussian membership functions
+/// @param[in] resolution number of grid points along each input dimension (at least 2)
+/// @return reference to created surface (NULL on errors)
+FuzzySurface FuzzySurface_Create( double setsWidth, size_t resolution );
+
+/// @brief Deallocates internal data of given surface
+/// @param[in] surface reference to surface
+void FuzzySurface_Discard( FuzzySurface surface );
+
+/// @brief Computes fuzzy controller output through bilinear interpolation of the surface table
+/// @param[in] surface reference to surface
+/// @param[in] positionError normalized position error
+/// @param[in] forceError normalized force error
+/// @return normalized controller output (in [-1,1] range)
+double FuzzySurface_Evaluate( FuzzySurface surface, double positionError, double forceError );
+
+#endif // FUZZY_INFERENCE_H
@@ -0,0 +1,460 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file impedance_control.c
+/// @brief Generic N-axis impedance/admittance controller
+///
+/// Axis variables are linear combinations of joint ones, x = C * q, for a constant coupling matrix C (identity by default). Stiffness, damping and inertia 
+/// of each axis are taken from its setpoints. On impedance mode, axis forces f = f_d + K * (x_d - x) + D * (v_d - v) + M * a_d are sent to joints as
+/// torques C^T * f. On admittance mode, measured interaction forces drive a virtual mass-spring-damper (integrated by implicit Euler, so that null inertia
+/// is allowed), whose motion gives joint position/velocity setpoints through the coupling pseudo-inverse C^+.
+/// Configuration string: "<impedance|admittance> <joints_number> [<axes_number> <C_11> <C_12> ... <C_mn>]", with coupling matrix given in row-major order
+/// (e.g. "impedance 3", "admittance 2 2 0.5 0.5 1.0 -1.0")
+/// Control laws are computed in Scalar precision (see scalar.h), over arrays padded to whole vector registers, while the coupling pseudo-inverse is always found in double precision
+
+#include "robot_control/robot_control.h"
+#include "robot_control_extensions.h"
+
+#include "scalar.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define DOFS_MAX_NUMBER 256
+
+static const Scalar MIN_ADMITTANCE_DENOMINATOR = 1e-9;
+static const double MIN_COUPLING_PIVOT = 1e-12;
+
+enum DoFVariable { POSITION, VELOCITY, ACCELERATION, FORCE, STIFFNESS, DAMPING, INERTIA, VARIABLES_NUMBER };
+
+// Variables are stored as contiguous (per variable) arrays, so that each control law term is computed by a single vectorizable loop
+typedef struct _ControlData
+{
+  bool isAdmittance;
+  size_t jointsNumber, axesNumber;
+  size_t paddedAxesNumber;                      // Length of per axis arrays (extra elements are kept at 0)
+  Scalar* couplingMatrix;                       // [ axes x joints ] (NULL for identity)
+  Scalar* couplingInverse;                      // [ joints x axes ] pseudo-inverse
+  Scalar* jointMeasuresList[ VARIABLES_NUMBER ];
+  Scalar* axisMeasuresList[ VARIABLES_NUMBER ];
+  Scalar* axisSetpointsList[ VARIABLES_NUMBER ];
+  Scalar* axisForcesList;
+  Scalar* referencePositionsList;               // Admittance virtual dynamics state
+  Scalar* referenceVelocitiesList;
+  Scalar* jointOutputsList;
+  char jointNamesData[ DOFS_MAX_NUMBER ][ 16 ];
+  char axisNamesData[ DOFS_MAX_NUMBER ][ 16 ];
+  const char* jointNamesList[ DOFS_MAX_NUMBER ];
+  const char* axisNamesList[ DOFS_MAX_NUMBER ];
+  enum ControlState state;
+  bool isReferenceReset;
+}
+ControlData;
+
+
+DECLARE_MODULE_INTERFACE( ROBOT_CONTROL_CONTEXT_INTERFACE );
+
+
+// Pseudo-inverse by Gauss-Jordan elimination of the smaller Gram matrix: C^T * (C * C^T)^-1 or (C^T * C)^-1 * C^T
+static bool InvertCoupling( const double* coupling, size_t rowsNumber, size_t columnsNumber, double* inverse )
+{
+  bool useRows = ( rowsNumber <= columnsNumber );
+  size_t size = useRows ? rowsNumber : columnsNumber;
+  double* augmentedMatrix = (double*) calloc( size * 2 * size, sizeof(double) );
+  for( size_t i = 0; i < size; i++ )
+  {
+    for( size_t j = 0; j < size; j++ )
+    {
+      double sum = 0.0;
+      for( size_t k = 0; k < ( useRows ? columnsNumber : rowsNumber ); k++ )
+        sum += useRows ? coupling[ i * columnsNumber + k ] * coupling[ j * columnsNumber + k ] : coupling[ k * columnsNumber + i ] * coupling[ k * columnsNumber + j ];
+      augmentedMatrix[ i * 2 * size + j ] = sum;
+    }
+    augmentedMatrix[ i * 2 * size + size + i ] = 1.0;
+  }
+  
+  bool isInvertible = true;
+  for( size_t j = 0; j < size && isInvertible; j++ )
+  {
+    size_t pivotRow = j;
+    for( size_t i = j + 1; i < size; i++ )
+    {
+      if( fabs( augmentedMatrix[ i * 2 * size + j ] ) > fabs( augmentedMatrix[ pivotRow * 2 * size + j ] ) ) pivotRow = i;
+    }
+    if( fabs( augmentedMatrix[ pivotRow * 2 * size + j ] ) < MIN_COUPLING_PIVOT ) isInvertible = false;
+    else
+    {
+      for( size_t k = 0; k < 2 * size; k++ )
+      {
+        double swapValue = augmentedMatrix[ j * 2 * size + k ];
+        augmentedMatrix[ j * 2 * size + k ] = augmentedMatrix[ pivotRow * 2 * size + k ];
+        augmentedMatrix[ pivotRow * 2 * size + k ] = swapValue;
+      }
+      double pivot = augmentedMatrix[ j * 2 * size + j ];
+      for( size_t k = 0; k < 2 * size; k++ )
+        augmentedMatrix[ j * 2 * size + k ] /= pivot;
+      for( size_t i = 0; i < size; i++ )
+      {
+        double factor = augmentedMatrix[ i * 2 * size + j ];
+        if( i == j || factor == 0.0 ) continue;
+        for( size_t k = 0; k < 2 * size; k++ )
+          augmentedMatrix[ i * 2 * size + k ] -= factor * augmentedMatrix[ j * 2 * size + k ];
+      }
+    }
+  }
+  
+  if( isInvertible )
+  {
+    for( size_t i = 0; i < columnsNumber; i++ )
+    {
+      for( size_t j = 0; j < rowsNumber; j++ )
+      {
+        double sum = 0.0;
+        for( size_t k = 0; k < size; k++ )
+        {
+          if( useRows ) sum += coupling[ k * columnsNumber + i ] * augmentedMatrix[ k * 2 * size + size + j ];
+          else sum += augmentedMatrix[ i * 2 * size + size + k ] * coupling[ j * columnsNumber + k ];
+        }
+        inverse[ i * rowsNumber + j ] = sum;
+      }
+    }
+  }
+  
+  free( augmentedMatrix );
+  
+  return isInvertible;
+}
+
+// output = matrix * input, for [ rows x columns ] matrix (or identity copy, for NULL matrix)
+static inline void Multiply( const Scalar* restrict matrix, const Scalar* restrict input, size_t rowsNumber, size_t columnsNumber, Scalar* restrict output )
+{
+  if( matrix == NULL )
+  {
+    memcpy( output, input, rowsNumber * sizeof(Scalar) );
+    return;
+  }
+  
+  for( size_t i = 0; i < rowsNumber; i++ )
+  {
+    Scalar sum = 0;
+    for( size_t j = 0; j < columnsNumber; j++ )
+      sum += matrix[ i * columnsNumber + j ] * input[ j ];
+    output[ i ] = sum;
+  }
+}
+
+// output = matrix^T * input, for [ rows x columns ] matrix (or identity copy, for NULL matrix)
+static inline void MultiplyTransposed( const Scalar* restrict matrix, const Scalar* restrict input, size_t rowsNumber, size_t columnsNumber, Scalar* restrict output )
+{
+  if( matrix == NULL )
+  {
+    memcpy( output, input, columnsNumber * sizeof(Scalar) );
+    return;
+  }
+  
+  memset( output, 0, columnsNumber * sizeof(Scalar) );
+  for( size_t i = 0; i < rowsNumber; i++ )
+  {
+    for( size_t j = 0; j < columnsNumber; j++ )
+      output[ j ] += matrix[ i * columnsNumber + j ] * input[ i ];
+  }
+}
+
+static bool LoadConfiguration( ControlData* controlData, const char* configurationString )
+{
+  if( configurationString == NULL ) return false;
+  
+  char modeName[ 16 ] = "";
+  int readCharsNumber = 0;
+  unsigned long jointsNumber = 0, axesNumber = 0;
+  if( sscanf( configurationString, "%15s %lu%n", modeName, &jointsNumber, &readCharsNumber ) < 2 ) return false;
+  if( strcmp( modeName, "admittance" ) == 0 ) controlData->isAdmittance = true;
+  else if( strcmp( modeName, "impedance" ) != 0 ) return false;
+  if( jointsNumber == 0 || jointsNumber > DOFS_MAX_NUMBER ) return false;
+  
+  const char* parameterString = configurationString + readCharsNumber;
+  char* parameterEnd;
+  axesNumber = strtoul( parameterString, &parameterEnd, 10 );
+  if( parameterEnd == parameterString ) axesNumber = jointsNumber;
+  if( axesNumber == 0 || axesNumber > DOFS_MAX_NUMBER ) return false;
+  
+  controlData->jointsNumber = (size_t) jointsNumber;
+  controlData->axesNumber = (size_t) axesNumber;
+  controlData->paddedAxesNumber = SCALAR_PADDED_LENGTH( controlData->axesNumber );
+  
+  // Coupling matrix (optional if axes number is equal to joints number)
+  if( parameterEnd != parameterString )
+  {
+    double* couplingValues = (double*) calloc( 2 * axesNumber * jointsNumber, sizeof(double) );
+    double* inverseValues = couplingValues + axesNumber * jointsNumber;
+    for( size_t elementIndex = 0; elementIndex < axesNumber * jointsNumber; elementIndex++ )
+    {
+      parameterString = parameterEnd;
+      couplingValues[ elementIndex ] = strtod( parameterString, &parameterEnd );
+      if( parameterEnd == parameterString ) break;
+    }
+    if( parameterEnd != parameterString )
+    {
+      if( !InvertCoupling( couplingValues, axesNumber, jointsNumber, inverseValues ) )
+      {
+        fprintf( stderr, "impedance control: singular coupling matrix\n" );
+        free( couplingValues );
+        return false;
+      }
+      controlData->couplingMatrix = (Scalar*) calloc( axesNumber * jointsNumber, sizeof(Scalar) );
+      controlData->couplingInverse = (Scalar*) calloc( jointsNumber * axesNumber, sizeof(Scalar) );
+      for( size_t elementIndex = 0; elementIndex < axesNumber * jointsNumber; elementIndex++ )
+      {
+        controlData->couplingMatrix[ elementIndex ] = (Scalar) couplingValues[ elementIndex ];
+        controlData->couplingInverse[ elementIndex ] = (Scalar) inverseValues[ elementIndex ];
+      }
+    }
+    free( couplingValues );
+    if( controlData->couplingMatrix == NULL && axesNumber != jointsNumber ) return false;
+  }
+  
+  size_t paddedJointsNumber = SCALAR_PADDED_LENGTH( controlData->jointsNumber );
+  size_t paddedAxesNumber = controlData->paddedAxesNumber;
+  for( size_t variableIndex = 0; variableIndex < VARIABLES_NUMBER; variableIndex++ )
+  {
+    controlData->jointMeasuresList[ variableIndex ] = (Scalar*) calloc( paddedJointsNumber, sizeof(Scalar) );
+    controlData->axisMeasuresList[ variableIndex ] = (Scalar*) calloc( paddedAxesNumber, sizeof(Scalar) );
+    controlData->axisSetpointsList[ variableIndex ] = (Scalar*) calloc( paddedAxesNumber, sizeof(Scalar) );
+  }
+  controlData->axisForcesList = (Scalar*) calloc( paddedAxesNumber, sizeof(Scalar) );
+  controlData->referencePositionsList = (Scalar*) calloc( paddedAxesNumber, sizeof(Scalar) );
+  controlData->referenceVelocitiesList = (Scalar*) calloc( paddedAxesNumber, sizeof(Scalar) );
+  controlData->jointOutputsList = (Scalar*) calloc( paddedJointsNumber, sizeof(Scalar) );
+  
+  for( size_t jointIndex = 0; jointIndex < jointsNumber; jointIndex++ )
+  {
+    snprintf( controlData->jointNamesData[ jointIndex ], 16, "joint%lu", jointIndex + 1 );
+    controlData->jointNamesList[ jointIndex ] = controlData->jointNamesData[ jointIndex ];
+  }
+  for( size_t axisIndex = 0; axisIndex < axesNumber; axisIndex++ )
+  {
+    snprintf( controlData->axisNamesData[ axisIndex ], 16, "axis%lu", axisIndex + 1 );
+    controlData->axisNamesList[ axisIndex ] = controlData->axisNamesData[ axisIndex ];
+  }
+  
+  controlData->state = CONTROL_PASSIVE;
+  controlData->isReferenceReset = true;
+  
+  return true;
+}
+
+ControllerContext CreateController( const char* configurationString )
+{
+  ControlData* controlData = (ControlData*) calloc( 1, sizeof(ControlData) );
+  if( controlData == NULL ) return NULL;
+  
+  if( !LoadConfiguration( controlData, configurationString ) )
+  {
+    DiscardController( controlData );
+    return NULL;
+  }
+  
+  return controlData;
+}
+
+void DiscardController( ControllerContext context )
+{
+  ControlData* controlData = (ControlData*) context;
+  
+  for( size_t variableIndex = 0; variableIndex < VARIABLES_NUMBER; variableIndex++ )
+  {
+    free( controlData->jointMeasuresList[ variableIndex ] );
+    free( controlData->axisMeasuresList[ variableIndex ] );
+    free( controlData->axisSetpointsList[ variableIndex ] );
+  }
+  free( controlData->couplingMatrix );
+  free( controlData->couplingInverse );
+  free( controlData->axisForcesList );
+  free( controlData->referencePositionsList );
+  free( controlData->referenceVelocitiesList );
+  free( controlData->jointOutputsList );
+  
+  free( controlData );
+}
+
+size_t GetControllerJointsNumber( ControllerContext context ) { return ((ControlData*) context)->jointsNumber; }
+
+const char** GetControllerJointNamesList( ControllerContext context ) { return ((ControlData*) context)->jointNamesList; }
+
+size_t GetControllerAxesNumber( ControllerContext context ) { return ((ControlData*) context)->axesNumber; }
+
+const char** GetControllerAxisNamesList( ControllerContext context ) { return ((ControlData*) context)->axisNamesList; }
+
+size_t GetControllerExtraInputsNumber( ControllerContext context ) { return 0; }
+      
+void SetControllerExtraInputsList( ControllerContext context, double* inputsList ) { return; }
+
+size_t GetControllerExtraOutputsNumber( ControllerContext context ) { return 0; }
+         
+void GetControllerExtraOutputsList( ControllerContext context, double* outputsList ) { return; }
+
+void SetControllerState( ControllerContext context, enum ControlState newControlState )
+{
+  ControlData* controlData = (ControlData*) context;
+  
+  fprintf( stderr, "Setting robot control phase: %x\n", newControlState );
+  
+  controlData->state = newControlState;
+  controlData->isReferenceReset = true;
+}
+
+static void GatherVariables( DoFVariables** variablesList, size_t dofsNumber, Scalar** valuesList )
+{
+  for( size_t dofIndex = 0; dofIndex < dofsNumber; dofIndex++ )
+  {
+    const DoFVariables* variables = variablesList[ dofIndex ];
+    valuesList[ POSITION ][ dofIndex ] = (Scalar) variables->position;
+    valuesList[ VELOCITY ][ dofIndex ] = (Scalar) variables->velocity;
+    valuesList[ ACCELERATION ][ dofIndex ] = (Scalar) variables->acceleration;
+    valuesList[ FORCE ][ dofIndex ] = (Scalar) variables->force;
+    valuesList[ STIFFNESS ][ dofIndex ] = (Scalar) variables->stiffness;
+    valuesList[ DAMPING ][ dofIndex ] = (Scalar) variables->damping;
+    valuesList[ INERTIA ][ dofIndex ] = (Scalar) variables->inertia;
+  }
+}
+
+void RunControllerStep( ControllerContext context, DoFVariables** jointMeasuresList, DoFVariables** axisMeasuresList, DoFVariables** jointSetpointsList, DoFVariables** axisSetpointsList, double timeDelta )
+{
+  ControlData* controlData = (ControlData*) context;
+  
+  size_t jointsNumber = controlData->jointsNumber, axesNumber = controlData->axesNumber;
+  size_t paddedAxesNumber = controlData->paddedAxesNumber;
+  const Scalar* coupling = controlData->couplingMatrix;
+  const Scalar* couplingInverse = controlData->couplingInverse;
+  Scalar** jointValuesList = controlData->jointMeasuresList;
+  Scalar** axisValuesList = controlData->axisMeasuresList;
+  Scalar** setpointValuesList = controlData->axisSetpointsList;
+  Scalar stepTime = (Scalar) timeDelta;
+  
+  // Axis measures: x = C * q (kinematic variables), f = C^+T * tau (forces)
+  GatherVariables( jointMeasuresList, jointsNumber, jointValuesList );
+  Multiply( coupling, jointValuesList[ POSITION ], axesNumber, jointsNumber, axisValuesList[ POSITION ] );
+  Multiply( coupling, jointValuesList[ VELOCITY ], axesNumber, jointsNumber, axisValuesList[ VELOCITY ] );
+  Multiply( coupling, jointValuesList[ ACCELERATION ], axesNumber, jointsNumber, axisValuesList[ ACCELERATION ] );
+  MultiplyTransposed( couplingInverse, jointValuesList[ FORCE ], jointsNumber, axesNumber, axisValuesList[ FORCE ] );
+  for( size_t axisIndex = 0; axisIndex < axesNumber; axisIndex++ )
+  {
+    axisMeasuresList[ axisIndex ]->position = axisValuesList[ POSITION ][ axisIndex ];
+    axisMeasuresList[ axisIndex ]->velocity = axisValuesList[ VELOCITY ][ axisIndex ];
+    axisMeasuresList[ axisIndex ]->acceleration = axisValuesList[ ACCELERATION ][ axisIndex ];
+    axisMeasuresList[ axisIndex ]->force = axisValuesList[ FORCE ][ axisIndex ];
+  }
+  
+  GatherVariables( axisSetpointsList, axesNumber, setpointValuesList );
+  
+  const Scalar* restrict setpointPositions = setpointValuesList[ POSITION ];
+  const Scalar* restrict setpointVelocities = setpointValuesList[ VELOCITY ];
+  const Scalar* restrict stiffnesses = setpointValuesList[ STIFFNESS ];
+  const Scalar* restrict dampings = setpointValuesList[ DAMPING ];
+  const Scalar* restrict inertias = setpointValuesList[ INERTIA ];
+  Scalar* restrict axisForces = controlData->axisForcesList;
+  
+  if( controlData->isReferenceReset )
+  {
+    memcpy( controlData->referencePositionsList, axisValuesList[ POSITION ], axesNumber * sizeof(Scalar) );
+    memcpy( controlData->referenceVelocitiesList, axisValuesList[ VELOCITY ], axesNumber * sizeof(Scalar) );
+    controlData->isReferenceReset = false;
+  }
+  
+  // Reference motion and forces follow measures outside operation
+  const Scalar* restrict targetPositions = axisValuesList[ POSITION ];
+  const Scalar* restrict targetVelocities = axisValuesList[ VELOCITY ];
+  memset( axisForces, 0, paddedAxesNumber * sizeof(Scalar) );
+  if( controlData->state == CONTROL_OPERATION )
+  {
+    const Scalar* restrict measuredPositions = axisValuesList[ POSITION ];
+    const Scalar* restrict measuredVelocities = axisValuesList[ VELOCITY ];
+    const Scalar* restrict setpointAccelerations = setpointValuesList[ ACCELERATION ];
+    const Scalar* restrict setpointForces = setpointValuesList[ FORCE ];
+    
+    // Control law loops run over padded arrays (zeroed extra elements give null outputs), with no remainder iterations
+    if( controlData->isAdmittance )
+    {
+      // M * dv/dt = f + f_d - D * ( v - v_d ) - K * ( x - x_d ), implicit on v and x
+      const Scalar* restrict measuredForces = axisValuesList[ FORCE ];
+      Scalar* restrict referencePositions = controlData->referencePositionsList;
+      Scalar* restrict referenceVelocities = controlData->referenceVelocitiesList;
+      for( size_t axisIndex = 0; axisIndex < paddedAxesNumber; axisIndex++ )
+      {
+        Scalar denominator = inertias[ axisIndex ] + stepTime * ( dampings[ axisIndex ] + stepTime * stiffnesses[ axisIndex ] );
+        Scalar impulse = inertias[ axisIndex ] * referenceVelocities[ axisIndex ] + stepTime * ( measuredForces[ axisIndex ] + setpointForces[ axisIndex ] 
+                         + dampings[ axisIndex ] * setpointVelocities[ axisIndex ] - stiffnesses[ axisIndex ] * ( referencePositions[ axisIndex ] - setpointPositions[ axisIndex ] ) );
+        bool isRigid = ( denominator < MIN_ADMITTANCE_DENOMINATOR );
+        referenceVelocities[ axisIndex ] = isRigid ? setpointVelocities[ axisIndex ] : impulse / denominator;
+        referencePositions[ axisIndex ] = isRigid ? setpointPositions[ axisIndex ] : referencePositions[ axisIndex ] + stepTime * referenceVelocities[ axisIndex ];
+        axisForces[ axisIndex ] = setpointForces[ axisIndex ];
+      }
+      targetPositions = referencePositions;
+      targetVelocities = referenceVelocities;
+    }
+    else
+    {
+      // f = f_d + K * ( x_d - x ) + D * ( v_d - v ) + M * a_d
+      for( size_t axisIndex = 0; axisIndex < paddedAxesNumber; axisIndex++ )
+      {
+        axisForces[ axisIndex ] = setpointForces[ axisIndex ] + stiffnesses[ axisIndex ] * ( setpointPositions[ axisIndex ] - measuredPositions[ axisIndex ] )
+                                  + dampings[ axisIndex ] * ( setpointVelocities[ axisIndex ] - measuredVelocities[ axisIndex ] ) + inertias[ axisIndex ] * setpointAccelerations[ axisIndex ];
+      }
+      targetPositions = setpointPositions;
+      targetVelocities = setpointVelocities;
+    }
+  }
+
+  for( size_t axisIndex = 0; axisIndex < axesNumber; axisIndex++ )
+    axisSetpointsList[ axisIndex ]->force = axisForces[ axisIndex ];
+  
+  // Joint setpoints: q = C^+ * x, tau = C^T * f
+  Scalar* jointOutputs = controlData->jointOutputsList;
+  Multiply( couplingInverse, targetPositions, jointsNumber, axesNumber, jointOutputs );
+  for( size_t jointIndex = 0; jointIndex < jointsNumber; jointIndex++ )
+    jointSetpointsList[ jointIndex ]->position = jointOutputs[ jointIndex ];
+  Multiply( couplingInverse, targetVelocities, jointsNumber, axesNumber, jointOutputs );
+  for( size_t jointIndex = 0; jointIndex < jointsNumber; jointIndex++ )
+    jointSetpointsList[ jointIndex ]->velocity = jointOutputs[ jointIndex ];
+  MultiplyTransposed( coupling, axisForces, axesNumber, jointsNumber, jointOutputs );
+  for( size_t jointIndex = 0; jointIndex < jointsNumber; jointIndex++ )
+    jointSetpointsList[ jointIndex ]->force = jointOutputs[ jointIndex ];
+  
+  // Joint impedance (for inner loops): diag( C^T * K * C )
+  for( size_t jointIndex = 0; jointIndex < jointsNumber; jointIndex++ )
+  {
+    Scalar stiffness = 0, damping = 0, inertia = 0;
+    for( size_t axisIndex = 0; axisIndex < axesNumber; axisIndex++ )
+    {
+      Scalar couplingElement = ( coupling != NULL ) ? coupling[ axisIndex * jointsNumber + jointIndex ] : ( axisIndex == jointIndex );
+      Scalar squaredCoupling = couplingElement * couplingElement;
+      stiffness += squaredCoupling * stiffnesses[ axisIndex ];
+      damping += squaredCoupling * dampings[ axisIndex ];
+      inertia += squaredCoupling * inertias[ axisIndex ];
+    }
+    jointSetpointsList[ jointIndex ]->stiffness = stiffness;
+    jointSetpointsList[ jointIndex ]->damping = damping;
+    jointSetpointsList[ jointIndex ]->inertia = inertia;
+  }
+}
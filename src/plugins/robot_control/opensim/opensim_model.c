@@ -0,0 +1,1135 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "opensim_model.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+#define MAX_JOINT_AXES_NUMBER 6       // 3 rotations and 3 translations (custom joint spatial transform)
+#define MIN_CHOLESKY_PIVOT 1e-12
+
+/////////////////////////////////////////////////////////////////////////////////
+/////                          MINIMAL XML PARSING                          /////
+/////////////////////////////////////////////////////////////////////////////////
+
+// In-place (file buffer) element tree. Attributes other than "name" are ignored
+typedef struct _XMLNode
+{
+  char* tag;
+  char* name;
+  char* text;
+  struct _XMLNode* firstChild;
+  struct _XMLNode* lastChild;
+  struct _XMLNode* nextSibling;
+}
+XMLNode;
+
+static void DiscardXMLNode( XMLNode* node )
+{
+  while( node != NULL )
+  {
+    XMLNode* nextNode = node->nextSibling;
+    DiscardXMLNode( node->firstChild );
+    free( node );
+    node = nextNode;
+  }
+}
+
+static char* TrimText( char* text )
+{
+  while( isspace( (unsigned char) *text ) ) text++;
+  char* textEnd = text + strlen( text );
+  while( textEnd > text && isspace( (unsigned char) *(textEnd - 1) ) ) *(--textEnd) = '\0';
+  return text;
+}
+
+static XMLNode* ParseXML( char* buffer )
+{
+  XMLNode* root = (XMLNode*) calloc( 1, sizeof(XMLNode) );
+  XMLNode* nodesStack[ 128 ] = { root };
+  size_t depth = 0;
+  
+  char* cursor = buffer;
+  while( (cursor = strchr( cursor, '<' )) != NULL )
+  {
+    *(cursor++) = '\0';
+    if( *cursor == '?' || *cursor == '!' )     // Declarations and comments
+    {
+      char* tagEnd = ( strncmp( cursor, "!--", 3 ) == 0 ) ? strstr( cursor, "-->" ) : strchr( cursor, '>' );
+      if( tagEnd == NULL ) break;
+      cursor = tagEnd + 1;
+    }
+    else if( *cursor == '/' )                  // Closing tag
+    {
+      char* tagEnd = strchr( cursor, '>' );
+      if( tagEnd == NULL || depth == 0 ) break;
+      depth--;
+      cursor = tagEnd + 1;
+    }
+    else                                       // Opening (or empty element) tag
+    {
+      char* tagEnd = strchr( cursor, '>' );
+      if( tagEnd == NULL ) break;
+      *tagEnd = '\0';
+      bool isEmpty = ( tagEnd > cursor && *(tagEnd - 1) == '/' );
+      if( isEmpty ) *(tagEnd - 1) = '\0';
+      
+      XMLNode* newNode = (XMLNode*) calloc( 1, sizeof(XMLNode) );
+      newNode->tag = cursor;
+      cursor += strcspn( cursor, " \t\r\n" );
+      if( *cursor != '\0' )
+      {
+        *(cursor++) = '\0';
+        char* nameAttribute = strstr( cursor, "name=\"" );
+        if( nameAttribute != NULL )
+        {
+          newNode->name = nameAttribute + strlen( "name=\"" );
+          char* nameEnd = strchr( newNode->name, '"' );
+          if( nameEnd != NULL ) *nameEnd = '\0';
+        }
+      }
+      
+      XMLNode* parent = nodesStack[ depth ];
+      if( parent->lastChild != NULL ) parent->lastChild->nextSibling = newNode;
+      else parent->firstChild = newNode;
+      parent->lastChild = newNode;
+      
+      cursor = tagEnd + 1;
+      if( !isEmpty )
+      {
+        if( depth + 1 >= sizeof(nodesStack) / sizeof(XMLNode*) ) break;
+        nodesStack[ ++depth ] = newNode;
+        newNode->text = cursor;     // Text until next tag (null terminated on next iteration)
+      }
+    }
+  }
+  
+  return root;
+}
+
+static XMLNode* GetChild( XMLNode* node, const char* tag )
+{
+  if( node == NULL ) return NULL;
+  for( XMLNode* child = node->firstChild; child != NULL; child = child->nextSibling )
+  {
+    if( strcmp( child->tag, tag ) == 0 ) return child;
+  }
+  return NULL;
+}
+
+static XMLNode* FindDescendant( XMLNode* node, const char* tag )
+{
+  if( node == NULL ) return NULL;
+  for( XMLNode* child = node->firstChild; child != NULL; child = child->nextSibling )
+  {
+    if( strcmp( child->tag, tag ) == 0 ) return child;
+    XMLNode* descendant = FindDescendant( child, tag );
+    if( descendant != NULL ) return descendant;
+  }
+  return NULL;
+}
+
+static const char* GetChildText( XMLNode* node, const char* tag )
+{
+  XMLNode* child = GetChild( node, tag );
+  if( child == NULL || child->text == NULL ) return "";
+  return TrimText( child->text );
+}
+
+static size_t GetChildValues( XMLNode* node, const char* tag, double* valuesList, size_t maxValuesNumber )
+{
+  const char* text = GetChildText( node, tag );
+  size_t valuesNumber = 0;
+  while( valuesNumber < maxValuesNumber )
+  {
+    char* valueEnd;
+    double value = strtod( text, &valueEnd );
+    if( valueEnd == text ) break;
+    valuesList[ valuesNumber++ ] = value;
+    text = valueEnd;
+  }
+  return valuesNumber;
+}
+
+static bool GetChildFlag( XMLNode* node, const char* tag )
+{
+  return ( strcmp( GetChildText( node, tag ), "true" ) == 0 );
+}
+
+// Last component of socket paths ("/bodyset/body_0" -> "body_0")
+static const char* GetPathLeaf( const char* path )
+{
+  const char* leaf = strrchr( path, '/' );
+  return ( leaf != NULL ) ? leaf + 1 : path;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+/////                         RIGID TRANSFORMATIONS                         /////
+/////////////////////////////////////////////////////////////////////////////////
+
+typedef struct _Transform
+{
+  double rotation[ 9 ];     // Row-major rotation matrix
+  double translation[ 3 ];
+}
+Transform;
+
+static const Transform IDENTITY_TRANSFORM = { { 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 }, { 0.0, 0.0, 0.0 } };
+
+static inline void RotateVector( const double* rotation, const double* vector, double* result )
+{
+  for( size_t i = 0; i < 3; i++ )
+    result[ i ] = rotation[ 3 * i ] * vector[ 0 ] + rotation[ 3 * i + 1 ] * vector[ 1 ] + rotation[ 3 * i + 2 ] * vector[ 2 ];
+}
+
+static inline void MultiplyRotations( const double* lhs, const double* rhs, double* result )
+{
+  for( size_t i = 0; i < 3; i++ )
+  {
+    for( size_t j = 0; j < 3; j++ )
+      result[ 3 * i + j ] = lhs[ 3 * i ] * rhs[ j ] + lhs[ 3 * i + 1 ] * rhs[ 3 + j ] + lhs[ 3 * i + 2 ] * rhs[ 6 + j ];
+  }
+}
+
+static inline void ComposeTransforms( const Transform* lhs, const Transform* rhs, Transform* result )
+{
+  double rotatedTranslation[ 3 ];
+  RotateVector( lhs->rotation, rhs->translation, rotatedTranslation );
+  for( size_t i = 0; i < 3; i++ )
+    result->translation[ i ] = lhs->translation[ i ] + rotatedTranslation[ i ];
+  MultiplyRotations( lhs->rotation, rhs->rotation, result->rotation );
+}
+
+// Rodrigues formula for rotation around unit axis
+static inline void SetAxisRotation( const double* axis, double angle, double* rotation )
+{
+  double c = cos( angle ), s = sin( angle ), t = 1.0 - c;
+  double x = axis[ 0 ], y = axis[ 1 ], z = axis[ 2 ];
+  rotation[ 0 ] = t * x * x + c;     rotation[ 1 ] = t * x * y - s * z; rotation[ 2 ] = t * x * z + s * y;
+  rotation[ 3 ] = t * x * y + s * z; rotation[ 4 ] = t * y * y + c;     rotation[ 5 ] = t * y * z - s * x;
+  rotation[ 6 ] = t * x * z - s * y; rotation[ 7 ] = t * y * z + s * x; rotation[ 8 ] = t * z * z + c;
+}
+
+// OpenSim frame offsets: body-fixed X-Y-Z Euler angles and translation
+static Transform GetOffsetTransform( const double* orientation, const double* location )
+{
+  const double AXES[ 3 ][ 3 ] = { { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+  Transform offset = IDENTITY_TRANSFORM;
+  for( size_t axisIndex = 0; axisIndex < 3; axisIndex++ )
+  {
+    double axisRotation[ 9 ], previousRotation[ 9 ];
+    SetAxisRotation( AXES[ axisIndex ], orientation[ axisIndex ], axisRotation );
+    memcpy( previousRotation, offset.rotation, sizeof(previousRotation) );
+    MultiplyRotations( previousRotation, axisRotation, offset.rotation );
+  }
+  memcpy( offset.translation, location, 3 * sizeof(double) );
+  return offset;
+}
+
+static Transform InvertTransform( const Transform* transform )
+{
+  Transform inverse;
+  for( size_t i = 0; i < 3; i++ )
+  {
+    for( size_t j = 0; j < 3; j++ )
+      inverse.rotation[ 3 * i + j ] = transform->rotation[ 3 * j + i ];
+  }
+  RotateVector( inverse.rotation, transform->translation, inverse.translation );
+  for( size_t i = 0; i < 3; i++ )
+    inverse.translation[ i ] = -inverse.translation[ i ];
+  return inverse;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+/////                            MODEL STRUCTURE                            /////
+/////////////////////////////////////////////////////////////////////////////////
+
+enum FunctionType { FUNCTION_CONSTANT, FUNCTION_LINEAR, FUNCTION_SPLINE };
+
+typedef struct _TransformAxis
+{
+  double direction[ 3 ];        // Unit axis on joint parent frame
+  bool isRotation;
+  long coordinateIndex;         // Index on all coordinates list (negative for constant)
+  enum FunctionType functionType;
+  double scale, slope, offset;  // scale * ( slope * q + offset ) or scale * spline( q )
+  size_t splineStart, splinePointsNumber;
+}
+TransformAxis;
+
+typedef struct _Body
+{
+  size_t parentIndex;
+  Transform parentOffset;             // Parent body -> joint parent frame
+  Transform childOffsetInverse;       // Joint child frame -> body
+  size_t axesStart, axesNumber;       // Joint transform axes (on model axes list)
+}
+Body;
+
+typedef struct _Coordinate
+{
+  char* name;
+  double defaultValue;
+  double range[ 2 ];
+  bool isClamped;
+  long freeIndex;                     // Index on free coordinates list (negative for locked ones)
+}
+Coordinate;
+
+typedef struct _Marker
+{
+  size_t bodyIndex;
+  double location[ 3 ];
+}
+Marker;
+
+struct _OpenSimModelData
+{
+  Body* bodiesList;                   // Topologically ordered (ground first)
+  size_t bodiesNumber;
+  TransformAxis* transformAxesList;
+  size_t transformAxesNumber;
+  Coordinate* coordinatesList;
+  size_t coordinatesNumber;
+  size_t* freeCoordinateIndexesList;
+  const char** freeCoordinateNamesList;
+  size_t freeCoordinatesNumber;
+  Marker* markersList;
+  size_t markersNumber;
+  char** axisNamesList;
+  size_t axesNumber;
+  // Natural cubic spline knots and coefficients (shared by all transform axes)
+  double* splineKnotsList;
+  double* splineCoefficientsList;     // [ a b c d ] per knot
+  size_t splinePointsNumber;
+  // Per-cycle working memory
+  double* coordinateValuesList;
+  Transform* bodyTransformsList;
+  double* axisDirectionsList;         // World frame transform axis directions
+  double* axisOriginsList;            // World frame transform axis origins
+  double* axisDerivativesList;        // Transform axis function derivatives by coordinate
+  double* axisPositionsList;
+  double* jacobian;
+  double* gramMatrix;
+  double* solverVector;
+  double* ikErrorsList;
+  double* ikStepsList;
+};
+
+static long FindCoordinate( OpenSimModel model, const char* name )
+{
+  for( size_t coordinateIndex = 0; coordinateIndex < model->coordinatesNumber; coordinateIndex++ )
+  {
+    if( strcmp( model->coordinatesList[ coordinateIndex ].name, name ) == 0 ) return (long) coordinateIndex;
+  }
+  return -1;
+}
+
+// Natural cubic spline fit (Thomas algorithm on second derivatives)
+static bool AddSpline( OpenSimModel model, const double* xList, const double* yList, size_t pointsNumber )
+{
+  if( pointsNumber < 2 ) return false;
+  
+  model->splineKnotsList = (double*) realloc( model->splineKnotsList, ( model->splinePointsNumber + pointsNumber ) * sizeof(double) );
+  model->splineCoefficientsList = (double*) realloc( model->splineCoefficientsList, 4 * ( model->splinePointsNumber + pointsNumber ) * sizeof(double) );
+  double* knotsList = model->splineKnotsList + model->splinePointsNumber;
+  double* coefficientsList = model->splineCoefficientsList + 4 * model->splinePointsNumber;
+  
+  double* secondDerivativesList = (double*) calloc( pointsNumber, sizeof(double) );
+  double* auxiliarList = (double*) calloc( pointsNumber, sizeof(double) );
+  for( size_t i = 1; i < pointsNumber - 1; i++ )
+  {
+    double sigma = ( xList[ i ] - xList[ i - 1 ] ) / ( xList[ i + 1 ] - xList[ i - 1 ] );
+    double pivot = sigma * secondDerivativesList[ i - 1 ] + 2.0;
+    secondDerivativesList[ i ] = ( sigma - 1.0 ) / pivot;
+    double slopeChange = ( yList[ i + 1 ] - yList[ i ] ) / ( xList[ i + 1 ] - xList[ i ] ) - ( yList[ i ] - yList[ i - 1 ] ) / ( xList[ i ] - xList[ i - 1 ] );
+    auxiliarList[ i ] = ( 6.0 * slopeChange / ( xList[ i + 1 ] - xList[ i - 1 ] ) - sigma * auxiliarList[ i - 1 ] ) / pivot;
+  }
+  secondDerivativesList[ pointsNumber - 1 ] = 0.0;
+  for( size_t i = pointsNumber - 1; i > 0; i-- )
+    secondDerivativesList[ i - 1 ] = secondDerivativesList[ i - 1 ] * secondDerivativesList[ i ] + auxiliarList[ i - 1 ];
+  
+  // Polynomial form on each segment: a + b * dx + c * dx^2 + d * dx^3
+  for( size_t i = 0; i < pointsNumber; i++ )
+  {
+    size_t segmentEnd = ( i < pointsNumber - 1 ) ? i + 1 : i;
+    size_t segmentStart = segmentEnd - 1;
+    double h = xList[ segmentEnd ] - xList[ segmentStart ];
+    double* coefficients = coefficientsList + 4 * i;
+    knotsList[ i ] = xList[ i ];
+    coefficients[ 0 ] = yList[ i ];
+    if( i < pointsNumber - 1 )
+    {
+      coefficients[ 1 ] = ( yList[ i + 1 ] - yList[ i ] ) / h - h * ( 2.0 * secondDerivativesList[ i ] + secondDerivativesList[ i + 1 ] ) / 6.0;
+      coefficients[ 2 ] = secondDerivativesList[ i ] / 2.0;
+      coefficients[ 3 ] = ( secondDerivativesList[ i + 1 ] - secondDerivativesList[ i ] ) / ( 6.0 * h );
+    }
+    else     // Linear extrapolation after last knot
+    {
+      coefficients[ 1 ] = ( yList[ i ] - yList[ i - 1 ] ) / h + h * ( secondDerivativesList[ i - 1 ] + 2.0 * secondDerivativesList[ i ] ) / 6.0;
+      coefficients[ 2 ] = coefficients[ 3 ] = 0.0;
+    }
+  }
+  
+  free( secondDerivativesList );
+  free( auxiliarList );
+  
+  model->splinePointsNumber += pointsNumber;
+  
+  return true;
+}
+
+static bool ParseFunction( OpenSimModel model, XMLNode* functionNode, TransformAxis* axis )
+{
+  if( functionNode == NULL ) return false;
+  
+  if( strcmp( functionNode->tag, "function" ) == 0 ) return ParseFunction( model, functionNode->firstChild, axis );
+  
+  if( strcmp( functionNode->tag, "Constant" ) == 0 )
+  {
+    axis->functionType = FUNCTION_CONSTANT;
+    GetChildValues( functionNode, "value", &(axis->offset), 1 );
+    return true;
+  }
+  else if( strcmp( functionNode->tag, "LinearFunction" ) == 0 )
+  {
+    double coefficientsList[ 2 ] = { 1.0, 0.0 };
+    GetChildValues( functionNode, "coefficients", coefficientsList, 2 );
+    axis->functionType = FUNCTION_LINEAR;
+    axis->slope = coefficientsList[ 0 ];
+    axis->offset = coefficientsList[ 1 ];
+    return true;
+  }
+  else if( strcmp( functionNode->tag, "SimmSpline" ) == 0 || strcmp( functionNode->tag, "NaturalCubicSpline" ) == 0 )
+  {
+    size_t maxPointsNumber = strlen( GetChildText( functionNode, "x" ) ) / 2 + 1;
+    double* xList = (double*) calloc( maxPointsNumber, sizeof(double) );
+    double* yList = (double*) calloc( maxPointsNumber, sizeof(double) );
+    size_t pointsNumber = GetChildValues( functionNode, "x", xList, maxPointsNumber );
+    if( GetChildValues( functionNode, "y", yList, maxPointsNumber ) < pointsNumber ) pointsNumber = 0;
+    axis->functionType = FUNCTION_SPLINE;
+    axis->splineStart = model->splinePointsNumber;
+    axis->splinePointsNumber = pointsNumber;
+    bool isValid = AddSpline( model, xList, yList, pointsNumber );
+    free( xList );
+    free( yList );
+    return isValid;
+  }
+  else if( strcmp( functionNode->tag, "MultiplierFunction" ) == 0 )
+  {
+    double scale = 1.0;
+    GetChildValues( functionNode, "scale", &scale, 1 );
+    if( !ParseFunction( model, GetChild( functionNode, "function" ), axis ) ) return false;
+    axis->scale *= scale;
+    return true;
+  }
+  
+  fprintf( stderr, "opensim model: unsupported function type %s\n", functionNode->tag );
+  return false;
+}
+
+static inline double EvaluateFunction( OpenSimModel model, const TransformAxis* axis, double value, double* derivative )
+{
+  if( axis->functionType == FUNCTION_SPLINE )
+  {
+    const double* knotsList = model->splineKnotsList + axis->splineStart;
+    size_t lowIndex = 0, highIndex = axis->splinePointsNumber - 1;
+    if( value >= knotsList[ highIndex ] ) lowIndex = highIndex;
+    while( highIndex - lowIndex > 1 )
+    {
+      size_t middleIndex = ( lowIndex + highIndex ) / 2;
+      if( value < knotsList[ middleIndex ] ) highIndex = middleIndex;
+      else lowIndex = middleIndex;
+    }
+    const double* coefficients = model->splineCoefficientsList + 4 * ( axis->splineStart + lowIndex );
+    double dx = value - knotsList[ lowIndex ];
+    *derivative = axis->scale * ( coefficients[ 1 ] + dx * ( 2.0 * coefficients[ 2 ] + dx * 3.0 * coefficients[ 3 ] ) );
+    return axis->scale * ( coefficients[ 0 ] + dx * ( coefficients[ 1 ] + dx * ( coefficients[ 2 ] + dx * coefficients[ 3 ] ) ) );
+  }
+  
+  *derivative = axis->scale * axis->slope;
+  return axis->scale * ( axis->slope * value + axis->offset );
+}
+
+static void AddTransformAxis( OpenSimModel model, const double* direction, bool isRotation, long coordinateIndex )
+{
+  model->transformAxesList = (TransformAxis*) realloc( model->transformAxesList, ( model->transformAxesNumber + 1 ) * sizeof(TransformAxis) );
+  TransformAxis* newAxis = model->transformAxesList + model->transformAxesNumber;
+  memset( newAxis, 0, sizeof(TransformAxis) );
+  double norm = sqrt( direction[ 0 ] * direction[ 0 ] + direction[ 1 ] * direction[ 1 ] + direction[ 2 ] * direction[ 2 ] );
+  for( size_t i = 0; i < 3; i++ )
+    newAxis->direction[ i ] = ( norm > 0.0 ) ? direction[ i ] / norm : 0.0;
+  newAxis->isRotation = isRotation;
+  newAxis->coordinateIndex = coordinateIndex;
+  newAxis->functionType = FUNCTION_LINEAR;
+  newAxis->scale = 1.0;
+  newAxis->slope = ( coordinateIndex >= 0 ) ? 1.0 : 0.0;
+  model->transformAxesNumber++;
+}
+
+// Fixed axes of built-in joint types: 'r'otation/'t'ranslation followed by axis letter, coordinates in joint order
+static const char* JOINT_TYPES[][ 2 ] = { { "WeldJoint", "" }, { "PinJoint", "rz" }, { "SliderJoint", "tx" }, { "UniversalJoint", "rxry" }, 
+                                          { "BallJoint", "rxryrz" }, { "GimbalJoint", "rxryrz" }, { "PlanarJoint", "rztxty" }, { "FreeJoint", "rxryrztxtytz" } };
+
+static bool ParseJointAxes( OpenSimModel model, XMLNode* jointNode )
+{
+  // Joint coordinates, in definition order
+  long jointCoordinatesList[ MAX_JOINT_AXES_NUMBER ];
+  size_t jointCoordinatesNumber = 0;
+  XMLNode* coordinatesNode = GetChild( jointNode, "coordinates" );
+  if( coordinatesNode == NULL ) coordinatesNode = GetChild( GetChild( jointNode, "CoordinateSet" ), "objects" );
+  for( XMLNode* child = ( coordinatesNode != NULL ) ? coordinatesNode->firstChild : NULL; child != NULL; child = child->nextSibling )
+  {
+    if( strcmp( child->tag, "Coordinate" ) != 0 || jointCoordinatesNumber >= MAX_JOINT_AXES_NUMBER ) continue;
+    jointCoordinatesList[ jointCoordinatesNumber++ ] = FindCoordinate( model, child->name );
+  }
+  
+  if( strcmp( jointNode->tag, "CustomJoint" ) == 0 )
+  {
+    XMLNode* spatialTransformNode = GetChild( jointNode, "SpatialTransform" );
+    for( XMLNode* axisNode = ( spatialTransformNode != NULL ) ? spatialTransformNode->firstChild : NULL; axisNode != NULL; axisNode = axisNode->nextSibling )
+    {
+      if( strcmp( axisNode->tag, "TransformAxis" ) != 0 ) continue;
+      double direction[ 3 ] = { 0.0 };
+      GetChildValues( axisNode, "axis", direction, 3 );
+      const char* coordinateName = GetChildText( axisNode, "coordinates" );
+      long coordinateIndex = ( *coordinateName != '\0' ) ? FindCoordinate( model, coordinateName ) : -1;
+      bool isRotation = ( axisNode->name != NULL && strncmp( axisNode->name, "rotation", strlen( "rotation" ) ) == 0 );
+      AddTransformAxis( model, direction, isRotation, coordinateIndex );
+      TransformAxis* axis = model->transformAxesList + model->transformAxesNumber - 1;
+      // Functions may be wrapped (3.x) or not (4.x)
+      XMLNode* functionNode = GetChild( axisNode, "function" );
+      if( functionNode == NULL )
+      {
+        for( functionNode = axisNode->firstChild; functionNode != NULL; functionNode = functionNode->nextSibling )
+        {
+          if( functionNode->name != NULL && strcmp( functionNode->name, "function" ) == 0 ) break;
+        }
+      }
+      if( functionNode != NULL && !ParseFunction( model, functionNode, axis ) ) return false;
+      if( axis->coordinateIndex < 0 ) axis->slope = 0.0;
+      // Drop identically null axes
+      if( axis->functionType == FUNCTION_CONSTANT && axis->offset == 0.0 ) model->transformAxesNumber--;
+    }
+    return true;
+  }
+  
+  for( size_t typeIndex = 0; typeIndex < sizeof(JOINT_TYPES) / sizeof(JOINT_TYPES[ 0 ]); typeIndex++ )
+  {
+    if( strcmp( jointNode->tag, JOINT_TYPES[ typeIndex ][ 0 ] ) != 0 ) continue;
+    const char* axesString = JOINT_TYPES[ typeIndex ][ 1 ];
+    for( size_t axisIndex = 0; axisIndex < strlen( axesString ) / 2; axisIndex++ )
+    {
+      double direction[ 3 ] = { 0.0 };
+      direction[ axesString[ 2 * axisIndex + 1 ] - 'x' ] = 1.0;
+      long coordinateIndex = ( axisIndex < jointCoordinatesNumber ) ? jointCoordinatesList[ axisIndex ] : -1;
+      AddTransformAxis( model, direction, ( axesString[ 2 * axisIndex ] == 'r' ), coordinateIndex );
+    }
+    return true;
+  }
+  
+  fprintf( stderr, "opensim model: unsupported joint type %s\n", jointNode->tag );
+  return false;
+}
+
+static bool IsJointNode( XMLNode* node )
+{
+  size_t tagLength = strlen( node->tag );
+  return ( tagLength > strlen( "Joint" ) && strcmp( node->tag + tagLength - strlen( "Joint" ), "Joint" ) == 0 );
+}
+
+static void AddCoordinates( OpenSimModel model, XMLNode* node )
+{
+  for( XMLNode* child = node->firstChild; child != NULL; child = child->nextSibling )
+  {
+    if( strcmp( child->tag, "Coordinate" ) == 0 && child->name != NULL )
+    {
+      model->coordinatesList = (Coordinate*) realloc( model->coordinatesList, ( model->coordinatesNumber + 1 ) * sizeof(Coordinate) );
+      Coordinate* newCoordinate = model->coordinatesList + model->coordinatesNumber;
+      newCoordinate->name = strdup( child->name );
+      newCoordinate->defaultValue = 0.0;
+      GetChildValues( child, "default_value", &(newCoordinate->defaultValue), 1 );
+      newCoordinate->range[ 0 ] = -INFINITY;
+      newCoordinate->range[ 1 ] = INFINITY;
+      GetChildValues( child, "range", newCoordinate->range, 2 );
+      newCoordinate->isClamped = GetChildFlag( child, "clamped" );
+      newCoordinate->freeIndex = GetChildFlag( child, "locked" ) ? -1 : (long) model->freeCoordinatesNumber++;
+      model->coordinatesNumber++;
+    }
+    else if( strcmp( child->tag, "SpatialTransform" ) != 0 ) AddCoordinates( model, child );
+  }
+}
+
+// Joint parsing record, before topological ordering
+typedef struct _JointRecord
+{
+  XMLNode* node;
+  const char* childName;
+  const char* parentName;
+  Transform parentOffset, childOffset;
+}
+JointRecord;
+
+// 4.x joint frames: socket names refer to offset frames owned by the joint (or directly to bodies)
+static void GetJointFrame( XMLNode* jointNode, const char* socketTag, const char** bodyName, Transform* offset )
+{
+  const char* frameName = GetPathLeaf( GetChildText( jointNode, socketTag ) );
+  *bodyName = frameName;
+  *offset = IDENTITY_TRANSFORM;
+  XMLNode* framesNode = GetChild( jointNode, "frames" );
+  for( XMLNode* frameNode = ( framesNode != NULL ) ? framesNode->firstChild : NULL; frameNode != NULL; frameNode = frameNode->nextSibling )
+  {
+    if( frameNode->name == NULL || strcmp( frameNode->name, frameName ) != 0 ) continue;
+    *bodyName = GetPathLeaf( GetChildText( frameNode, "socket_parent" ) );
+    double orientation[ 3 ] = { 0.0 }, translation[ 3 ] = { 0.0 };
+    GetChildValues( frameNode, "orientation", orientation, 3 );
+    GetChildValues( frameNode, "translation", translation, 3 );
+    *offset = GetOffsetTransform( orientation, translation );
+    break;
+  }
+}
+
+static size_t CollectJoints( XMLNode* modelNode, JointRecord* recordsList, size_t maxRecordsNumber )
+{
+  size_t recordsNumber = 0;
+  
+  // 4.x: joint set
+  XMLNode* jointsNode = GetChild( GetChild( modelNode, "JointSet" ), "objects" );
+  for( XMLNode* jointNode = ( jointsNode != NULL ) ? jointsNode->firstChild : NULL; jointNode != NULL; jointNode = jointNode->nextSibling )
+  {
+    if( !IsJointNode( jointNode ) || recordsNumber >= maxRecordsNumber ) continue;
+    JointRecord* record = recordsList + recordsNumber++;
+    record->node = jointNode;
+    GetJointFrame( jointNode, "socket_parent_frame", &(record->parentName), &(record->parentOffset) );
+    GetJointFrame( jointNode, "socket_child_frame", &(record->childName), &(record->childOffset) );
+  }
+  
+  // 3.x: joints owned by (child) bodies
+  XMLNode* bodiesNode = GetChild( GetChild( modelNode, "BodySet" ), "objects" );
+  for( XMLNode* bodyNode = ( bodiesNode != NULL ) ? bodiesNode->firstChild : NULL; bodyNode != NULL; bodyNode = bodyNode->nextSibling )
+  {
+    XMLNode* jointNode = GetChild( bodyNode, "Joint" );
+    if( jointNode == NULL || jointNode->firstChild == NULL || recordsNumber >= maxRecordsNumber ) continue;
+    jointNode = jointNode->firstChild;
+    if( !IsJointNode( jointNode ) ) continue;
+    JointRecord* record = recordsList + recordsNumber++;
+    record->node = jointNode;
+    record->childName = bodyNode->name;
+    record->parentName = GetChildText( jointNode, "parent_body" );
+    double orientation[ 3 ] = { 0.0 }, location[ 3 ] = { 0.0 };
+    GetChildValues( jointNode, "orientation_in_parent", orientation, 3 );
+    GetChildValues( jointNode, "location_in_parent", location, 3 );
+    record->parentOffset = GetOffsetTransform( orientation, location );
+    memset( orientation, 0, sizeof(orientation) );
+    memset( location, 0, sizeof(location) );
+    GetChildValues( jointNode, "orientation", orientation, 3 );
+    GetChildValues( jointNode, "location", location, 3 );
+    record->childOffset = GetOffsetTransform( orientation, location );
+  }
+  
+  return recordsNumber;
+}
+
+static long FindBody( const char** bodyNamesList, size_t bodiesNumber, const char* name )
+{
+  for( size_t bodyIndex = 0; bodyIndex < bodiesNumber; bodyIndex++ )
+  {
+    if( strcmp( bodyNamesList[ bodyIndex ], name ) == 0 ) return (long) bodyIndex;
+  }
+  return -1;
+}
+
+static bool BuildModel( OpenSimModel model, XMLNode* modelNode )
+{
+  size_t maxJointsNumber = 0;
+  XMLNode* jointsNode = GetChild( GetChild( modelNode, "JointSet" ), "objects" );
+  XMLNode* bodiesNode = GetChild( GetChild( modelNode, "BodySet" ), "objects" );
+  for( XMLNode* node = ( jointsNode != NULL ) ? jointsNode->firstChild : NULL; node != NULL; node = node->nextSibling ) maxJointsNumber++;
+  for( XMLNode* node = ( bodiesNode != NULL ) ? bodiesNode->firstChild : NULL; node != NULL; node = node->nextSibling ) maxJointsNumber++;
+  
+  JointRecord* recordsList = (JointRecord*) calloc( maxJointsNumber + 1, sizeof(JointRecord) );
+  size_t jointsNumber = CollectJoints( modelNode, recordsList, maxJointsNumber );
+  
+  for( size_t jointIndex = 0; jointIndex < jointsNumber; jointIndex++ )
+    AddCoordinates( model, recordsList[ jointIndex ].node );
+  
+  // Topological ordering: ground first, then bodies whose parent is already placed
+  const char** bodyNamesList = (const char**) calloc( jointsNumber + 1, sizeof(const char*) );
+  model->bodiesList = (Body*) calloc( jointsNumber + 1, sizeof(Body) );
+  bodyNamesList[ 0 ] = "ground";
+  model->bodiesList[ 0 ].parentOffset = model->bodiesList[ 0 ].childOffsetInverse = IDENTITY_TRANSFORM;
+  model->bodiesNumber = 1;
+  bool* isPlacedList = (bool*) calloc( jointsNumber + 1, sizeof(bool) );
+  bool isValid = true;
+  for( size_t placedNumber = 0; placedNumber < jointsNumber && isValid; )
+  {
+    size_t previousPlacedNumber = placedNumber;
+    for( size_t jointIndex = 0; jointIndex < jointsNumber && isValid; jointIndex++ )
+    {
+      JointRecord* record = recordsList + jointIndex;
+      long parentIndex = FindBody( bodyNamesList, model->bodiesNumber, record->parentName );
+      if( isPlacedList[ jointIndex ] || parentIndex < 0 ) continue;
+      Body* newBody = model->bodiesList + model->bodiesNumber;
+      bodyNamesList[ model->bodiesNumber++ ] = record->childName;
+      newBody->parentIndex = (size_t) parentIndex;
+      newBody->parentOffset = record->parentOffset;
+      newBody->childOffsetInverse = InvertTransform( &(record->childOffset) );
+      newBody->axesStart = model->transformAxesNumber;
+      isValid = ParseJointAxes( model, record->node );
+      newBody->axesNumber = model->transformAxesNumber - newBody->axesStart;
+      isPlacedList[ jointIndex ] = true;
+      placedNumber++;
+    }
+    if( placedNumber == previousPlacedNumber ) 
+    {
+      fprintf( stderr, "opensim model: %lu joints not connected to ground\n", (unsigned long) ( jointsNumber - placedNumber ) );
+      break;
+    }
+  }
+  
+  // Markers (3.x: body name, 4.x: parent frame path)
+  XMLNode* markersNode = GetChild( GetChild( modelNode, "MarkerSet" ), "objects" );
+  for( XMLNode* markerNode = ( markersNode != NULL ) ? markersNode->firstChild : NULL; markerNode != NULL && isValid; markerNode = markerNode->nextSibling )
+  {
+    if( strcmp( markerNode->tag, "Marker" ) != 0 || markerNode->name == NULL ) continue;
+    const char* bodyName = GetChildText( markerNode, "body" );
+    if( *bodyName == '\0' ) bodyName = GetPathLeaf( GetChildText( markerNode, "socket_parent_frame" ) );
+    long bodyIndex = FindBody( bodyNamesList, model->bodiesNumber, bodyName );
+    if( bodyIndex < 0 ) continue;
+    model->markersList = (Marker*) realloc( model->markersList, ( model->markersNumber + 1 ) * sizeof(Marker) );
+    Marker* newMarker = model->markersList + model->markersNumber;
+    newMarker->bodyIndex = (size_t) bodyIndex;
+    memset( newMarker->location, 0, sizeof(newMarker->location) );
+    GetChildValues( markerNode, "location", newMarker->location, 3 );
+    model->axisNamesList = (char**) realloc( model->axisNamesList, 3 * ( model->markersNumber + 1 ) * sizeof(char*) );
+    for( size_t dimensionIndex = 0; dimensionIndex < 3; dimensionIndex++ )
+    {
+      char* axisName = (char*) calloc( strlen( markerNode->name ) + 3, sizeof(char) );
+      sprintf( axisName, "%s_%c", markerNode->name, 'x' + (int) dimensionIndex );
+      model->axisNamesList[ 3 * model->markersNumber + dimensionIndex ] = axisName;
+    }
+    model->markersNumber++;
+  }
+  
+  free( isPlacedList );
+  free( bodyNamesList );
+  free( recordsList );
+  
+  return isValid;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+/////                           PUBLIC INTERFACE                            /////
+/////////////////////////////////////////////////////////////////////////////////
+
+OpenSimModel OpenSimModel_Load( const char* filePath )
+{
+  FILE* modelFile = fopen( filePath, "rb" );
+  if( modelFile == NULL )
+  {
+    fprintf( stderr, "opensim model: could not open file %s\n", filePath );
+    return NULL;
+  }
+  fseek( modelFile, 0, SEEK_END );
+  long fileSize = ftell( modelFile );
+  rewind( modelFile );
+  char* fileBuffer = (char*) calloc( fileSize + 1, sizeof(char) );
+  size_t readSize = fread( fileBuffer, sizeof(char), fileSize, modelFile );
+  fileBuffer[ readSize ] = '\0';
+  fclose( modelFile );
+  
+  XMLNode* documentNode = ParseXML( fileBuffer );
+  XMLNode* modelNode = FindDescendant( documentNode, "Model" );
+  
+  OpenSimModel newModel = (OpenSimModel) calloc( 1, sizeof(OpenSimModelData) );
+  bool loadSuccess = ( modelNode != NULL ) ? BuildModel( newModel, modelNode ) : false;
+  
+  DiscardXMLNode( documentNode );
+  free( fileBuffer );
+  
+  if( !loadSuccess || newModel->freeCoordinatesNumber == 0 )
+  {
+    fprintf( stderr, "opensim model: invalid model file %s\n", filePath );
+    OpenSimModel_Discard( newModel );
+    return NULL;
+  }
+  
+  newModel->freeCoordinateIndexesList = (size_t*) calloc( newModel->freeCoordinatesNumber, sizeof(size_t) );
+  newModel->freeCoordinateNamesList = (const char**) calloc( newModel->freeCoordinatesNumber, sizeof(const char*) );
+  newModel->coordinateValuesList = (double*) calloc( newModel->coordinatesNumber, sizeof(double) );
+  for( size_t coordinateIndex = 0; coordinateIndex < newModel->coordinatesNumber; coordinateIndex++ )
+  {
+    Coordinate* coordinate = newModel->coordinatesList + coordinateIndex;
+    newModel->coordinateValuesList[ coordinateIndex ] = coordinate->defaultValue;
+    if( coordinate->freeIndex < 0 ) continue;
+    newModel->freeCoordinateIndexesList[ coordinate->freeIndex ] = coordinateIndex;
+    newModel->freeCoordinateNamesList[ coordinate->freeIndex ] = coordinate->name;
+  }
+  
+  // Without markers, free coordinates are the model axes
+  if( newModel->markersNumber == 0 )
+  {
+    newModel->axisNamesList = (char**) calloc( newModel->freeCoordinatesNumber, sizeof(char*) );
+    for( size_t axisIndex = 0; axisIndex < newModel->freeCoordinatesNumber; axisIndex++ )
+      newModel->axisNamesList[ axisIndex ] = strdup( newModel->freeCoordinateNamesList[ axisIndex ] );
+    newModel->axesNumber = newModel->freeCoordinatesNumber;
+  }
+  else newModel->axesNumber = 3 * newModel->markersNumber;
+  
+  size_t axesNumber = newModel->axesNumber, coordinatesNumber = newModel->freeCoordinatesNumber;
+  size_t solverSize = ( axesNumber < coordinatesNumber ) ? axesNumber : coordinatesNumber;
+  newModel->bodyTransformsList = (Transform*) calloc( newModel->bodiesNumber, sizeof(Transform) );
+  newModel->axisDirectionsList = (double*) calloc( 3 * newModel->transformAxesNumber + 1, sizeof(double) );
+  newModel->axisOriginsList = (double*) calloc( 3 * newModel->transformAxesNumber + 1, sizeof(double) );
+  newModel->axisDerivativesList = (double*) calloc( newModel->transformAxesNumber + 1, sizeof(double) );
+  newModel->axisPositionsList = (double*) calloc( axesNumber, sizeof(double) );
+  newModel->jacobian = (double*) calloc( axesNumber * coordinatesNumber, sizeof(double) );
+  newModel->gramMatrix = (double*) calloc( solverSize * solverSize, sizeof(double) );
+  newModel->solverVector = (double*) calloc( axesNumber + coordinatesNumber, sizeof(double) );
+  newModel->ikErrorsList = (double*) calloc( axesNumber, sizeof(double) );
+  newModel->ikStepsList = (double*) calloc( coordinatesNumber, sizeof(double) );
+  
+  fprintf( stderr, "opensim model: loaded %s (%lu bodies, %lu free coordinates, %lu axes)\n", filePath, 
+           (unsigned long) newModel->bodiesNumber, (unsigned long) coordinatesNumber, (unsigned long) axesNumber );
+  
+  OpenSimModel_SetCoordinates( newModel, NULL );
+  
+  return newModel;
+}
+
+void OpenSimModel_Discard( OpenSimModel model )
+{
+  if( model == NULL ) return;
+  
+  for( size_t coordinateIndex = 0; coordinateIndex < model->coordinatesNumber; coordinateIndex++ )
+    free( model->coordinatesList[ coordinateIndex ].name );
+  size_t axisNamesNumber = ( model->markersNumber > 0 ) ? 3 * model->markersNumber : model->axesNumber;
+  for( size_t axisIndex = 0; axisIndex < axisNamesNumber; axisIndex++ )
+    free( model->axisNamesList[ axisIndex ] );
+  free( model->axisNamesList );
+  free( model->coordinatesList );
+  free( model->freeCoordinateIndexesList );
+  free( model->freeCoordinateNamesList );
+  free( model->bodiesList );
+  free( model->transformAxesList );
+  free( model->markersList );
+  free( model->splineKnotsList );
+  free( model->splineCoefficientsList );
+  free( model->coordinateValuesList );
+  free( model->bodyTransformsList );
+  free( model->axisDirectionsList );
+  free( model->axisOriginsList );
+  free( model->axisDerivativesList );
+  free( model->axisPositionsList );
+  free( model->jacobian );
+  free( model->gramMatrix );
+  free( model->solverVector );
+  free( model->ikErrorsList );
+  free( model->ikStepsList );
+  
+  free( model );
+}
+
+size_t OpenSimModel_GetCoordinatesNumber( OpenSimModel model ) { return ( model != NULL ) ? model->freeCoordinatesNumber : 0; }
+
+const char** OpenSimModel_GetCoordinateNamesList( OpenSimModel model ) { return ( model != NULL ) ? model->freeCoordinateNamesList : NULL; }
+
+size_t OpenSimModel_GetAxesNumber( OpenSimModel model ) { return ( model != NULL ) ? model->axesNumber : 0; }
+
+const char** OpenSimModel_GetAxisNamesList( OpenSimModel model ) { return ( model != NULL ) ? (const char**) model->axisNamesList : NULL; }
+
+void OpenSimModel_SetCoordinates( OpenSimModel model, const double* coordinatesList )
+{
+  if( model == NULL ) return;
+  
+  if( coordinatesList != NULL )
+  {
+    for( size_t freeIndex = 0; freeIndex < model->freeCoordinatesNumber; freeIndex++ )
+    {
+      size_t coordinateIndex = model->freeCoordinateIndexesList[ freeIndex ];
+      Coordinate* coordinate = model->coordinatesList + coordinateIndex;
+      double value = coordinatesList[ freeIndex ];
+      if( coordinate->isClamped ) value = fmax( coordinate->range[ 0 ], fmin( value, coordinate->range[ 1 ] ) );
+      model->coordinateValuesList[ coordinateIndex ] = value;
+    }
+  }
+  
+  // Forward kinematics, storing world frame joint axes for Jacobian computation
+  model->bodyTransformsList[ 0 ] = IDENTITY_TRANSFORM;
+  for( size_t bodyIndex = 1; bodyIndex < model->bodiesNumber; bodyIndex++ )
+  {
+    const Body* body = model->bodiesList + bodyIndex;
+    Transform jointParentTransform, jointChildTransform;
+    ComposeTransforms( model->bodyTransformsList + body->parentIndex, &(body->parentOffset), &jointParentTransform );
+    
+    // Translations (on joint parent frame) define the origin of all joint rotations
+    double jointTranslation[ 3 ] = { 0.0, 0.0, 0.0 };
+    for( size_t axisIndex = body->axesStart; axisIndex < body->axesStart + body->axesNumber; axisIndex++ )
+    {
+      const TransformAxis* axis = model->transformAxesList + axisIndex;
+      if( axis->isRotation ) continue;
+      double coordinate = ( axis->coordinateIndex >= 0 ) ? model->coordinateValuesList[ axis->coordinateIndex ] : 0.0;
+      double value = EvaluateFunction( model, axis, coordinate, model->axisDerivativesList + axisIndex );
+      for( size_t i = 0; i < 3; i++ )
+        jointTranslation[ i ] += value * axis->direction[ i ];
+      RotateVector( jointParentTransform.rotation, axis->direction, model->axisDirectionsList + 3 * axisIndex );
+    }
+    RotateVector( jointParentTransform.rotation, jointTranslation, jointChildTransform.translation );
+    for( size_t i = 0; i < 3; i++ )
+      jointChildTransform.translation[ i ] += jointParentTransform.translation[ i ];
+    
+    // Successive (body-fixed) rotations
+    memcpy( jointChildTransform.rotation, jointParentTransform.rotation, sizeof(jointChildTransform.rotation) );
+    for( size_t axisIndex = body->axesStart; axisIndex < body->axesStart + body->axesNumber; axisIndex++ )
+    {
+      const TransformAxis* axis = model->transformAxesList + axisIndex;
+      if( !axis->isRotation ) continue;
+      double coordinate = ( axis->coordinateIndex >= 0 ) ? model->coordinateValuesList[ axis->coordinateIndex ] : 0.0;
+      double angle = EvaluateFunction( model, axis, coordinate, model->axisDerivativesList + axisIndex );
+      RotateVector( jointChildTransform.rotation, axis->direction, model->axisDirectionsList + 3 * axisIndex );
+      memcpy( model->axisOriginsList + 3 * axisIndex, jointChildTransform.translation, 3 * sizeof(double) );
+      double axisRotation[ 9 ], previousRotation[ 9 ];
+      SetAxisRotation( axis->direction, angle, axisRotation );
+      memcpy( previousRotation, jointChildTransform.rotation, sizeof(previousRotation) );
+      MultiplyRotations( previousRotation, axisRotation, jointChildTransform.rotation );
+    }
+    
+    ComposeTransforms( &jointChildTransform, &(body->childOffsetInverse), model->bodyTransformsList + bodyIndex );
+  }
+  
+  size_t coordinatesNumber = model->freeCoordinatesNumber;
+  memset( model->jacobian, 0, model->axesNumber * coordinatesNumber * sizeof(double) );
+  
+  if( model->markersNumber == 0 )
+  {
+    for( size_t freeIndex = 0; freeIndex < coordinatesNumber; freeIndex++ )
+    {
+      model->axisPositionsList[ freeIndex ] = model->coordinateValuesList[ model->freeCoordinateIndexesList[ freeIndex ] ];
+      model->jacobian[ freeIndex * coordinatesNumber + freeIndex ] = 1.0;
+    }
+    return;
+  }
+  
+  // Marker positions and geometric Jacobian (contributions of all transform axes up the marker chain)
+  for( size_t markerIndex = 0; markerIndex < model->markersNumber; markerIndex++ )
+  {
+    const Marker* marker = model->markersList + markerIndex;
+    const Transform* bodyTransform = model->bodyTransformsList + marker->bodyIndex;
+    double* position = model->axisPositionsList + 3 * markerIndex;
+    RotateVector( bodyTransform->rotation, marker->location, position );
+    for( size_t i = 0; i < 3; i++ )
+      position[ i ] += bodyTransform->translation[ i ];
+    
+    double* jacobianRows = model->jacobian + 3 * markerIndex * coordinatesNumber;
+    for( size_t bodyIndex = marker->bodyIndex; bodyIndex > 0; bodyIndex = model->bodiesList[ bodyIndex ].parentIndex )
+    {
+      const Body* body = model->bodiesList + bodyIndex;
+      for( size_t axisIndex = body->axesStart; axisIndex < body->axesStart + body->axesNumber; axisIndex++ )
+      {
+        const TransformAxis* axis = model->transformAxesList + axisIndex;
+        if( axis->coordinateIndex < 0 ) continue;
+        long freeIndex = model->coordinatesList[ axis->coordinateIndex ].freeIndex;
+        if( freeIndex < 0 ) continue;
+        const double* direction = model->axisDirectionsList + 3 * axisIndex;
+        double derivative = model->axisDerivativesList[ axisIndex ];
+        double velocity[ 3 ] = { direction[ 0 ], direction[ 1 ], direction[ 2 ] };
+        if( axis->isRotation )
+        {
+          const double* origin = model->axisOriginsList + 3 * axisIndex;
+          double arm[ 3 ] = { position[ 0 ] - origin[ 0 ], position[ 1 ] - origin[ 1 ], position[ 2 ] - origin[ 2 ] };
+          velocity[ 0 ] = direction[ 1 ] * arm[ 2 ] - direction[ 2 ] * arm[ 1 ];
+          velocity[ 1 ] = direction[ 2 ] * arm[ 0 ] - direction[ 0 ] * arm[ 2 ];
+          velocity[ 2 ] = direction[ 0 ] * arm[ 1 ] - direction[ 1 ] * arm[ 0 ];
+        }
+        for( size_t i = 0; i < 3; i++ )
+          jacobianRows[ i * coordinatesNumber + freeIndex ] += derivative * velocity[ i ];
+      }
+    }
+  }
+}
+
+const double* OpenSimModel_GetAxisPositions( OpenSimModel model ) { return ( model != NULL ) ? model->axisPositionsList : NULL; }
+
+const double* OpenSimModel_GetJacobian( OpenSimModel model ) { return ( model != NULL ) ? model->jacobian : NULL; }
+
+// Solves (A + lambda^2 * I) * x = b in place (b -> x) by Cholesky decomposition (A symmetric positive semidefinite)
+static void SolveDampedSystem( double* matrix, size_t size, double damping, double* vector )
+{
+  for( size_t i = 0; i < size; i++ )
+    matrix[ i * size + i ] += damping * damping;
+  
+  for( size_t j = 0; j < size; j++ )
+  {
+    double pivot = matrix[ j * size + j ];
+    for( size_t k = 0; k < j; k++ )
+      pivot -= matrix[ j * size + k ] * matrix[ j * size + k ];
+    pivot = sqrt( fmax( pivot, MIN_CHOLESKY_PIVOT ) );
+    matrix[ j * size + j ] = pivot;
+    for( size_t i = j + 1; i < size; i++ )
+    {
+      double value = matrix[ i * size + j ];
+      for( size_t k = 0; k < j; k++ )
+        value -= matrix[ i * size + k ] * matrix[ j * size + k ];
+      matrix[ i * size + j ] = value / pivot;
+    }
+  }
+  
+  for( size_t i = 0; i < size; i++ )     // L * y = b
+  {
+    for( size_t k = 0; k < i; k++ )
+      vector[ i ] -= matrix[ i * size + k ] * vector[ k ];
+    vector[ i ] /= matrix[ i * size + i ];
+  }
+  for( size_t i = size; i-- > 0; )       // L^T * x = y
+  {
+    for( size_t k = i + 1; k < size; k++ )
+      vector[ i ] -= matrix[ k * size + i ] * vector[ k ];
+    vector[ i ] /= matrix[ i * size + i ];
+  }
+}
+
+// Gram matrix of smaller dimension: J * J^T (rows) or J^T * J (columns)
+static void ComputeGramMatrix( OpenSimModel model, bool useRows )
+{
+  const double* jacobian = model->jacobian;
+  size_t rowsNumber = model->axesNumber, columnsNumber = model->freeCoordinatesNumber;
+  size_t size = useRows ? rowsNumber : columnsNumber;
+  for( size_t i = 0; i < size; i++ )
+  {
+    for( size_t j = 0; j <= i; j++ )
+    {
+      double sum = 0.0;
+      if( useRows ) 
+      {
+        for( size_t k = 0; k < columnsNumber; k++ )
+          sum += jacobian[ i * columnsNumber + k ] * jacobian[ j * columnsNumber + k ];
+      }
+      else
+      {
+        for( size_t k = 0; k < rowsNumber; k++ )
+          sum += jacobian[ k * columnsNumber + i ] * jacobian[ k * columnsNumber + j ];
+      }
+      model->gramMatrix[ i * size + j ] = model->gramMatrix[ j * size + i ] = sum;
+    }
+  }
+}
+
+void OpenSimModel_InverseMap( OpenSimModel model, const double* axisValuesList, double damping, double* coordinateValuesList )
+{
+  if( model == NULL ) return;
+  
+  const double* jacobian = model->jacobian;
+  size_t rowsNumber = model->axesNumber, columnsNumber = model->freeCoordinatesNumber;
+  double* vector = model->solverVector;
+  if( rowsNumber <= columnsNumber )     // J^T * (J * J^T + lambda^2 * I)^-1 * x
+  {
+    memcpy( vector, axisValuesList, rowsNumber * sizeof(double) );
+    ComputeGramMatrix( model, true );
+    SolveDampedSystem( model->gramMatrix, rowsNumber, damping, vector );
+    for( size_t j = 0; j < columnsNumber; j++ )
+    {
+      coordinateValuesList[ j ] = 0.0;
+      for( size_t i = 0; i < rowsNumber; i++ )
+        coordinateValuesList[ j ] += jacobian[ i * columnsNumber + j ] * vector[ i ];
+    }
+  }
+  else                                  // (J^T * J + lambda^2 * I)^-1 * J^T * x
+  {
+    for( size_t j = 0; j < columnsNumber; j++ )
+    {
+      vector[ j ] = 0.0;
+      for( size_t i = 0; i < rowsNumber; i++ )
+        vector[ j ] += jacobian[ i * columnsNumber + j ] * axisValuesList[ i ];
+    }
+    ComputeGramMatrix( model, false );
+    SolveDampedSystem( model->gramMatrix, columnsNumber, damping, vector );
+    memcpy( coordinateValuesList, vector, columnsNumber * sizeof(double) );
+  }
+}
+
+void OpenSimModel_InverseTransposeMap( OpenSimModel model, const double* coordinateValuesList, double damping, double* axisValuesList )
+{
+  if( model == NULL ) return;
+  
+  const double* jacobian = model->jacobian;
+  size_t rowsNumber = model->axesNumber, columnsNumber = model->freeCoordinatesNumber;
+  double* vector = model->solverVector;
+  if( rowsNumber <= columnsNumber )     // (J * J^T + lambda^2 * I)^-1 * J * tau
+  {
+    for( size_t i = 0; i < rowsNumber; i++ )
+    {
+      vector[ i ] = 0.0;
+      for( size_t j = 0; j < columnsNumber; j++ )
+        vector[ i ] += jacobian[ i * columnsNumber + j ] * coordinateValuesList[ j ];
+    }
+    ComputeGramMatrix( model, true );
+    SolveDampedSystem( model->gramMatrix, rowsNumber, damping, vector );
+    memcpy( axisValuesList, vector, rowsNumber * sizeof(double) );
+  }
+  else                                  // J * (J^T * J + lambda^2 * I)^-1 * tau
+  {
+    memcpy( vector, coordinateValuesList, columnsNumber * sizeof(double) );
+    ComputeGramMatrix( model, false );
+    SolveDampedSystem( model->gramMatrix, columnsNumber, damping, vector );
+    for( size_t i = 0; i < rowsNumber; i++ )
+    {
+      axisValuesList[ i ] = 0.0;
+      for( size_t j = 0; j < columnsNumber; j++ )
+        axisValuesList[ i ] += jacobian[ i * columnsNumber + j ] * vector[ j ];
+    }
+  }
+}
+
+size_t OpenSimModel_SolveIK( OpenSimModel model, const double* targetsList, double* coordinatesList, double damping, size_t maxIterations, double tolerance )
+{
+  if( model == NULL ) return 0;
+  
+  size_t iterationsNumber = 0;
+  while( true )
+  {
+    OpenSimModel_SetCoordinates( model, coordinatesList );
+    
+    double errorNorm = 0.0;
+    for( size_t axisIndex = 0; axisIndex < model->axesNumber; axisIndex++ )
+    {
+      model->ikErrorsList[ axisIndex ] = targetsList[ axisIndex ] - model->axisPositionsList[ axisIndex ];
+      errorNorm += model->ikErrorsList[ axisIndex ] * model->ikErrorsList[ axisIndex ];
+    }
+    if( sqrt( errorNorm ) <= tolerance || iterationsNumber >= maxIterations ) break;
+    
+    OpenSimModel_InverseMap( model, model->ikErrorsList, damping, model->ikStepsList );
+    for( size_t freeIndex = 0; freeIndex < model->freeCoordinatesNumber; freeIndex++ )
+    {
+      const Coordinate* coordinate = model->coordinatesList + model->freeCoordinateIndexesList[ freeIndex ];
+      coordinatesList[ freeIndex ] += model->ikStepsList[ freeIndex ];
+      if( coordinate->isClamped ) coordinatesList[ freeIndex ] = fmax( coordinate->range[ 0 ], fmin( coordinatesList[ freeIndex ], coordinate->range[ 1 ] ) );
+    }
+    iterationsNumber++;
+  }
+  
+  return iterationsNumber;
+}
@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file opensim_model.h
+/// @brief Lightweight OpenSim model kinematics functions
+///
+/// Bodies, joints, coordinates and markers of OpenSim 3.x (joints inside bodies, location/orientation in parent) or 4.x (joint set with offset frames) model files are parsed 
+/// into a flat, topologically ordered kinematic tree. Supported joints are Weld, Pin, Slider, Universal, Ball, Gimbal, Planar, Free and Custom (spatial transform axes with
+/// Constant, Linear, SimmSpline/NaturalCubicSpline and Multiplier functions). Locked coordinates are kept at their default values and only free ones are exposed.
+/// Model axes are the 3-D positions of its markers (or the free coordinates themselves, if no marker is defined). All working memory is allocated on loading, so that
+/// forward kinematics, Jacobians and damped least squares inverse kinematics may be evaluated on every control cycle without dynamic allocation
+
+#ifndef OPENSIM_MODEL_H
+#define OPENSIM_MODEL_H
+
+#include <stddef.h>
+
+typedef struct _OpenSimModelData OpenSimModelData;    ///< Single kinematic model internal data structure
+typedef OpenSimModelData* OpenSimModel;               ///< Opaque reference to kinematic model
+
+/// @brief Parses .osim file and builds its kinematic tree
+/// @param[in] filePath path to model file
+/// @return reference to loaded model (NULL on errors)
+OpenSimModel OpenSimModel_Load( const char* filePath );
+
+/// @brief Deallocates internal data of given model
+/// @param[in] model reference to model
+void OpenSimModel_Discard( OpenSimModel model );
+
+/// @brief Gets number of free (not locked) coordinates of given model
+/// @param[in] model reference to model
+/// @return number of free coordinates
+size_t OpenSimModel_GetCoordinatesNumber( OpenSimModel model );
+
+/// @brief Gets names of free coordinates of given model
+/// @param[in] model reference to model
+/// @return pointer to list of coordinate name strings
+const char** OpenSimModel_GetCoordinateNamesList( OpenSimModel model );
+
+/// @brief Gets number of axes (marker position components or free coordinates) of given model
+/// @param[in] model reference to model
+/// @return number of axes
+size_t OpenSimModel_GetAxesNumber( OpenSimModel model );
+
+/// @brief Gets names of axes of given model ("<marker>_x", "<marker>_y", "<marker>_z" or coordinate names)
+/// @param[in] model reference to model
+/// @return pointer to list of axis name strings
+const char** OpenSimModel_GetAxisNamesList( OpenSimModel model );
+
+/// @brief Sets free coordinate values and updates forward kinematics and Jacobian
+/// @param[in] model reference to model
+/// @param[in] coordinatesList free coordinate values (clamped to range if coordinate is clamped)
+void OpenSimModel_SetCoordinates( OpenSimModel model, const double* coordinatesList );
+
+/// @brief Gets axis positions for last set coordinates
+/// @param[in] model reference to model
+/// @return pointer to internal list of axis positions (axes number values)
+const double* OpenSimModel_GetAxisPositions( OpenSimModel model );
+
+/// @brief Gets Jacobian (axis position derivatives by free coordinates) for last set coordinates
+/// @param[in] model reference to model
+/// @return pointer to internal row-major [axes number x coordinates number] matrix
+const double* OpenSimModel_GetJacobian( OpenSimModel model );
+
+/// @brief Maps axis values to coordinate ones through damped pseudo-inverse of last Jacobian (e.g. velocities: qdot = J^T * (J * J^T + lambda^2 * I)^-1 * xdot)
+/// @param[in] model reference to model
+/// @param[in] axisValuesList axis values (axes number values)
+/// @param[in] damping damping factor (lambda) for singularity robustness
+/// @param[out] coordinateValuesList resulting coordinate values (coordinates number values)
+void OpenSimModel_InverseMap( OpenSimModel model, const double* axisValuesList, double damping, double* coordinateValuesList );
+
+/// @brief Maps coordinate values to axis ones through transpose of damped pseudo-inverse of last Jacobian (e.g. forces: f = (J * J^T + lambda^2 * I)^-1 * J * tau)
+/// @param[in] model reference to model
+/// @param[in] coordinateValuesList coordinate values (coordinates number values)
+/// @param[in] damping damping factor (lambda) for singularity robustness
+/// @param[out] axisValuesList resulting axis values (axes number values)
+void OpenSimModel_InverseTransposeMap( OpenSimModel model, const double* coordinateValuesList, double damping, double* axisValuesList );
+
+/// @brief Iteratively solves inverse kinematics by damped least squares (model state is left at solution)
+/// @param[in] model reference to model
+/// @param[in] targetsList desired axis positions (axes number values)
+/// @param[in,out] coordinatesList initial guess and resulting free coordinate values
+/// @param[in] damping damping factor (lambda) of each iteration step
+/// @param[in] maxIterations maximum number of iterations
+/// @param[in] tolerance axis position error norm under which solution is accepted
+/// @return number of performed iterations
+size_t OpenSimModel_SolveIK( OpenSimModel model, const double* targetsList, double* coordinatesList, double damping, size_t maxIterations, double tolerance );
+
+#endif // OPENSIM_MODEL_H
@@ -0,0 +1,220 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file opensim_model_ik.c
+/// @brief Kinematic chain controller based on OpenSim model files
+///
+/// Joints are the free coordinates of the model, and axes are the positions of its markers (or the coordinates themselves, if there is no marker).
+/// Axis measures come from forward kinematics and Jacobian mappings, while joint position setpoints are computed from axis ones by damped least squares inverse kinematics
+/// (warm started from last solution), velocity and force setpoints through damped pseudo-inverse and transpose Jacobians, and stiffness/damping as diagonal of J^T * K * J.
+/// Configuration string: "<model_name> [<damping> [<max_iterations> [<tolerance>]]]", where the model file is [<root_dir>]/config/robots/<model_name>.osim
+/// (default: damping 0.01, 10 iterations and 1e-4 tolerance)
+
+#include "robot_control/robot_control.h"
+#include "robot_control_extensions.h"
+
+#include "opensim_model.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MODEL_PATH_MAX_LENGTH 256
+
+typedef struct _ControlData
+{
+  OpenSimModel model;
+  size_t jointsNumber, axesNumber;
+  double damping;
+  size_t maxIterations;
+  double tolerance;
+  double* jointValuesList;
+  double* axisValuesList;
+  double* ikPositionsList;
+  bool isIKSeeded;
+  enum ControlState state;
+}
+ControlData;
+
+
+DECLARE_MODULE_INTERFACE( ROBOT_CONTROL_CONTEXT_INTERFACE );
+
+
+static bool LoadConfiguration( ControlData* controlData, const char* configurationString )
+{
+  if( configurationString == NULL ) return false;
+  
+  char modelName[ MODEL_PATH_MAX_LENGTH ] = "";
+  unsigned long maxIterations = 10;
+  controlData->damping = 0.01;
+  controlData->tolerance = 1e-4;
+  if( sscanf( configurationString, "%200s %lf %lu %lf", modelName, &(controlData->damping), &maxIterations, &(controlData->tolerance) ) < 1 ) return false;
+  controlData->maxIterations = (size_t) maxIterations;
+  
+  char filePath[ MODEL_PATH_MAX_LENGTH ];
+  snprintf( filePath, MODEL_PATH_MAX_LENGTH, "config/robots/%s.osim", modelName );
+  if( (controlData->model = OpenSimModel_Load( filePath )) == NULL ) return false;
+  
+  controlData->jointsNumber = OpenSimModel_GetCoordinatesNumber( controlData->model );
+  controlData->axesNumber = OpenSimModel_GetAxesNumber( controlData->model );
+  
+  size_t maxValuesNumber = ( controlData->axesNumber > controlData->jointsNumber ) ? controlData->axesNumber : controlData->jointsNumber;
+  controlData->jointValuesList = (double*) calloc( maxValuesNumber, sizeof(double) );
+  controlData->axisValuesList = (double*) calloc( maxValuesNumber, sizeof(double) );
+  controlData->ikPositionsList = (double*) calloc( controlData->jointsNumber, sizeof(double) );
+  controlData->isIKSeeded = false;
+  
+  controlData->state = CONTROL_PASSIVE;
+  
+  return true;
+}
+
+ControllerContext CreateController( const char* configurationString )
+{
+  ControlData* controlData = (ControlData*) calloc( 1, sizeof(ControlData) );
+  if( controlData == NULL ) return NULL;
+  
+  if( !LoadConfiguration( controlData, configurationString ) )
+  {
+    DiscardController( controlData );
+    return NULL;
+  }
+  
+  return controlData;
+}
+
+void DiscardController( ControllerContext context )
+{
+  ControlData* controlData = (ControlData*) context;
+  
+  OpenSimModel_Discard( controlData->model );
+  
+  free( controlData->jointValuesList );
+  free( controlData->axisValuesList );
+  free( controlData->ikPositionsList );
+  
+  free( controlData );
+}
+
+size_t GetControllerJointsNumber( ControllerContext context ) { return ((ControlData*) context)->jointsNumber; }
+
+const char** GetControllerJointNamesList( ControllerContext context ) { return OpenSimModel_GetCoordinateNamesList( ((ControlData*) context)->model ); }
+
+size_t GetControllerAxesNumber( ControllerContext context ) { return ((ControlData*) context)->axesNumber; }
+
+const char** GetControllerAxisNamesList( ControllerContext context ) { return OpenSimModel_GetAxisNamesList( ((ControlData*) context)->model ); }
+
+size_t GetControllerExtraInputsNumber( ControllerContext context ) { return 0; }
+      
+void SetControllerExtraInputsList( ControllerContext context, double* inputsList ) { return; }
+
+size_t GetControllerExtraOutputsNumber( ControllerContext context ) { return 0; }
+         
+void GetControllerExtraOutputsList( ControllerContext context, double* outputsList ) { return; }
+
+void SetControllerState( ControllerContext context, enum ControlState newControlState )
+{
+  ControlData* controlData = (ControlData*) context;
+  
+  fprintf( stderr, "Setting robot control phase: %x\n", newControlState );
+  
+  controlData->state = newControlState;
+  controlData->isIKSeeded = false;
+}
+
+void RunControllerStep( ControllerContext context, DoFVariables** jointMeasuresList, DoFVariables** axisMeasuresList, DoFVariables** jointSetpointsList, DoFVariables** axisSetpointsList, double timeDelta )
+{
+  ControlData* controlData = (ControlData*) context;
+  
+  OpenSimModel model = controlData->model;
+  size_t jointsNumber = controlData->jointsNumber, axesNumber = controlData->axesNumber;
+  double* jointValuesList = controlData->jointValuesList;
+  double* axisValuesList = controlData->axisValuesList;
+  
+  // Forward kinematics on measured configuration
+  for( size_t jointIndex = 0; jointIndex < jointsNumber; jointIndex++ )
+    jointValuesList[ jointIndex ] = jointMeasuresList[ jointIndex ]->position;
+  OpenSimModel_SetCoordinates( model, jointValuesList );
+  
+  const double* axisPositionsList = OpenSimModel_GetAxisPositions( model );
+  const double* jacobian = OpenSimModel_GetJacobian( model );
+  
+  // Axis velocities and accelerations (neglecting Jacobian derivative term): xdot = J * qdot
+  for( size_t axisIndex = 0; axisIndex < axesNumber; axisIndex++ )
+  {
+    const double* jacobianRow = jacobian + axisIndex * jointsNumber;
+    double velocity = 0.0, acceleration = 0.0;
+    for( size_t jointIndex = 0; jointIndex < jointsNumber; jointIndex++ )
+    {
+      velocity += jacobianRow[ jointIndex ] * jointMeasuresList[ jointIndex ]->velocity;
+      acceleration += jacobianRow[ jointIndex ] * jointMeasuresList[ jointIndex ]->acceleration;
+    }
+    axisMeasuresList[ axisIndex ]->position = axisPositionsList[ axisIndex ];
+    axisMeasuresList[ axisIndex ]->velocity = velocity;
+    axisMeasuresList[ axisIndex ]->acceleration = acceleration;
+  }
+  
+  // Axis forces from joint torques: tau = J^T * f
+  for( size_t jointIndex = 0; jointIndex < jointsNumber; jointIndex++ )
+    jointValuesList[ jointIndex ] = jointMeasuresList[ jointIndex ]->force;
+  OpenSimModel_InverseTransposeMap( model, jointValuesList, controlData->damping, axisValuesList );
+  for( size_t axisIndex = 0; axisIndex < axesNumber; axisIndex++ )
+    axisMeasuresList[ axisIndex ]->force = axisValuesList[ axisIndex ];
+  
+  if( controlData->state != CONTROL_OPERATION ) return;
+  
+  // Joint velocity setpoints: qdot = J^+ * xdot
+  for( size_t axisIndex = 0; axisIndex < axesNumber; axisIndex++ )
+    axisValuesList[ axisIndex ] = axisSetpointsList[ axisIndex ]->velocity;
+  OpenSimModel_InverseMap( model, axisValuesList, controlData->damping, jointValuesList );
+  for( size_t jointIndex = 0; jointIndex < jointsNumber; jointIndex++ )
+    jointSetpointsList[ jointIndex ]->velocity = jointValuesList[ jointIndex ];
+  
+  // Joint force, stiffness and damping setpoints: tau = J^T * f, K_q = diag( J^T * K_x * J )
+  for( size_t jointIndex = 0; jointIndex < jointsNumber; jointIndex++ )
+  {
+    double force = 0.0, stiffness = 0.0, damping = 0.0;
+    for( size_t axisIndex = 0; axisIndex < axesNumber; axisIndex++ )
+    {
+      double jacobianElement = jacobian[ axisIndex * jointsNumber + jointIndex ];
+      force += jacobianElement * axisSetpointsList[ axisIndex ]->force;
+      stiffness += jacobianElement * jacobianElement * axisSetpointsList[ axisIndex ]->stiffness;
+      damping += jacobianElement * jacobianElement * axisSetpointsList[ axisIndex ]->damping;
+    }
+    jointSetpointsList[ jointIndex ]->force = force;
+    jointSetpointsList[ jointIndex ]->stiffness = stiffness;
+    jointSetpointsList[ jointIndex ]->damping = damping;
+  }
+  
+  // Joint position setpoints from inverse kinematics (leaves model on solution configuration, so it runs last)
+  if( !controlData->isIKSeeded )
+  {
+    for( size_t jointIndex = 0; jointIndex < jointsNumber; jointIndex++ )
+      controlData->ikPositionsList[ jointIndex ] = jointMeasuresList[ jointIndex ]->position;
+    controlData->isIKSeeded = true;
+  }
+  for( size_t axisIndex = 0; axisIndex < axesNumber; axisIndex++ )
+    axisValuesList[ axisIndex ] = axisSetpointsList[ axisIndex ]->position;
+  OpenSimModel_SolveIK( model, axisValuesList, controlData->ikPositionsList, controlData->damping, controlData->maxIterations, controlData->tolerance );
+  for( size_t jointIndex = 0; jointIndex < jointsNumber; jointIndex++ )
+    jointSetpointsList[ jointIndex ]->position = controlData->ikPositionsList[ jointIndex ];
+}
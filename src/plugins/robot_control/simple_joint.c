@@ -21,70 +21,81 @@
 
 
 #include "robot_control/robot_control.h"
+#include "robot_control_extensions.h"
 
 #include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
 #define DOFS_NUMBER 1
 
-const char* DOF_NAMES[ DOFS_NUMBER ] = { "angle" };
+static const char* DOF_NAMES[ DOFS_NUMBER ] = { "angle" };
 
-enum ControlState controlState = CONTROL_PASSIVE;
-
-double positionProportionalGain = 0.0;
-double forceProportionalGain = 0.0, forceIntegralGain = 0.0;
-
-double lastForceError = 0.0;
-double velocitySetpoint = 0.0;
-
-double runningTime = 0.0;
+typedef struct _ControlData
+{
+  enum ControlState controlState;
+  double positionProportionalGain;
+  double forceProportionalGain, forceIntegralGain;
+  double lastForceError;
+  double velocitySetpoint;
+  double runningTime;
+}
+ControlData;
 
 
-DECLARE_MODULE_INTERFACE( ROBOT_CONTROL_INTERFACE );
+DECLARE_MODULE_INTERFACE( ROBOT_CONTROL_CONTEXT_INTERFACE );
 
 
-bool InitController( const char* configurationString ) 
+ControllerContext CreateController( const char* configurationString ) 
 {
-  positionProportionalGain = strtod( strtok( (char*) configurationString, " " ), NULL );
-  forceProportionalGain = strtod( strtok( NULL, " " ), NULL );
-  forceIntegralGain = strtod( strtok( NULL, " " ), NULL );
+  ControlData* controlData = (ControlData*) calloc( 1, sizeof(ControlData) );
+  if( controlData == NULL ) return NULL;
+  
+  controlData->controlState = CONTROL_PASSIVE;
+  controlData->positionProportionalGain = strtod( strtok( (char*) configurationString, " " ), NULL );
+  controlData->forceProportionalGain = strtod( strtok( NULL, " " ), NULL );
+  controlData->forceIntegralGain = strtod( strtok( NULL, " " ), NULL );
   
-  return true; 
+  return controlData; 
 }
 
-void EndController() 
+void DiscardController( ControllerContext context ) 
 { 
-  return; 
+  free( context ); 
 }
 
-size_t GetJointsNumber() { return DOFS_NUMBER; }
+size_t GetControllerJointsNumber( ControllerContext context ) { return DOFS_NUMBER; }
 
-const char** GetJointNamesList() { return DOF_NAMES; }
+const char** GetControllerJointNamesList( ControllerContext context ) { return DOF_NAMES; }
 
-size_t GetAxesNumber() { return DOFS_NUMBER; }
+size_t GetControllerAxesNumber( ControllerContext context ) { return DOFS_NUMBER; }
 
-const char** GetAxisNamesList() { return DOF_NAMES; }
+const char** GetControllerAxisNamesList( ControllerContext context ) { return DOF_NAMES; }
 
-size_t GetExtraInputsNumber( void ) { return 0; }
+size_t GetControllerExtraInputsNumber( ControllerContext context ) { return 0; }
       
-void SetExtraInputsList( double* inputsList ) { return; }
+void SetControllerExtraInputsList( ControllerContext context, double* inputsList ) { return; }
 
-size_t GetExtraOutputsNumber( void ) { return 0; }
+size_t GetControllerExtraOutputsNumber( ControllerContext context ) { return 0; }
          
-void GetExtraOutputsList( double* outputsList ) { return; }
+void GetControllerExtraOutputsList( ControllerContext context, double* outputsList ) { return; }
 
-void SetControlState( enum ControlState newControlState )
+void SetControllerState( ControllerContext context, enum ControlState newControlState )
 {
+  ControlData* controlData = (ControlData*) context;
+  
   fprintf( stderr, "Setting robot control phase: %x\n", newControlState );
   
-  controlState = newControlState;
+  controlData->controlState = newControlState;
   
-  velocitySetpoint = 0.0;
-  runningTime = 0.0;
+  controlData->velocitySetpoint = 0.0;
+  controlData->runningTime = 0.0;
 }
 
-void RunControlStep( DoFVariables** jointMeasuresList, DoFVariables** axisMeasuresList, DoFVariables** jointSetpointsList, DoFVariables** axisSetpointsList, double timeDelta )
+void RunControllerStep( ControllerContext context, DoFVariables** jointMeasuresList, DoFVariables** axisMeasuresList, DoFVariables** jointSetpointsList, DoFVariables** axisSetpointsList, double timeDelta )
 {
+  ControlData* controlData = (ControlData*) context;
+  
   axisMeasuresList[ 0 ]->position = jointMeasuresList[ 0 ]->position;
   axisMeasuresList[ 0 ]->velocity = jointMeasuresList[ 0 ]->velocity;
   axisMeasuresList[ 0 ]->acceleration = jointMeasuresList[ 0 ]->acceleration;
@@ -93,26 +104,26 @@ void RunControlStep( DoFVariables** jointMeasuresList, DoFVariables** axisMeasur
   axisMeasuresList[ 0 ]->damping = jointMeasuresList[ 0 ]->damping;
   axisMeasuresList[ 0 ]->inertia = jointMeasuresList[ 0 ]->inertia;
   
-  runningTime += timeDelta;
+  controlData->runningTime += timeDelta;
 
   double totalForceSetpoint = 0.0;
   
-  if( controlState != CONTROL_OFFSET )
+  if( controlData->controlState != CONTROL_OFFSET )
   {
-    if( controlState == CONTROL_CALIBRATION ) totalForceSetpoint = 2 * sin( 2 * M_PI * runningTime / 4 );
+    if( controlData->controlState == CONTROL_CALIBRATION ) totalForceSetpoint = 2 * sin( 2 * M_PI * controlData->runningTime / 4 );
   
     double positionError = axisSetpointsList[ 0 ]->position - axisMeasuresList[ 0 ]->position;
     
-    if( controlState == CONTROL_OPERATION ) totalForceSetpoint = axisSetpointsList[ 0 ]->force + positionProportionalGain * positionError;
+    if( controlData->controlState == CONTROL_OPERATION ) totalForceSetpoint = axisSetpointsList[ 0 ]->force + controlData->positionProportionalGain * positionError;
     
     double forceError = totalForceSetpoint - axisMeasuresList[ 0 ]->force;
-    velocitySetpoint += forceProportionalGain * ( forceError - lastForceError ) + forceIntegralGain * timeDelta * forceError;
-    axisSetpointsList[ 0 ]->velocity = velocitySetpoint;
-    lastForceError = forceError;
+    controlData->velocitySetpoint += controlData->forceProportionalGain * ( forceError - controlData->lastForceError ) + controlData->forceIntegralGain * timeDelta * forceError;
+    axisSetpointsList[ 0 ]->velocity = controlData->velocitySetpoint;
+    controlData->lastForceError = forceError;
     
     fprintf( stderr, "pd=%.3f, p=%.3f, fd=%.3f, f=%.3f, fc=%.3f, k=%.1f, kp=%.1f, ki=%.1f, vd=%.3f\n", axisSetpointsList[ 0 ]->position, axisMeasuresList[ 0 ]->position,
                                                                                                        axisSetpointsList[ 0 ]->force, axisMeasuresList[ 0 ]->force, totalForceSetpoint,
-                                                                                                       positionProportionalGain, forceProportionalGain, forceIntegralGain, velocitySetpoint );
+                                                                                                       controlData->positionProportionalGain, controlData->forceProportionalGain, controlData->forceIntegralGain, controlData->velocitySetpoint );
   }
   
   jointSetpointsList[ 0 ]->position = axisSetpointsList[ 0 ]->position;
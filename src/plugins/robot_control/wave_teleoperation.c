@@ -0,0 +1,259 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file wave_teleoperation.c
+/// @brief Generic multi-DoF wave variables bilateral teleoperation controller
+///
+/// Joints are coupled in pairs, exchanging wave variables through ring-buffered delay lines (emulating transmission delays), one per pair side.
+/// Configuration string: "<default_delay_steps> <pair_1_joint_a>-<pair_1_joint_b>[@<pair_1_delay_steps>] <pair_2_joint_a>-<pair_2_joint_b>[@<pair_2_delay_steps>] ..."
+/// (e.g. "5 0-1 2-3@10"). Joints number is given by the highest listed index. Wave impedance and bandwidth factors of each pair are taken from 
+/// damping and stiffness setpoints of its first axis
+
+#include "robot_control/robot_control.h"
+#include "robot_control_extensions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define JOINTS_MAX_NUMBER 64
+#define DELAY_MAX_STEPS 10000
+
+static const double MAX_WAVE_IMPEDANCE = 10.0;
+static const double MIN_WAVE_IMPEDANCE_FACTOR = 0.1;
+
+static const double MAX_WAVE_BANDWIDTH = 0.2;
+static const double MIN_WAVE_BANDWIDTH_FACTOR = 0.1;
+static const double MAX_WAVE_BANDWIDTH_FACTOR = 1.0;
+
+// Each pair has 2 sides (one per joint), stored as structure of arrays so that per-side operations run on tight loops
+typedef struct _ControlData
+{
+  size_t jointsNumber;
+  size_t sidesNumber;
+  size_t* jointsList;                   // Joint controlled by each side
+  size_t* peerSidesList;                // Opposite side of the same pair
+  size_t* delayStepsList;               // Delay line length of each side
+  double** wavesBuffersList;            // Incoming waves, delayed
+  double** positionsBuffersList;        // Incoming positions, delayed
+  size_t setpointCount;
+  double* impedancesList;
+  double* bandwidthsList;
+  double* lastInputWavesList;
+  double* lastFilteredWavesList;
+  double* forcesList;
+  char jointNamesData[ JOINTS_MAX_NUMBER ][ 16 ];
+  const char* jointNamesList[ JOINTS_MAX_NUMBER ];
+  enum ControlState state;
+}
+ControlData;
+
+
+DECLARE_MODULE_INTERFACE( ROBOT_CONTROL_CONTEXT_INTERFACE );
+
+
+static void AddPairSide( ControlData* controlData, size_t joint, size_t peerSide, size_t delaySteps )
+{
+  size_t side = controlData->sidesNumber++;
+  controlData->jointsList[ side ] = joint;
+  controlData->peerSidesList[ side ] = peerSide;
+  controlData->delayStepsList[ side ] = delaySteps;
+  controlData->wavesBuffersList[ side ] = (double*) calloc( delaySteps, sizeof(double) );
+  controlData->positionsBuffersList[ side ] = (double*) calloc( delaySteps, sizeof(double) );
+  if( joint >= controlData->jointsNumber ) controlData->jointsNumber = joint + 1;
+}
+
+ControllerContext CreateController( const char* configurationString )
+{
+  ControlData* controlData = (ControlData*) calloc( 1, sizeof(ControlData) );
+  if( controlData == NULL ) return NULL;
+  
+  size_t maxSidesNumber = 2 * JOINTS_MAX_NUMBER;
+  controlData->jointsList = (size_t*) calloc( maxSidesNumber, sizeof(size_t) );
+  controlData->peerSidesList = (size_t*) calloc( maxSidesNumber, sizeof(size_t) );
+  controlData->delayStepsList = (size_t*) calloc( maxSidesNumber, sizeof(size_t) );
+  controlData->wavesBuffersList = (double**) calloc( maxSidesNumber, sizeof(double*) );
+  controlData->positionsBuffersList = (double**) calloc( maxSidesNumber, sizeof(double*) );
+  controlData->impedancesList = (double*) calloc( maxSidesNumber, sizeof(double) );
+  controlData->bandwidthsList = (double*) calloc( maxSidesNumber, sizeof(double) );
+  controlData->lastInputWavesList = (double*) calloc( maxSidesNumber, sizeof(double) );
+  controlData->lastFilteredWavesList = (double*) calloc( maxSidesNumber, sizeof(double) );
+  controlData->forcesList = (double*) calloc( maxSidesNumber, sizeof(double) );
+  
+  if( configurationString == NULL ) 
+  {
+    DiscardController( controlData );
+    return NULL;
+  }
+  
+  char* parameterEnd;
+  size_t defaultDelaySteps = (size_t) strtoul( configurationString, &parameterEnd, 10 );
+  while( *parameterEnd != '\0' && controlData->sidesNumber < maxSidesNumber )
+  {
+    char* pairString = parameterEnd;
+    size_t firstJoint = (size_t) strtoul( pairString, &parameterEnd, 10 );
+    if( parameterEnd == pairString || *parameterEnd != '-' ) break;
+    size_t secondJoint = (size_t) strtoul( parameterEnd + 1, &parameterEnd, 10 );
+    size_t delaySteps = defaultDelaySteps;
+    if( *parameterEnd == '@' ) delaySteps = (size_t) strtoul( parameterEnd + 1, &parameterEnd, 10 );
+    
+    if( firstJoint >= JOINTS_MAX_NUMBER || secondJoint >= JOINTS_MAX_NUMBER || firstJoint == secondJoint ||
+        delaySteps == 0 || delaySteps > DELAY_MAX_STEPS ) 
+    {
+      DiscardController( controlData );
+      return NULL;
+    }
+    
+    size_t firstSide = controlData->sidesNumber;
+    AddPairSide( controlData, firstJoint, firstSide + 1, delaySteps );
+    AddPairSide( controlData, secondJoint, firstSide, delaySteps );
+  }
+  
+  if( controlData->sidesNumber == 0 ) 
+  {
+    DiscardController( controlData );
+    return NULL;
+  }
+  
+  for( size_t jointIndex = 0; jointIndex < controlData->jointsNumber; jointIndex++ )
+  {
+    snprintf( controlData->jointNamesData[ jointIndex ], 16, "angle%lu", jointIndex + 1 );
+    controlData->jointNamesList[ jointIndex ] = controlData->jointNamesData[ jointIndex ];
+  }
+  
+  controlData->state = CONTROL_PASSIVE;
+  
+  return controlData;
+}
+
+void DiscardController( ControllerContext context )
+{
+  ControlData* controlData = (ControlData*) context;
+  
+  for( size_t side = 0; side < controlData->sidesNumber; side++ )
+  {
+    free( controlData->wavesBuffersList[ side ] );
+    free( controlData->positionsBuffersList[ side ] );
+  }
+  free( controlData->jointsList );
+  free( controlData->peerSidesList );
+  free( controlData->delayStepsList );
+  free( controlData->wavesBuffersList );
+  free( controlData->positionsBuffersList );
+  free( controlData->impedancesList );
+  free( controlData->bandwidthsList );
+  free( controlData->lastInputWavesList );
+  free( controlData->lastFilteredWavesList );
+  free( controlData->forcesList );
+  
+  free( controlData );
+}
+
+size_t GetControllerJointsNumber( ControllerContext context ) { return ((ControlData*) context)->jointsNumber; }
+
+const char** GetControllerJointNamesList( ControllerContext context ) { return ((ControlData*) context)->jointNamesList; }
+
+size_t GetControllerAxesNumber( ControllerContext context ) { return ((ControlData*) context)->jointsNumber; }
+
+const char** GetControllerAxisNamesList( ControllerContext context ) { return ((ControlData*) context)->jointNamesList; }
+
+size_t GetControllerExtraInputsNumber( ControllerContext context ) { return 0; }
+      
+void SetControllerExtraInputsList( ControllerContext context, double* inputsList ) { }
+
+size_t GetControllerExtraOutputsNumber( ControllerContext context ) { return 0; }
+         
+void GetControllerExtraOutputsList( ControllerContext context, double* outputsList ) { }
+
+void SetControllerState( ControllerContext context, enum ControlState newControlState )
+{
+  ControlData* controlData = (ControlData*) context;
+  
+  controlData->state = newControlState;
+}
+
+void RunControllerStep( ControllerContext context, DoFVariables** jointMeasuresList, DoFVariables** axisMeasuresList, DoFVariables** jointSetpointsList, DoFVariables** axisSetpointsList, double timeDelta )
+{
+  ControlData* controlData = (ControlData*) context;
+  
+  const size_t sidesNumber = controlData->sidesNumber;
+  
+  for( size_t jointIndex = 0; jointIndex < controlData->jointsNumber; jointIndex++ )
+    *(axisMeasuresList[ jointIndex ]) = *(jointMeasuresList[ jointIndex ]);
+  
+  // Wave parameters are shared by both sides of a pair, and set from its first axis
+  for( size_t side = 0; side < sidesNumber; side += 2 )
+  {
+    DoFVariables* pairSetpoints = axisSetpointsList[ controlData->jointsList[ side ] ];
+    double bandwidthFactor = fmin( fmax( pairSetpoints->stiffness, MIN_WAVE_BANDWIDTH_FACTOR ), MAX_WAVE_BANDWIDTH_FACTOR );
+    double impedanceFactor = fmax( pairSetpoints->damping, MIN_WAVE_IMPEDANCE_FACTOR );
+    controlData->bandwidthsList[ side ] = controlData->bandwidthsList[ side + 1 ] = MAX_WAVE_BANDWIDTH * bandwidthFactor;
+    controlData->impedancesList[ side ] = controlData->impedancesList[ side + 1 ] = MAX_WAVE_IMPEDANCE * impedanceFactor;
+  }
+  
+  // Incoming waves: filter, correct position drift and extract force, for all sides before any delay line is written
+  for( size_t side = 0; side < sidesNumber; side++ )
+  {
+    size_t bufferIndex = controlData->setpointCount % controlData->delayStepsList[ side ];
+    double inputWave = controlData->wavesBuffersList[ side ][ bufferIndex ];
+    double inputPosition = controlData->positionsBuffersList[ side ][ bufferIndex ];
+    DoFVariables* measures = jointMeasuresList[ controlData->jointsList[ side ] ];
+    double impedance = controlData->impedancesList[ side ];
+    double bandwidth = controlData->bandwidthsList[ side ];
+    double waveScale = sqrt( 2.0 * impedance );
+    
+    double filteredWave = ( ( 2 - bandwidth ) * controlData->lastFilteredWavesList[ side ] + bandwidth * ( inputWave + controlData->lastInputWavesList[ side ] ) ) / ( 2 + bandwidth );
+    controlData->lastInputWavesList[ side ] = inputWave;
+    controlData->lastFilteredWavesList[ side ] = filteredWave;
+    
+    double positionError = inputPosition - measures->position;
+    double waveCorrection = waveScale * bandwidth * positionError;
+    if( positionError * filteredWave < 0 ) waveCorrection = 0.0;
+    else if( fabs( waveCorrection ) > fabs( filteredWave ) ) waveCorrection = -filteredWave;
+    filteredWave += waveCorrection;
+    
+    controlData->forcesList[ side ] = -( impedance * measures->velocity - waveScale * filteredWave );
+  }
+  
+  // Outgoing waves, sent to the opposite side of each pair
+  for( size_t side = 0; side < sidesNumber; side++ )
+  {
+    size_t peerSide = controlData->peerSidesList[ side ];
+    size_t bufferIndex = controlData->setpointCount % controlData->delayStepsList[ peerSide ];
+    DoFVariables* measures = jointMeasuresList[ controlData->jointsList[ side ] ];
+    double impedance = controlData->impedancesList[ side ];
+    
+    controlData->wavesBuffersList[ peerSide ][ bufferIndex ] = ( impedance * measures->velocity - controlData->forcesList[ side ] ) / sqrt( 2.0 * impedance );
+    controlData->positionsBuffersList[ peerSide ][ bufferIndex ] = measures->position;
+  }
+  
+  for( size_t jointIndex = 0; jointIndex < controlData->jointsNumber; jointIndex++ )
+    *(jointSetpointsList[ jointIndex ]) = *(axisSetpointsList[ jointIndex ]);
+  for( size_t side = 0; side < sidesNumber; side++ )
+  {
+    size_t jointIndex = controlData->jointsList[ side ];
+    axisSetpointsList[ jointIndex ]->force = jointSetpointsList[ jointIndex ]->force = controlData->forcesList[ side ];
+  }
+  
+  controlData->setpointCount++;
+}
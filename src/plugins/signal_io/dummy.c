@@ -20,20 +20,87 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 
+
+/// @file dummy.c
+/// @brief Placeholder signal I/O device, returning random input values and discarding outputs
+///
+/// Device configuration string may set a simulated access time, as "latency=<microseconds>" (other strings, like "NULL", give no latency), optionally followed by
+/// " bus=<number>", so that all configurations with the same bus number share a single device (with the first given latency).
+/// Regular reads and writes wait for that time, while the asynchronous extension (see signal_io_extensions.h) only completes requested readings once it has passed,
+/// without ever blocking, and multi-channel writes wait for it only once
+
 #include "signal_io/signal_io.h"
+#include "signal_io_extensions.h"
 
+#include "timing/timing.h"
+
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#define DEVICES_MAX_NUMBER 64
+#define CHANNELS_MAX_NUMBER 8
+
+typedef struct _DeviceData
+{
+  size_t usersNumber;
+  int bus;
+  double latency;                                       // Access time (in seconds)
+  bool isReadPendingList[ CHANNELS_MAX_NUMBER ];
+  double readReadyTimesList[ CHANNELS_MAX_NUMBER ];
+}
+DeviceData;
+
+// Device 0 is shared by all configurations with no latency, and never used by the async requests state
+static DeviceData devicesList[ DEVICES_MAX_NUMBER ];
 
 DECLARE_MODULE_INTERFACE( SIGNAL_IO_INTERFACE );
+DECLARE_MODULE_INTERFACE( SIGNAL_IO_ASYNC_INTERFACE );
+DECLARE_MODULE_INTERFACE( SIGNAL_IO_BATCH_INTERFACE );
+
+static void WaitLatency( long int taskID )
+{
+  if( taskID <= 0 || taskID >= DEVICES_MAX_NUMBER ) return;
+  
+  double endTime = Time_GetExecSeconds() + devicesList[ taskID ].latency;
+  // Sleep for the coarse (millisecond) part and spin for the rest, for sub-millisecond precision
+  if( devicesList[ taskID ].latency > 0.002 ) Time_Delay( (unsigned long) ( 1000 * devicesList[ taskID ].latency ) - 1 );
+  while( Time_GetExecSeconds() < endTime );
+}
 
 long int InitDevice( const char* taskConfig )
 {
-  return 0;
+  double latency = 0.0;
+  int bus = 0;
+  if( taskConfig == NULL || sscanf( taskConfig, "latency=%lf bus=%d", &latency, &bus ) < 1 || latency <= 0.0 ) return 0;
+  
+  for( long int deviceIndex = 1; deviceIndex < DEVICES_MAX_NUMBER && bus > 0; deviceIndex++ )
+  {
+    if( devicesList[ deviceIndex ].usersNumber == 0 || devicesList[ deviceIndex ].bus != bus ) continue;
+    
+    devicesList[ deviceIndex ].usersNumber++;
+    return deviceIndex;
+  }
+  
+  for( long int deviceIndex = 1; deviceIndex < DEVICES_MAX_NUMBER; deviceIndex++ )
+  {
+    if( devicesList[ deviceIndex ].usersNumber > 0 ) continue;
+    
+    memset( &(devicesList[ deviceIndex ]), 0, sizeof(DeviceData) );
+    devicesList[ deviceIndex ].usersNumber = 1;
+    devicesList[ deviceIndex ].bus = bus;
+    devicesList[ deviceIndex ].latency = latency / 1e6;
+    return deviceIndex;
+  }
+  
+  return SIGNAL_IO_DEVICE_INVALID_ID;
 }
 
 void EndDevice( long int taskID )
 {
-  return;
+  if( taskID <= 0 || taskID >= DEVICES_MAX_NUMBER ) return;
+  
+  if( devicesList[ taskID ].usersNumber > 0 ) devicesList[ taskID ].usersNumber--;
 }
 
 size_t GetMaxInputSamplesNumber( long int taskID )
@@ -43,6 +110,8 @@ size_t GetMaxInputSamplesNumber( long int taskID )
 
 size_t Read( long int taskID, unsigned int channel, double* ref_value )
 {
+  WaitLatency( taskID );
+  
   *ref_value = ( rand() % 1001 ) / 1000.0 - 0.5;
 
   return 1;
@@ -65,6 +134,8 @@ bool CheckInputChannel( long int taskID, unsigned int channel )
 
 bool Write( long int taskID, unsigned int channel, double value )
 {
+  WaitLatency( taskID );
+  
   return true;
 }
 
@@ -77,3 +148,44 @@ void ReleaseOutputChannel( long int taskID, unsigned int channel )
 {
   return;
 }
+
+bool ReadAsync( long int taskID, unsigned int channel )
+{
+  if( taskID <= 0 || taskID >= DEVICES_MAX_NUMBER ) return true;
+  
+  if( channel >= CHANNELS_MAX_NUMBER ) return false;
+  
+  devicesList[ taskID ].isReadPendingList[ channel ] = true;
+  devicesList[ taskID ].readReadyTimesList[ channel ] = Time_GetExecSeconds() + devicesList[ taskID ].latency;
+  
+  return true;
+}
+
+bool PollRead( long int taskID, unsigned int channel, double* ref_value, size_t* ref_samplesNumber )
+{
+  if( taskID > 0 && taskID < DEVICES_MAX_NUMBER && channel < CHANNELS_MAX_NUMBER )
+  {
+    DeviceData* device = &(devicesList[ taskID ]);
+    if( device->isReadPendingList[ channel ] && Time_GetExecSeconds() < device->readReadyTimesList[ channel ] ) return false;
+    device->isReadPendingList[ channel ] = false;
+  }
+  
+  *ref_value = ( rand() % 1001 ) / 1000.0 - 0.5;
+  *ref_samplesNumber = 1;
+  
+  return true;
+}
+
+bool WriteAsync( long int taskID, unsigned int channel, double value )
+{
+  // Written values are discarded anyway, so queueing them never blocks
+  return true;
+}
+
+bool WriteBatch( long int taskID, unsigned int* channelsList, double* valuesList, size_t channelsNumber, double timestamp )
+{
+  // All channels are written on a single device access (real devices would stamp the frame with the given commit time)
+  WaitLatency( taskID );
+  
+  return true;
+}
@@ -0,0 +1,351 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file plant_simulator.c
+/// @brief Simulated joint dynamics, coupling written motor commands to read sensor signals, for closed-loop tests without hardware
+///
+/// Each device simulates a set of independent joints, numerically integrated at a higher internal rate than the control loop.
+/// Configuration string is made of space separated <key>=<value> entries:
+///   - joints=<n>: number of simulated joints (default 1)
+///   - rate=<hz>: internal integration rate (default 10000)
+///   - step=<seconds>: if set, simulation advances by this fixed interval on every read of input channel 0 (once per control pass, for simulated time runs).
+///     Otherwise, it advances by the system clock time passed since last read
+///   - all=<inertia>:<damping>:<stiffness>:<friction>:<backlash>: parameters for all joints (default 1:1:0:0:0)
+///   - j<i>=<inertia>:<damping>:<stiffness>:<friction>:<backlash>: parameters for joint <i>, overriding the ones above
+///   - servo=<gain>: proportional gain of the internal velocity servo (default 100)
+///
+/// For joint <i>, input channels 3*i, 3*i+1 and 3*i+2 give position, velocity and interaction (stiffness) force of the load, respectively.
+/// Output channel 2*i sets motor torque, and output channel 2*i+1 sets motor velocity, tracked by the internal servo (the last written one is used)
+///
+/// Inputs and outputs initialized with the same configuration string share the same device
+
+#include "signal_io/signal_io.h"
+
+#include "threads/threads.h"
+#include "timing/timing.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define DEVICES_MAX_NUMBER 8
+#define JOINTS_MAX_NUMBER 64
+#define CONFIG_MAX_LENGTH 512
+
+#define INPUTS_PER_JOINT 3
+#define OUTPUTS_PER_JOINT 2
+
+// Velocity under which Coulomb friction may stop (stick) the motor
+static const double STICTION_VELOCITY = 1e-4;
+// Longest interval simulated at once (avoids huge catch-up after pauses)
+static const double MAX_ADVANCE_INTERVAL = 0.1;
+
+enum { INPUT_POSITION, INPUT_VELOCITY, INPUT_FORCE };
+enum { OUTPUT_TORQUE, OUTPUT_VELOCITY };
+
+typedef struct _JointData
+{
+  double inertia, damping, stiffness, friction, backlash;
+  double motorPosition, motorVelocity;
+  double loadPosition, loadForce;
+  double command;
+  int commandType;
+}
+JointData;
+
+typedef struct _DeviceData
+{
+  char configString[ CONFIG_MAX_LENGTH ];
+  size_t usersNumber;
+  JointData jointsList[ JOINTS_MAX_NUMBER ];
+  size_t jointsNumber;
+  double integrationStep;
+  double controlStep;
+  double servoGain;
+  double lastUpdateTime;
+  ThreadLock accessLock;
+}
+DeviceData;
+
+typedef DeviceData* Device;
+
+static DeviceData devicesList[ DEVICES_MAX_NUMBER ];
+
+
+DECLARE_MODULE_INTERFACE( SIGNAL_IO_INTERFACE );
+
+
+static void IntegrateJoint( JointData* joint, double servoGain, double timeStep )
+{
+  // Backlash: load only follows motor when the gap between them is closed, and stays put otherwise
+  double halfGap = joint->backlash / 2.0;
+  bool isEngaged = true;
+  if( joint->motorPosition - joint->loadPosition > halfGap ) joint->loadPosition = joint->motorPosition - halfGap;
+  else if( joint->loadPosition - joint->motorPosition > halfGap ) joint->loadPosition = joint->motorPosition + halfGap;
+  else if( halfGap > 0.0 ) isEngaged = false;
+  
+  joint->loadForce = -joint->stiffness * joint->loadPosition;
+  
+  double motorTorque = joint->command;
+  if( joint->commandType == OUTPUT_VELOCITY ) motorTorque = servoGain * joint->inertia * ( joint->command - joint->motorVelocity );
+  
+  double netTorque = motorTorque - joint->damping * joint->motorVelocity;
+  if( isEngaged ) netTorque += joint->loadForce;
+  
+  // Coulomb friction, with stiction when (almost) stopped and not overcome
+  if( fabs( joint->motorVelocity ) < STICTION_VELOCITY && fabs( netTorque ) <= joint->friction )
+  {
+    joint->motorVelocity = 0.0;
+    return;
+  }
+  double frictionDirection = ( fabs( joint->motorVelocity ) < STICTION_VELOCITY ) ? netTorque : joint->motorVelocity;
+  netTorque -= ( frictionDirection > 0.0 ) ? joint->friction : -joint->friction;
+  
+  // Semi-implicit Euler step
+  double previousVelocity = joint->motorVelocity;
+  joint->motorVelocity += ( netTorque / joint->inertia ) * timeStep;
+  // Stop at velocity sign changes, so that friction never reverses motion by itself (sticking or slipping is decided on next step)
+  if( previousVelocity * joint->motorVelocity < 0.0 ) joint->motorVelocity = 0.0;
+  joint->motorPosition += joint->motorVelocity * timeStep;
+}
+
+static void AdvanceSimulation( Device device, double interval )
+{
+  if( interval <= 0.0 ) return;
+  if( interval > MAX_ADVANCE_INTERVAL ) interval = MAX_ADVANCE_INTERVAL;
+  
+  size_t stepsNumber = (size_t) ceil( interval / device->integrationStep );
+  double timeStep = interval / stepsNumber;
+  for( size_t stepIndex = 0; stepIndex < stepsNumber; stepIndex++ )
+  {
+    for( size_t jointIndex = 0; jointIndex < device->jointsNumber; jointIndex++ )
+      IntegrateJoint( &(device->jointsList[ jointIndex ]), device->servoGain, timeStep );
+  }
+}
+
+static void ParseJointParameters( JointData* joint, const char* parametersString )
+{
+  sscanf( parametersString, "%lf:%lf:%lf:%lf:%lf", &(joint->inertia), &(joint->damping), &(joint->stiffness), &(joint->friction), &(joint->backlash) );
+}
+
+static bool ParseConfig( Device device, const char* configString )
+{
+  char configBuffer[ CONFIG_MAX_LENGTH ];
+  strncpy( configBuffer, configString, CONFIG_MAX_LENGTH - 1 );
+  configBuffer[ CONFIG_MAX_LENGTH - 1 ] = '\0';
+  
+  device->jointsNumber = 1;
+  device->integrationStep = 0.0001;
+  device->servoGain = 100.0;
+  JointData defaultJoint = { .inertia = 1.0, .damping = 1.0 };
+  
+  // Common parameters first, so that per-joint ones may override them in any order
+  for( char* entry = strtok( configBuffer, " " ); entry != NULL; entry = strtok( NULL, " " ) )
+  {
+    char* value = strchr( entry, '=' );
+    if( value == NULL ) continue;
+    *(value++) = '\0';
+    
+    if( strcmp( entry, "joints" ) == 0 ) device->jointsNumber = (size_t) strtoul( value, NULL, 10 );
+    else if( strcmp( entry, "rate" ) == 0 ) device->integrationStep = 1.0 / strtod( value, NULL );
+    else if( strcmp( entry, "step" ) == 0 ) device->controlStep = strtod( value, NULL );
+    else if( strcmp( entry, "servo" ) == 0 ) device->servoGain = strtod( value, NULL );
+    else if( strcmp( entry, "all" ) == 0 ) ParseJointParameters( &defaultJoint, value );
+  }
+  
+  if( device->jointsNumber == 0 || device->jointsNumber > JOINTS_MAX_NUMBER ) return false;
+  if( !( device->integrationStep > 0.0 ) ) return false;
+  
+  for( size_t jointIndex = 0; jointIndex < device->jointsNumber; jointIndex++ )
+    device->jointsList[ jointIndex ] = defaultJoint;
+  
+  strncpy( configBuffer, configString, CONFIG_MAX_LENGTH - 1 );
+  for( char* entry = strtok( configBuffer, " " ); entry != NULL; entry = strtok( NULL, " " ) )
+  {
+    if( entry[ 0 ] != 'j' || entry[ 1 ] < '0' || entry[ 1 ] > '9' ) continue;
+    char* value = strchr( entry, '=' );
+    if( value == NULL ) continue;
+    
+    size_t jointIndex = (size_t) strtoul( entry + 1, NULL, 10 );
+    if( jointIndex >= device->jointsNumber ) return false;
+    ParseJointParameters( &(device->jointsList[ jointIndex ]), value + 1 );
+  }
+  
+  for( size_t jointIndex = 0; jointIndex < device->jointsNumber; jointIndex++ )
+  {
+    if( !( device->jointsList[ jointIndex ].inertia > 0.0 ) ) return false;
+  }
+  
+  return true;
+}
+
+long int InitDevice( const char* configString )
+{
+  if( configString == NULL ) configString = "";
+  
+  long int freeDeviceID = SIGNAL_IO_DEVICE_INVALID_ID;
+  for( long int deviceID = 0; deviceID < DEVICES_MAX_NUMBER; deviceID++ )
+  {
+    if( devicesList[ deviceID ].usersNumber == 0 )
+    {
+      if( freeDeviceID == SIGNAL_IO_DEVICE_INVALID_ID ) freeDeviceID = deviceID;
+    }
+    else if( strncmp( devicesList[ deviceID ].configString, configString, CONFIG_MAX_LENGTH - 1 ) == 0 )
+    {
+      devicesList[ deviceID ].usersNumber++;
+      return deviceID;
+    }
+  }
+  
+  if( freeDeviceID == SIGNAL_IO_DEVICE_INVALID_ID ) return SIGNAL_IO_DEVICE_INVALID_ID;
+  
+  Device newDevice = &(devicesList[ freeDeviceID ]);
+  memset( newDevice, 0, sizeof(DeviceData) );
+  
+  if( !ParseConfig( newDevice, configString ) )
+  {
+    memset( newDevice, 0, sizeof(DeviceData) );
+    return SIGNAL_IO_DEVICE_INVALID_ID;
+  }
+  
+  strncpy( newDevice->configString, configString, CONFIG_MAX_LENGTH - 1 );
+  newDevice->lastUpdateTime = Time_GetExecSeconds();
+  newDevice->accessLock = ThreadLock_Create();
+  newDevice->usersNumber = 1;
+  
+  return freeDeviceID;
+}
+
+void EndDevice( long int deviceID )
+{
+  if( deviceID < 0 || deviceID >= DEVICES_MAX_NUMBER ) return;
+  
+  Device device = &(devicesList[ deviceID ]);
+  if( device->usersNumber == 0 ) return;
+  
+  if( --(device->usersNumber) > 0 ) return;
+  
+  ThreadLock_Discard( device->accessLock );
+  
+  memset( device, 0, sizeof(DeviceData) );
+}
+
+size_t GetMaxInputSamplesNumber( long int deviceID )
+{
+  return 1;
+}
+
+size_t Read( long int deviceID, unsigned int channel, double* ref_value )
+{
+  if( deviceID < 0 || deviceID >= DEVICES_MAX_NUMBER ) return 0;
+  
+  Device device = &(devicesList[ deviceID ]);
+  if( channel >= device->jointsNumber * INPUTS_PER_JOINT ) return 0;
+  
+  ThreadLock_Aquire( device->accessLock );
+  
+  if( device->controlStep > 0.0 )
+  {
+    if( channel == 0 ) AdvanceSimulation( device, device->controlStep );
+  }
+  else
+  {
+    double currentTime = Time_GetExecSeconds();
+    AdvanceSimulation( device, currentTime - device->lastUpdateTime );
+    device->lastUpdateTime = currentTime;
+  }
+  
+  JointData* joint = &(device->jointsList[ channel / INPUTS_PER_JOINT ]);
+  if( channel % INPUTS_PER_JOINT == INPUT_POSITION ) *ref_value = joint->loadPosition;
+  else if( channel % INPUTS_PER_JOINT == INPUT_VELOCITY ) *ref_value = ( fabs( joint->loadPosition - joint->motorPosition ) < joint->backlash / 2.0 ) ? 0.0 : joint->motorVelocity;
+  else *ref_value = joint->loadForce;
+  
+  ThreadLock_Release( device->accessLock );
+
+  return 1;
+}
+
+bool HasError( long int deviceID )
+{
+  if( deviceID < 0 || deviceID >= DEVICES_MAX_NUMBER ) return true;
+  
+  return ( devicesList[ deviceID ].usersNumber == 0 );
+}
+
+void Reset( long int deviceID )
+{
+  if( deviceID < 0 || deviceID >= DEVICES_MAX_NUMBER ) return;
+  
+  Device device = &(devicesList[ deviceID ]);
+  if( device->usersNumber == 0 ) return;
+  
+  ThreadLock_Aquire( device->accessLock );
+  
+  for( size_t jointIndex = 0; jointIndex < device->jointsNumber; jointIndex++ )
+  {
+    JointData* joint = &(device->jointsList[ jointIndex ]);
+    joint->motorPosition = joint->motorVelocity = 0.0;
+    joint->loadPosition = joint->loadForce = 0.0;
+    joint->command = 0.0;
+  }
+  device->lastUpdateTime = Time_GetExecSeconds();
+  
+  ThreadLock_Release( device->accessLock );
+}
+
+bool CheckInputChannel( long int deviceID, unsigned int channel )
+{
+  if( deviceID < 0 || deviceID >= DEVICES_MAX_NUMBER ) return false;
+  
+  return ( channel < devicesList[ deviceID ].jointsNumber * INPUTS_PER_JOINT );
+}
+
+bool Write( long int deviceID, unsigned int channel, double value )
+{
+  if( deviceID < 0 || deviceID >= DEVICES_MAX_NUMBER ) return false;
+  
+  Device device = &(devicesList[ deviceID ]);
+  if( channel >= device->jointsNumber * OUTPUTS_PER_JOINT ) return false;
+  
+  ThreadLock_Aquire( device->accessLock );
+  
+  JointData* joint = &(device->jointsList[ channel / OUTPUTS_PER_JOINT ]);
+  joint->commandType = channel % OUTPUTS_PER_JOINT;
+  joint->command = value;
+  
+  ThreadLock_Release( device->accessLock );
+  
+  return true;
+}
+
+bool AcquireOutputChannel( long int deviceID, unsigned int channel )
+{
+  if( deviceID < 0 || deviceID >= DEVICES_MAX_NUMBER ) return false;
+  
+  return ( channel < devicesList[ deviceID ].jointsNumber * OUTPUTS_PER_JOINT );
+}
+
+void ReleaseOutputChannel( long int deviceID, unsigned int channel )
+{
+  (void) Write( deviceID, channel, 0.0 );
+}
@@ -0,0 +1,433 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file virtual_io.c
+/// @brief Simulated signal I/O device, for hardware-free load testing
+///
+/// Device behaviour is defined by a configuration string of space separated <key>=<value> entries:
+///   - channels=<n>: number of input/output channels (default 1)
+///   - samples=<n>: number of samples returned by each read (default 1, max 4096)
+///   - rate=<hz>: simulated sampling rate (default 1000)
+///   - ch<i>=<waveform>: input channel <i> generator, one of sine:<amplitude>:<frequency>[:<offset>], chirp:<amplitude>:<start_frequency>:<end_frequency>:<sweep_period>,
+///     noise:<amplitude>, file:<path> (one value per line, repeated) or loopback (position of a mass-spring-damper driven by the force written to output <i>)
+///   - plant=<mass>:<damping>:<stiffness>: loopback plant parameters (default 1:1:10)
+///   - read_latency=<distribution> and write_latency=<distribution>: time (in microseconds) spent on each access, as fixed:<t>, uniform:<min>:<max>, normal:<mean>:<deviation> or exponential:<mean>
+///   - bus=<t>: bus transfer time (in microseconds) per sample. If set, accesses to the device are serialized (bus contention)
+///
+/// Inputs and outputs initialized with the same configuration string share the same device, so that loopback channels can be driven by motor outputs
+
+#include "signal_io/signal_io.h"
+
+#include "threads/threads.h"
+#include "timing/timing.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#define DEVICES_MAX_NUMBER 32
+#define CHANNELS_MAX_NUMBER 32
+#define SAMPLES_MAX_NUMBER 4096
+#define CONFIG_MAX_LENGTH 512
+
+enum WaveformType { WAVEFORM_NONE, WAVEFORM_SINE, WAVEFORM_CHIRP, WAVEFORM_NOISE, WAVEFORM_FILE, WAVEFORM_LOOPBACK };
+
+enum LatencyType { LATENCY_NONE, LATENCY_FIXED, LATENCY_UNIFORM, LATENCY_NORMAL, LATENCY_EXPONENTIAL };
+
+typedef struct _LatencyModel
+{
+  enum LatencyType type;
+  double parametersList[ 2 ];         // Distribution parameters (in seconds)
+}
+LatencyModel;
+
+typedef struct _ChannelData
+{
+  enum WaveformType waveform;
+  double parametersList[ 4 ];
+  double* fileSamplesList;
+  size_t fileSamplesNumber;
+  size_t samplesCount;
+  double position, velocity, force;   // Loopback plant state and input
+}
+ChannelData;
+
+typedef struct _DeviceData
+{
+  char configString[ CONFIG_MAX_LENGTH ];
+  size_t usersNumber;
+  ChannelData channelsList[ CHANNELS_MAX_NUMBER ];
+  size_t channelsNumber;
+  size_t samplesPerRead;
+  double samplingInterval;
+  double mass, damping, stiffness;
+  LatencyModel readLatency, writeLatency;
+  double sampleTransferTime;
+  bool hasContention;
+  ThreadLock accessLock;
+  uint32_t randomState;
+}
+DeviceData;
+
+typedef DeviceData* Device;
+
+static DeviceData devicesList[ DEVICES_MAX_NUMBER ];
+
+
+DECLARE_MODULE_INTERFACE( SIGNAL_IO_INTERFACE );
+
+
+static double GetRandomUniform( Device device )
+{
+  // xorshift32: cheap, and independent from other users of rand()
+  device->randomState ^= device->randomState << 13;
+  device->randomState ^= device->randomState >> 17;
+  device->randomState ^= device->randomState << 5;
+  
+  return ( device->randomState >> 8 ) / (double) ( 1 << 24 );
+}
+
+static double GetRandomNormal( Device device )
+{
+  double uniform_1 = GetRandomUniform( device ) + 1e-12, uniform_2 = GetRandomUniform( device );
+  
+  return sqrt( -2.0 * log( uniform_1 ) ) * cos( 2.0 * M_PI * uniform_2 );
+}
+
+static double GetLatency( Device device, LatencyModel* model )
+{
+  double latency = 0.0;
+  
+  if( model->type == LATENCY_FIXED ) latency = model->parametersList[ 0 ];
+  else if( model->type == LATENCY_UNIFORM ) latency = model->parametersList[ 0 ] + ( model->parametersList[ 1 ] - model->parametersList[ 0 ] ) * GetRandomUniform( device );
+  else if( model->type == LATENCY_NORMAL ) latency = model->parametersList[ 0 ] + model->parametersList[ 1 ] * GetRandomNormal( device );
+  else if( model->type == LATENCY_EXPONENTIAL ) latency = -model->parametersList[ 0 ] * log( 1.0 - GetRandomUniform( device ) );
+  
+  return ( latency > 0.0 ) ? latency : 0.0;
+}
+
+static void WaitInterval( double interval )
+{
+  if( interval <= 0.0 ) return;
+  
+  double endTime = Time_GetExecSeconds() + interval;
+  // Sleep for the coarse (millisecond) part and spin for the rest, for sub-millisecond precision
+  if( interval > 0.002 ) Time_Delay( (unsigned long) ( 1000 * interval ) - 1 );
+  while( Time_GetExecSeconds() < endTime );
+}
+
+static void SimulateAccess( Device device, LatencyModel* latencyModel, size_t samplesNumber )
+{
+  double accessTime = GetLatency( device, latencyModel ) + samplesNumber * device->sampleTransferTime;
+  
+  if( !device->hasContention ) ThreadLock_Release( device->accessLock );
+  WaitInterval( accessTime );
+  if( !device->hasContention ) ThreadLock_Aquire( device->accessLock );
+}
+
+static void ParseLatencyModel( const char* modelString, LatencyModel* model )
+{
+  const char* parametersString = strchr( modelString, ':' );
+  if( parametersString == NULL ) return;
+  
+  if( strncmp( modelString, "fixed", 5 ) == 0 ) model->type = LATENCY_FIXED;
+  else if( strncmp( modelString, "uniform", 7 ) == 0 ) model->type = LATENCY_UNIFORM;
+  else if( strncmp( modelString, "normal", 6 ) == 0 ) model->type = LATENCY_NORMAL;
+  else if( strncmp( modelString, "exponential", 11 ) == 0 ) model->type = LATENCY_EXPONENTIAL;
+  
+  model->parametersList[ 0 ] = 1e-6 * strtod( parametersString + 1, (char**) &parametersString );
+  if( *parametersString == ':' ) model->parametersList[ 1 ] = 1e-6 * strtod( parametersString + 1, NULL );
+}
+
+static bool LoadWaveformFile( ChannelData* channel, const char* filePath )
+{
+  FILE* samplesFile = fopen( filePath, "r" );
+  if( samplesFile == NULL ) return false;
+  
+  size_t samplesCapacity = 0;
+  double sample;
+  while( fscanf( samplesFile, "%lf", &sample ) == 1 )
+  {
+    if( channel->fileSamplesNumber >= samplesCapacity )
+    {
+      samplesCapacity = ( samplesCapacity > 0 ) ? 2 * samplesCapacity : 1024;
+      channel->fileSamplesList = (double*) realloc( channel->fileSamplesList, samplesCapacity * sizeof(double) );
+    }
+    channel->fileSamplesList[ channel->fileSamplesNumber++ ] = sample;
+  }
+  
+  fclose( samplesFile );
+  
+  return ( channel->fileSamplesNumber > 0 );
+}
+
+static bool ParseWaveform( ChannelData* channel, const char* waveformString )
+{
+  const char* parametersString = strchr( waveformString, ':' );
+  
+  if( strncmp( waveformString, "sine", 4 ) == 0 ) channel->waveform = WAVEFORM_SINE;
+  else if( strncmp( waveformString, "chirp", 5 ) == 0 ) channel->waveform = WAVEFORM_CHIRP;
+  else if( strncmp( waveformString, "noise", 5 ) == 0 ) channel->waveform = WAVEFORM_NOISE;
+  else if( strncmp( waveformString, "loopback", 8 ) == 0 ) channel->waveform = WAVEFORM_LOOPBACK;
+  else if( strncmp( waveformString, "file", 4 ) == 0 )
+  {
+    channel->waveform = WAVEFORM_FILE;
+    return ( parametersString != NULL ) ? LoadWaveformFile( channel, parametersString + 1 ) : false;
+  }
+  else return false;
+  
+  for( size_t parameterIndex = 0; parameterIndex < 4 && parametersString != NULL && *parametersString == ':'; parameterIndex++ )
+    channel->parametersList[ parameterIndex ] = strtod( parametersString + 1, (char**) &parametersString );
+  
+  return true;
+}
+
+static double GenerateSample( Device device, ChannelData* channel )
+{
+  double sampleTime = channel->samplesCount * device->samplingInterval;
+  double amplitude = channel->parametersList[ 0 ];
+  double sample = 0.0;
+  
+  if( channel->waveform == WAVEFORM_SINE )
+    sample = amplitude * sin( 2.0 * M_PI * channel->parametersList[ 1 ] * sampleTime ) + channel->parametersList[ 2 ];
+  else if( channel->waveform == WAVEFORM_CHIRP )
+  {
+    // Linear frequency sweep, restarted every sweep period
+    double sweepPeriod = ( channel->parametersList[ 3 ] > 0.0 ) ? channel->parametersList[ 3 ] : 1.0;
+    double sweepTime = fmod( sampleTime, sweepPeriod );
+    double sweepRate = ( channel->parametersList[ 2 ] - channel->parametersList[ 1 ] ) / sweepPeriod;
+    sample = amplitude * sin( 2.0 * M_PI * ( channel->parametersList[ 1 ] * sweepTime + 0.5 * sweepRate * sweepTime * sweepTime ) );
+  }
+  else if( channel->waveform == WAVEFORM_NOISE )
+    sample = amplitude * ( 2.0 * GetRandomUniform( device ) - 1.0 );
+  else if( channel->waveform == WAVEFORM_FILE )
+    sample = channel->fileSamplesList[ channel->samplesCount % channel->fileSamplesNumber ];
+  else if( channel->waveform == WAVEFORM_LOOPBACK )
+  {
+    // Semi-implicit Euler integration, one step per sample
+    double acceleration = ( channel->force - device->damping * channel->velocity - device->stiffness * channel->position ) / device->mass;
+    channel->velocity += acceleration * device->samplingInterval;
+    channel->position += channel->velocity * device->samplingInterval;
+    sample = channel->position;
+  }
+  
+  channel->samplesCount++;
+  
+  return sample;
+}
+
+static bool ParseConfig( Device device, const char* configString )
+{
+  char configBuffer[ CONFIG_MAX_LENGTH ];
+  strncpy( configBuffer, configString, CONFIG_MAX_LENGTH - 1 );
+  configBuffer[ CONFIG_MAX_LENGTH - 1 ] = '\0';
+  
+  device->channelsNumber = 1;
+  device->samplesPerRead = 1;
+  device->samplingInterval = 0.001;
+  device->mass = 1.0;
+  device->damping = 1.0;
+  device->stiffness = 10.0;
+  
+  for( char* entry = strtok( configBuffer, " " ); entry != NULL; entry = strtok( NULL, " " ) )
+  {
+    char* value = strchr( entry, '=' );
+    if( value == NULL ) continue;
+    *(value++) = '\0';
+    
+    if( strcmp( entry, "channels" ) == 0 ) device->channelsNumber = (size_t) strtoul( value, NULL, 10 );
+    else if( strcmp( entry, "samples" ) == 0 ) device->samplesPerRead = (size_t) strtoul( value, NULL, 10 );
+    else if( strcmp( entry, "rate" ) == 0 ) device->samplingInterval = 1.0 / strtod( value, NULL );
+    else if( strcmp( entry, "read_latency" ) == 0 ) ParseLatencyModel( value, &(device->readLatency) );
+    else if( strcmp( entry, "write_latency" ) == 0 ) ParseLatencyModel( value, &(device->writeLatency) );
+    else if( strcmp( entry, "bus" ) == 0 )
+    {
+      device->sampleTransferTime = 1e-6 * strtod( value, NULL );
+      device->hasContention = true;
+    }
+    else if( strcmp( entry, "plant" ) == 0 ) sscanf( value, "%lf:%lf:%lf", &(device->mass), &(device->damping), &(device->stiffness) );
+    else if( strncmp( entry, "ch", 2 ) == 0 )
+    {
+      size_t channelIndex = (size_t) strtoul( entry + 2, NULL, 10 );
+      if( channelIndex >= CHANNELS_MAX_NUMBER ) return false;
+      if( !ParseWaveform( &(device->channelsList[ channelIndex ]), value ) ) return false;
+    }
+  }
+  
+  if( device->channelsNumber == 0 || device->channelsNumber > CHANNELS_MAX_NUMBER ) return false;
+  if( device->samplesPerRead == 0 || device->samplesPerRead > SAMPLES_MAX_NUMBER ) return false;
+  if( !( device->samplingInterval > 0.0 ) || !( device->mass > 0.0 ) ) return false;
+  
+  return true;
+}
+
+long int InitDevice( const char* configString )
+{
+  if( configString == NULL ) configString = "";
+  
+  long int freeDeviceID = SIGNAL_IO_DEVICE_INVALID_ID;
+  for( long int deviceID = 0; deviceID < DEVICES_MAX_NUMBER; deviceID++ )
+  {
+    if( devicesList[ deviceID ].usersNumber == 0 )
+    {
+      if( freeDeviceID == SIGNAL_IO_DEVICE_INVALID_ID ) freeDeviceID = deviceID;
+    }
+    else if( strncmp( devicesList[ deviceID ].configString, configString, CONFIG_MAX_LENGTH - 1 ) == 0 )
+    {
+      devicesList[ deviceID ].usersNumber++;
+      return deviceID;
+    }
+  }
+  
+  if( freeDeviceID == SIGNAL_IO_DEVICE_INVALID_ID ) return SIGNAL_IO_DEVICE_INVALID_ID;
+  
+  Device newDevice = &(devicesList[ freeDeviceID ]);
+  memset( newDevice, 0, sizeof(DeviceData) );
+  
+  if( !ParseConfig( newDevice, configString ) )
+  {
+    for( size_t channelIndex = 0; channelIndex < CHANNELS_MAX_NUMBER; channelIndex++ )
+      free( newDevice->channelsList[ channelIndex ].fileSamplesList );
+    memset( newDevice, 0, sizeof(DeviceData) );
+    return SIGNAL_IO_DEVICE_INVALID_ID;
+  }
+  
+  strncpy( newDevice->configString, configString, CONFIG_MAX_LENGTH - 1 );
+  newDevice->randomState = 2463534242u + (uint32_t) freeDeviceID;
+  newDevice->accessLock = ThreadLock_Create();
+  newDevice->usersNumber = 1;
+  
+  return freeDeviceID;
+}
+
+void EndDevice( long int deviceID )
+{
+  if( deviceID < 0 || deviceID >= DEVICES_MAX_NUMBER ) return;
+  
+  Device device = &(devicesList[ deviceID ]);
+  if( device->usersNumber == 0 ) return;
+  
+  if( --(device->usersNumber) > 0 ) return;
+  
+  for( size_t channelIndex = 0; channelIndex < CHANNELS_MAX_NUMBER; channelIndex++ )
+    free( device->channelsList[ channelIndex ].fileSamplesList );
+  
+  ThreadLock_Discard( device->accessLock );
+  
+  memset( device, 0, sizeof(DeviceData) );
+}
+
+size_t GetMaxInputSamplesNumber( long int deviceID )
+{
+  if( deviceID < 0 || deviceID >= DEVICES_MAX_NUMBER ) return 0;
+  
+  return devicesList[ deviceID ].samplesPerRead;
+}
+
+size_t Read( long int deviceID, unsigned int channel, double* ref_value )
+{
+  if( deviceID < 0 || deviceID >= DEVICES_MAX_NUMBER ) return 0;
+  
+  Device device = &(devicesList[ deviceID ]);
+  if( channel >= device->channelsNumber ) return 0;
+  
+  ThreadLock_Aquire( device->accessLock );
+  
+  SimulateAccess( device, &(device->readLatency), device->samplesPerRead );
+  
+  for( size_t sampleIndex = 0; sampleIndex < device->samplesPerRead; sampleIndex++ )
+    ref_value[ sampleIndex ] = GenerateSample( device, &(device->channelsList[ channel ]) );
+  
+  ThreadLock_Release( device->accessLock );
+
+  return device->samplesPerRead;
+}
+
+bool HasError( long int deviceID )
+{
+  if( deviceID < 0 || deviceID >= DEVICES_MAX_NUMBER ) return true;
+  
+  return ( devicesList[ deviceID ].usersNumber == 0 );
+}
+
+void Reset( long int deviceID )
+{
+  if( deviceID < 0 || deviceID >= DEVICES_MAX_NUMBER ) return;
+  
+  Device device = &(devicesList[ deviceID ]);
+  if( device->usersNumber == 0 ) return;
+  
+  ThreadLock_Aquire( device->accessLock );
+  
+  for( size_t channelIndex = 0; channelIndex < device->channelsNumber; channelIndex++ )
+  {
+    ChannelData* channel = &(device->channelsList[ channelIndex ]);
+    channel->samplesCount = 0;
+    channel->position = channel->velocity = channel->force = 0.0;
+  }
+  
+  ThreadLock_Release( device->accessLock );
+}
+
+bool CheckInputChannel( long int deviceID, unsigned int channel )
+{
+  if( deviceID < 0 || deviceID >= DEVICES_MAX_NUMBER ) return false;
+  
+  return ( channel < devicesList[ deviceID ].channelsNumber );
+}
+
+bool Write( long int deviceID, unsigned int channel, double value )
+{
+  if( deviceID < 0 || deviceID >= DEVICES_MAX_NUMBER ) return false;
+  
+  Device device = &(devicesList[ deviceID ]);
+  if( channel >= device->channelsNumber ) return false;
+  
+  ThreadLock_Aquire( device->accessLock );
+  
+  SimulateAccess( device, &(device->writeLatency), 1 );
+  
+  device->channelsList[ channel ].force = value;
+  
+  ThreadLock_Release( device->accessLock );
+  
+  return true;
+}
+
+bool AcquireOutputChannel( long int deviceID, unsigned int channel )
+{
+  return CheckInputChannel( deviceID, channel );
+}
+
+void ReleaseOutputChannel( long int deviceID, unsigned int channel )
+{
+  if( deviceID < 0 || deviceID >= DEVICES_MAX_NUMBER ) return;
+  
+  Device device = &(devicesList[ deviceID ]);
+  if( channel >= device->channelsNumber ) return;
+  
+  ThreadLock_Aquire( device->accessLock );
+  device->channelsList[ channel ].force = 0.0;
+  ThreadLock_Release( device->accessLock );
+}
@@ -0,0 +1,65 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "profiler.h"
+
+#ifdef ROBOT_PROFILING
+
+#include "timing/timing.h"
+
+const char* PROFILER_STAGE_NAMES[ PROFILER_STAGES_NUMBER ] = { [ PROFILER_IO_WAIT ] = "io_wait", [ PROFILER_EXTRA_INPUTS ] = "extra_inputs", [ PROFILER_SENSORS ] = "sensors",
+                                                               [ PROFILER_FILTERING ] = "filtering", [ PROFILER_LINEARIZATION ] = "linearization",
+                                                               [ PROFILER_CONTROL ] = "control", [ PROFILER_SETPOINTS ] = "setpoints", 
+                                                               [ PROFILER_EXTRA_OUTPUTS ] = "extra_outputs", [ PROFILER_LOGGING ] = "logging",
+                                                               [ PROFILER_SERIALIZATION ] = "serialization" };
+
+static double stageTimesList[ PROFILER_STAGES_NUMBER ];
+
+
+void Profiler_Reset( void )
+{
+  for( int stageIndex = 0; stageIndex < PROFILER_STAGES_NUMBER; stageIndex++ )
+    stageTimesList[ stageIndex ] = 0.0;
+}
+
+double Profiler_GetTime( void )
+{
+  return Time_GetExecSeconds();
+}
+
+void Profiler_RegisterStage( enum ProfilerStage stage, double* ref_markTime )
+{
+  double currentTime = Time_GetExecSeconds();
+  
+  if( stage < PROFILER_STAGES_NUMBER ) stageTimesList[ stage ] += currentTime - (*ref_markTime);
+  
+  (*ref_markTime) = currentTime;
+}
+
+double Profiler_GetStageTime( enum ProfilerStage stage )
+{
+  if( stage >= PROFILER_STAGES_NUMBER ) return 0.0;
+  
+  return stageTimesList[ stage ];
+}
+
+#endif
@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file profiler.h
+/// @brief Control pass stages execution time measurement
+///
+/// Accumulates (system clock) execution time spent on each stage of the control pass. Measurement calls are only compiled in when ROBOT_PROFILING is defined,
+/// and expand to nothing otherwise, so that regular builds have no profiling overhead
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+
+/// Control pass stages with measured execution times
+enum ProfilerStage { PROFILER_IO_WAIT, PROFILER_EXTRA_INPUTS, PROFILER_SENSORS, PROFILER_FILTERING, PROFILER_LINEARIZATION, PROFILER_CONTROL, 
+                     PROFILER_SETPOINTS, PROFILER_EXTRA_OUTPUTS, PROFILER_LOGGING, PROFILER_SERIALIZATION, PROFILER_STAGES_NUMBER };
+
+#ifdef ROBOT_PROFILING
+
+extern const char* PROFILER_STAGE_NAMES[ PROFILER_STAGES_NUMBER ];    ///< Printable (lower case) names of profiled stages
+
+/// @brief Clears accumulated execution times of all stages
+void Profiler_Reset( void );
+
+/// @brief Gets current system clock time, used as profiling start mark
+/// @return time value (in seconds)
+double Profiler_GetTime( void );
+
+/// @brief Adds time passed since given mark to specified stage total, and moves the mark to current time
+/// @param[in] stage profiled stage
+/// @param[in,out] ref_markTime pointer to time mark (in seconds) of stage start
+void Profiler_RegisterStage( enum ProfilerStage stage, double* ref_markTime );
+
+/// @brief Gets total execution time accumulated for given stage since last reset
+/// @param[in] stage profiled stage
+/// @return total stage time (in seconds)
+double Profiler_GetStageTime( enum ProfilerStage stage );
+
+#define PROFILER_START( markTime ) double markTime = Profiler_GetTime()                           ///< Declares and sets new profiling time mark
+#define PROFILER_RESTART( markTime ) markTime = Profiler_GetTime()                                ///< Sets existing time mark to current time, without registering stage
+#define PROFILER_REGISTER( stage, markTime ) Profiler_RegisterStage( stage, &(markTime) )         ///< Registers stage time since mark
+
+#else
+
+#define PROFILER_START( markTime )
+#define PROFILER_RESTART( markTime )
+#define PROFILER_REGISTER( stage, markTime )
+
+#endif
+
+#endif // PROFILER_H
@@ -28,10 +28,15 @@
 
 #include "input.h"
 #include "output.h"
+#include "clock.h"
+#include "profiler.h"
+#include "static_plugins.h"
+#include "arena.h"
+#include "capacity.h"
 
 #include "data_io/interface/data_io.h"
 #include "threads/threads.h"
-#include "timing/timing.h"
+#include "threads/semaphores.h"
 #include "debug/data_logging.h"
 
 #include "linearizer/system_linearizer.h"
@@ -39,13 +44,29 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 /////////////////////////////////////////////////////////////////////////////////
 /////                            CONTROL DEVICE                             /////
 /////////////////////////////////////////////////////////////////////////////////
 
-typedef struct _RobotData
+// Plugins implementing only the regular (global state) robot control interface are called through it with adapter functions
+typedef struct _LegacyControllerData
 {
   DECLARE_MODULE_INTERFACE_REF( ROBOT_CONTROL_INTERFACE );
+}
+LegacyControllerData;
+
+typedef LegacyControllerData* LegacyController;
+
+typedef struct _RobotData
+{
+  DECLARE_MODULE_INTERFACE_REF( ROBOT_CONTROL_CONTEXT_INTERFACE );
+  ControllerContext controller;
+  LegacyController legacyController;
   Thread controlThread;
   volatile bool isControlRunning;
   enum ControlState controlState;
@@ -57,6 +78,7 @@ typedef struct _RobotData
   size_t jointsNumber;
   DoFVariables** axisMeasuresList;
   DoFVariables** axisSetpointsList;
+  Trajectory* axisTrajectoriesList;
   size_t axesNumber;
   Input* extraInputsList;
   double* extraInputValuesList;
@@ -64,18 +86,175 @@ typedef struct _RobotData
   Output* extraOutputsList;
   double* extraOutputValuesList;
   size_t extraOutputsNumber;
+  OutputBatch outputBatch;                                   // Motor and extra outputs written together at the end of each control pass
   Log controlLog;
+  Arena arena;
+  char controllerType[ DATA_IO_MAX_PATH_LENGTH ];
+  int controlCPU;
+  bool isIOPipelined;
+  Thread ioThread;
+  volatile bool isIORunning;
+  Semaphore ioRequestSemaphore, ioCompletionSemaphore;       // Inputs prefetching handshake: both threads block (instead of spinning) while waiting
+  bool isIORequested;
 } 
 RobotData;
 
-static RobotData robot;
+#define ROBOTS_MAX_NUMBER 16
+
+// Legacy controller plugins keep their state in module-level variables, so each one may only drive a single robot per process
+static Robot legacyRobotsList[ ROBOTS_MAX_NUMBER ] = { NULL };
 
 
 const double CONTROL_PASS_DEFAULT_INTERVAL = 0.005;
+#ifdef ROBOT_FIXED_CAPACITY
+const size_t TRAJECTORY_DEFAULT_MAX_POINTS = ROBOT_MAX_TRAJECTORY_POINTS;
+const size_t ARENA_DEFAULT_SIZE = ROBOT_ARENA_SIZE;
+#else
+const size_t TRAJECTORY_DEFAULT_MAX_POINTS = 1024;
+const size_t ARENA_DEFAULT_SIZE = 1024 * 1024;
+#endif
+
+static bool RegisterLegacyRobot( Robot newRobot )
+{
+  size_t freeSlotIndex = ROBOTS_MAX_NUMBER;
+  for( size_t robotIndex = 0; robotIndex < ROBOTS_MAX_NUMBER; robotIndex++ )
+  {
+    if( legacyRobotsList[ robotIndex ] == NULL ) 
+    {
+      if( freeSlotIndex == ROBOTS_MAX_NUMBER ) freeSlotIndex = robotIndex;
+    }
+    else if( strcmp( legacyRobotsList[ robotIndex ]->controllerType, newRobot->controllerType ) == 0 )
+    {
+      DEBUG_PRINT( "legacy controller %s already in use by another robot", newRobot->controllerType );
+      return false;
+    }
+  }
+  
+  if( freeSlotIndex == ROBOTS_MAX_NUMBER ) return false;
+  
+  legacyRobotsList[ freeSlotIndex ] = newRobot;
+  
+  return true;
+}
 
+static void UnregisterLegacyRobot( Robot robot )
+{
+  for( size_t robotIndex = 0; robotIndex < ROBOTS_MAX_NUMBER; robotIndex++ )
+  {
+    if( legacyRobotsList[ robotIndex ] == robot ) legacyRobotsList[ robotIndex ] = NULL;
+  }
+}
+
+static void Legacy_DiscardController( ControllerContext controller ) { ((LegacyController) controller)->EndController(); }
+static size_t Legacy_GetJointsNumber( ControllerContext controller ) { return ((LegacyController) controller)->GetJointsNumber(); }
+static const char** Legacy_GetJointNamesList( ControllerContext controller ) { return ((LegacyController) controller)->GetJointNamesList(); }
+static size_t Legacy_GetAxesNumber( ControllerContext controller ) { return ((LegacyController) controller)->GetAxesNumber(); }
+static const char** Legacy_GetAxisNamesList( ControllerContext controller ) { return ((LegacyController) controller)->GetAxisNamesList(); }
+static size_t Legacy_GetExtraInputsNumber( ControllerContext controller ) { return ((LegacyController) controller)->GetExtraInputsNumber(); }
+static void Legacy_SetExtraInputsList( ControllerContext controller, double* inputsList ) { ((LegacyController) controller)->SetExtraInputsList( inputsList ); }
+static size_t Legacy_GetExtraOutputsNumber( ControllerContext controller ) { return ((LegacyController) controller)->GetExtraOutputsNumber(); }
+static void Legacy_GetExtraOutputsList( ControllerContext controller, double* outputsList ) { ((LegacyController) controller)->GetExtraOutputsList( outputsList ); }
+static void Legacy_SetControlState( ControllerContext controller, enum ControlState newState ) { ((LegacyController) controller)->SetControlState( newState ); }
+static void Legacy_RunControlStep( ControllerContext controller, DoFVariables** jointMeasuresList, DoFVariables** axisMeasuresList, 
+                                                                 DoFVariables** jointSetpointsList, DoFVariables** axisSetpointsList, double timeDelta )
+{
+  ((LegacyController) controller)->RunControlStep( jointMeasuresList, axisMeasuresList, jointSetpointsList, axisSetpointsList, timeDelta );
+}
+
+// Falls back to the regular robot control interface, wrapped by adapter functions with the legacy module itself as controller context
+static bool LoadLegacyController( Robot robot, const char* pluginPath )
+{
+  bool loadSuccess = false;
+  
+  if( (robot->legacyController = (LegacyController) Arena_Calloc( 1, sizeof(LegacyControllerData) )) == NULL ) return false;
+  
+  LOAD_MODULE_IMPLEMENTATION( ROBOT_CONTROL_INTERFACE, pluginPath, robot->legacyController, &loadSuccess );
+  if( !loadSuccess || !RegisterLegacyRobot( robot ) )
+  {
+    Arena_Free( robot->legacyController );
+    robot->legacyController = NULL;
+    return false;
+  }
+  
+  robot->DiscardController = Legacy_DiscardController;
+  robot->GetControllerJointsNumber = Legacy_GetJointsNumber;
+  robot->GetControllerJointNamesList = Legacy_GetJointNamesList;
+  robot->GetControllerAxesNumber = Legacy_GetAxesNumber;
+  robot->GetControllerAxisNamesList = Legacy_GetAxisNamesList;
+  robot->GetControllerExtraInputsNumber = Legacy_GetExtraInputsNumber;
+  robot->SetControllerExtraInputsList = Legacy_SetExtraInputsList;
+  robot->GetControllerExtraOutputsNumber = Legacy_GetExtraOutputsNumber;
+  robot->GetControllerExtraOutputsList = Legacy_GetExtraOutputsList;
+  robot->SetControllerState = Legacy_SetControlState;
+  robot->RunControllerStep = Legacy_RunControlStep;
+  
+  return true;
+}
+
+#ifdef ROBOT_FIXED_CAPACITY
+// Whole configuration tree is checked before any allocation, so that robots either fit in the static capacity or are not loaded at all
+static bool CheckCapacity( DataHandle configuration )
+{
+  char filePath[ DATA_IO_MAX_PATH_LENGTH ];
+  
+  size_t jointsNumber = DataIO_GetListSize( configuration, KEY_ACTUATORS );
+  if( jointsNumber > ROBOT_MAX_JOINTS )
+  {
+    DEBUG_PRINT( "%lu joints exceed capacity (%d)", jointsNumber, ROBOT_MAX_JOINTS );
+    return false;
+  }
+  
+  size_t trajectoryMaxPointsNumber = (size_t) DataIO_GetNumericValue( configuration, TRAJECTORY_DEFAULT_MAX_POINTS, KEY_TRAJECTORY "." KEY_MAX_POINTS );
+  if( trajectoryMaxPointsNumber > ROBOT_MAX_TRAJECTORY_POINTS )
+  {
+    DEBUG_PRINT( "%lu trajectory points exceed capacity (%d)", trajectoryMaxPointsNumber, ROBOT_MAX_TRAJECTORY_POINTS );
+    return false;
+  }
+  
+  bool isWithinCapacity = true;
+  for( size_t jointIndex = 0; jointIndex < jointsNumber && isWithinCapacity; jointIndex++ )
+  {
+    sprintf( filePath, KEY_CONFIG "/" KEY_ACTUATORS "/%s", DataIO_GetStringValue( configuration, "", KEY_ACTUATORS ".%lu", jointIndex ) );
+    DataHandle actuatorConfiguration = DataIO_LoadStorageData( filePath );
+    if( actuatorConfiguration == NULL ) continue;
+    
+    size_t sensorsNumber = DataIO_GetListSize( actuatorConfiguration, KEY_SENSORS );
+    if( sensorsNumber > ROBOT_MAX_SENSORS )
+    {
+      DEBUG_PRINT( "%lu sensors of actuator %lu exceed capacity (%d)", sensorsNumber, jointIndex, ROBOT_MAX_SENSORS );
+      isWithinCapacity = false;
+    }
+    
+    for( size_t sensorIndex = 0; sensorIndex < sensorsNumber && isWithinCapacity; sensorIndex++ )
+    {
+      sprintf( filePath, KEY_CONFIG "/" KEY_SENSORS "/%s", DataIO_GetStringValue( actuatorConfiguration, "", KEY_SENSORS ".%lu." KEY_CONFIG, sensorIndex ) );
+      DataHandle sensorConfiguration = DataIO_LoadStorageData( filePath );
+      if( sensorConfiguration == NULL ) continue;
+      
+      size_t inputsNumber = DataIO_GetListSize( sensorConfiguration, KEY_INPUTS );
+      if( inputsNumber > ROBOT_MAX_INPUTS )
+      {
+        DEBUG_PRINT( "%lu inputs of sensor %s exceed capacity (%d)", inputsNumber, filePath, ROBOT_MAX_INPUTS );
+        isWithinCapacity = false;
+      }
+      
+      DataIO_UnloadData( sensorConfiguration );
+    }
+    
+    DataIO_UnloadData( actuatorConfiguration );
+  }
+  
+  return isWithinCapacity;
+}
+#endif
+
+static void RunControlPass( RobotData*, double, double );
 static void* AsyncControl( void* );
+static void StartInputsPipeline( RobotData* );
+static void StopInputsPipeline( RobotData* );
+static void* AsyncInputs( void* );
 
-bool Robot_Init( const char* configName )
+Robot Robot_Init( const char* configName )
 {
   char filePath[ DATA_IO_MAX_PATH_LENGTH ];
 
@@ -83,226 +262,391 @@ bool Robot_Init( const char* configName )
   
   bool loadSuccess = false;
   
+  Robot robot = NULL;
+  
   sprintf( filePath, KEY_CONFIG "/" KEY_ROBOTS "/%s", configName );
   DataHandle configuration = DataIO_LoadStorageData( filePath );
+#ifdef ROBOT_FIXED_CAPACITY
+  if( configuration != NULL && !CheckCapacity( configuration ) )
+  {
+    DataIO_UnloadData( configuration );
+    configuration = NULL;
+  }
+#endif
   if( configuration != NULL )
   {
-    sprintf( filePath, KEY_MODULES "/" KEY_ROBOT_CONTROL "/%s", DataIO_GetStringValue( configuration, "", KEY_CONTROLLER "." KEY_TYPE ) );
-    LOAD_MODULE_IMPLEMENTATION( ROBOT_CONTROL_INTERFACE, filePath, &robot, &loadSuccess );
+    // All robot data (including actuators, sensors and motors) is taken from its own arena, in initialization order
+    Arena arena = Arena_Create( (size_t) DataIO_GetNumericValue( configuration, ARENA_DEFAULT_SIZE, KEY_MEMORY "." KEY_ARENA_SIZE ) );
+    Arena_SetCurrent( arena );
+    if( (robot = (Robot) Arena_Calloc( 1, sizeof(RobotData) )) == NULL )
+    {
+      DataIO_UnloadData( configuration );
+      Arena_SetCurrent( NULL );
+      Arena_Discard( arena );
+      return NULL;
+    }
+    robot->arena = arena;
+    
+    strncpy( robot->controllerType, DataIO_GetStringValue( configuration, "", KEY_CONTROLLER "." KEY_TYPE ), DATA_IO_MAX_PATH_LENGTH - 1 );
+    sprintf( filePath, KEY_MODULES "/" KEY_ROBOT_CONTROL "/%s", robot->controllerType );
+    LOAD_ROBOT_CONTROL_PLUGIN( robot->controllerType, filePath, robot, &loadSuccess );
+    if( !loadSuccess ) loadSuccess = LoadLegacyController( robot, filePath );
     if( loadSuccess )
     {
-      //PRINT_PLUGIN_FUNCTIONS( ROBOT_CONTROL_INTERFACE, (&robot) );
+      //PRINT_PLUGIN_FUNCTIONS( ROBOT_CONTROL_CONTEXT_INTERFACE, robot );
       const char* controllerConfigString = DataIO_GetStringValue( configuration, "", KEY_CONTROLLER "." KEY_CONFIG );
       DEBUG_PRINT( "loading controller config %s", controllerConfigString ); 
-      if( (loadSuccess = robot.InitController( controllerConfigString )) )
+      if( robot->legacyController != NULL ) 
+        robot->controller = robot->legacyController->InitController( controllerConfigString ) ? robot->legacyController : NULL;
+      else
+        robot->controller = robot->CreateController( controllerConfigString );
+      if( (loadSuccess = (robot->controller != NULL)) )
       {
-        robot.controlTimeStep = DataIO_GetNumericValue( configuration, CONTROL_PASS_DEFAULT_INTERVAL, KEY_CONTROLLER "." KEY_TIME_STEP );   
-        robot.jointsNumber = robot.GetJointsNumber();
-        robot.actuatorsList = (Actuator*) calloc( robot.jointsNumber, sizeof(Actuator) );
-        robot.jointMeasuresList = (DoFVariables**) calloc( robot.jointsNumber, sizeof(DoFVariables*) );
-        robot.jointSetpointsList = (DoFVariables**) calloc( robot.jointsNumber, sizeof(DoFVariables*) );
-        robot.jointLinearizersList = (LinearSystem*) calloc( robot.jointsNumber, sizeof(LinearSystem) );
-        DEBUG_PRINT( "found %lu joints", robot.jointsNumber );
-        for( size_t jointIndex = 0; jointIndex < robot.jointsNumber; jointIndex++ )
+        robot->controlTimeStep = DataIO_GetNumericValue( configuration, CONTROL_PASS_DEFAULT_INTERVAL, KEY_CONTROLLER "." KEY_TIME_STEP );   
+        robot->controlCPU = (int) DataIO_GetNumericValue( configuration, -1, KEY_CONTROLLER "." KEY_CPU );
+        robot->isIOPipelined = DataIO_GetBooleanValue( configuration, false, KEY_CONTROLLER "." KEY_PIPELINED_IO );
+        robot->jointsNumber = robot->GetControllerJointsNumber( robot->controller );
+        robot->actuatorsList = (Actuator*) Arena_Calloc( robot->jointsNumber, sizeof(Actuator) );
+        robot->jointMeasuresList = (DoFVariables**) Arena_Calloc( robot->jointsNumber, sizeof(DoFVariables*) );
+        robot->jointSetpointsList = (DoFVariables**) Arena_Calloc( robot->jointsNumber, sizeof(DoFVariables*) );
+        robot->jointLinearizersList = (LinearSystem*) Arena_Calloc( robot->jointsNumber, sizeof(LinearSystem) );
+        // Single block for all joint variables, measures first and then setpoints
+        DoFVariables* jointVariablesList = (DoFVariables*) Arena_Calloc( 2 * robot->jointsNumber, sizeof(DoFVariables) );
+        if( robot->actuatorsList == NULL || robot->jointMeasuresList == NULL || robot->jointSetpointsList == NULL 
+            || robot->jointLinearizersList == NULL || jointVariablesList == NULL )
+        {
+          if( robot->jointsNumber > 0 ) loadSuccess = false;
+          robot->jointsNumber = 0;
+        }
+        DEBUG_PRINT( "found %lu joints", robot->jointsNumber );
+        for( size_t jointIndex = 0; jointIndex < robot->jointsNumber; jointIndex++ )
         {
           const char* actuatorName = DataIO_GetStringValue( configuration, "", KEY_ACTUATORS ".%lu", jointIndex );
-          robot.actuatorsList[ jointIndex ] = Actuator_Init( actuatorName );
-          robot.jointMeasuresList[ jointIndex ] = (DoFVariables*) malloc( sizeof(DoFVariables) );
-          robot.jointSetpointsList[ jointIndex ] = (DoFVariables*) malloc( sizeof(DoFVariables) );
-          robot.jointLinearizersList[ jointIndex ] = SystemLinearizer_CreateSystem( 3, 1, LINEARIZATION_MAX_SAMPLES );
+          robot->actuatorsList[ jointIndex ] = Actuator_Init( actuatorName );
+          robot->jointMeasuresList[ jointIndex ] = &(jointVariablesList[ jointIndex ]);
+          robot->jointSetpointsList[ jointIndex ] = &(jointVariablesList[ robot->jointsNumber + jointIndex ]);
+          robot->jointLinearizersList[ jointIndex ] = SystemLinearizer_CreateSystem( 3, 1, LINEARIZATION_MAX_SAMPLES );
         }
 
-        robot.axesNumber = robot.GetAxesNumber();
-        robot.axisMeasuresList = (DoFVariables**) calloc( robot.axesNumber, sizeof(DoFVariables*) );
-        robot.axisSetpointsList = (DoFVariables**) calloc( robot.axesNumber, sizeof(DoFVariables*) );
-        DEBUG_PRINT( "found %lu axes", robot.axesNumber );
-        for( size_t axisIndex = 0; axisIndex < robot.axesNumber; axisIndex++ )
+        robot->axesNumber = robot->GetControllerAxesNumber( robot->controller );
+#ifdef ROBOT_FIXED_CAPACITY
+        if( robot->axesNumber > ROBOT_MAX_AXES ) 
+        {
+          DEBUG_PRINT( "%lu axes exceed capacity (%d)", robot->axesNumber, ROBOT_MAX_AXES );
+          robot->axesNumber = 0;
+          loadSuccess = false;
+        }
+#endif
+        robot->axisMeasuresList = (DoFVariables**) Arena_Calloc( robot->axesNumber, sizeof(DoFVariables*) );
+        robot->axisSetpointsList = (DoFVariables**) Arena_Calloc( robot->axesNumber, sizeof(DoFVariables*) );
+        robot->axisTrajectoriesList = (Trajectory*) Arena_Calloc( robot->axesNumber, sizeof(Trajectory) );
+        DoFVariables* axisVariablesList = (DoFVariables*) Arena_Calloc( 2 * robot->axesNumber, sizeof(DoFVariables) );
+        if( robot->axisMeasuresList == NULL || robot->axisSetpointsList == NULL || robot->axisTrajectoriesList == NULL || axisVariablesList == NULL )
+        {
+          if( robot->axesNumber > 0 ) loadSuccess = false;
+          robot->axesNumber = 0;
+        }
+        size_t trajectoryMaxPointsNumber = (size_t) DataIO_GetNumericValue( configuration, TRAJECTORY_DEFAULT_MAX_POINTS, KEY_TRAJECTORY "." KEY_MAX_POINTS );
+        DEBUG_PRINT( "found %lu axes", robot->axesNumber );
+        for( size_t axisIndex = 0; axisIndex < robot->axesNumber; axisIndex++ )
+        {
+          robot->axisMeasuresList[ axisIndex ] = &(axisVariablesList[ axisIndex ]);
+          robot->axisSetpointsList[ axisIndex ] = &(axisVariablesList[ robot->axesNumber + axisIndex ]);
+          robot->axisTrajectoriesList[ axisIndex ] = Trajectory_Create( trajectoryMaxPointsNumber );
+        }
+        
+        robot->extraInputsNumber = robot->GetControllerExtraInputsNumber( robot->controller );
+        robot->extraInputsList = (Input*) Arena_Calloc( robot->extraInputsNumber, sizeof(Input) );
+        robot->extraInputValuesList = (double*) Arena_Calloc( robot->extraInputsNumber, sizeof(double) );
+        if( robot->extraInputsList == NULL || robot->extraInputValuesList == NULL )
         {
-          robot.axisMeasuresList[ axisIndex ] = (DoFVariables*) malloc( sizeof(DoFVariables) );
-          robot.axisSetpointsList[ axisIndex ] = (DoFVariables*) malloc( sizeof(DoFVariables) );
+          if( robot->extraInputsNumber > 0 ) loadSuccess = false;
+          robot->extraInputsNumber = 0;
         }
+        for( size_t inputIndex = 0; inputIndex < robot->extraInputsNumber; inputIndex++ )
+          robot->extraInputsList[ inputIndex ] = Input_Init( DataIO_GetSubData( configuration, KEY_EXTRA_INPUTS ".%lu", inputIndex ) );
         
-        robot.extraInputsNumber = robot.GetExtraInputsNumber();
-        robot.extraInputsList = (Input*) calloc( robot.extraInputsNumber, sizeof(Input) );
-        for( size_t inputIndex = 0; inputIndex < robot.extraInputsNumber; inputIndex++ )
-          robot.extraInputsList[ inputIndex ] = Input_Init( DataIO_GetSubData( configuration, KEY_EXTRA_INPUTS ".%lu", inputIndex ) );
-        robot.extraInputValuesList = (double*) calloc( robot.extraInputsNumber, sizeof(double) );
+        robot->extraOutputsNumber = robot->GetControllerExtraOutputsNumber( robot->controller );
+        robot->extraOutputsList = (Output*) Arena_Calloc( robot->extraOutputsNumber, sizeof(Output) );
+        robot->extraOutputValuesList = (double*) Arena_Calloc( robot->extraOutputsNumber, sizeof(double) );
+        if( robot->extraOutputsList == NULL || robot->extraOutputValuesList == NULL )
+        {
+          if( robot->extraOutputsNumber > 0 ) loadSuccess = false;
+          robot->extraOutputsNumber = 0;
+        }
+        for( size_t outputIndex = 0; outputIndex < robot->extraOutputsNumber; outputIndex++ )
+          robot->extraOutputsList[ outputIndex ] = Output_Init( DataIO_GetSubData( configuration, KEY_EXTRA_OUTPUTS ".%lu", outputIndex ) );
         
-        robot.extraOutputsNumber = robot.GetExtraOutputsNumber();
-        robot.extraOutputsList = (Output*) calloc( robot.extraOutputsNumber, sizeof(Output) );
-        for( size_t outputIndex = 0; outputIndex < robot.extraOutputsNumber; outputIndex++ )
-          robot.extraOutputsList[ outputIndex ] = Output_Init( DataIO_GetSubData( configuration, KEY_EXTRA_OUTPUTS ".%lu", outputIndex ) );
-        robot.extraOutputValuesList = (double*) calloc( robot.extraOutputsNumber, sizeof(double) );
+        robot->outputBatch = OutputBatch_Init( robot->jointsNumber + robot->extraOutputsNumber );
+        if( robot->outputBatch == NULL ) loadSuccess = false;
+        for( size_t jointIndex = 0; jointIndex < robot->jointsNumber; jointIndex++ )
+          (void) Actuator_AddToBatch( robot->actuatorsList[ jointIndex ], robot->outputBatch );
+        for( size_t outputIndex = 0; outputIndex < robot->extraOutputsNumber; outputIndex++ )
+          (void) OutputBatch_AddOutput( robot->outputBatch, robot->extraOutputsList[ outputIndex ] );
         
         if( DataIO_HasKey( configuration, KEY_LOG ) )
-          robot.controlLog = Log_Init( DataIO_GetBooleanValue( configuration, false, KEY_LOG "." KEY_FILE ) ? configName : "", 
+          robot->controlLog = Log_Init( DataIO_GetBooleanValue( configuration, false, KEY_LOG "." KEY_FILE ) ? configName : "", 
                                        (size_t) DataIO_GetNumericValue( configuration, 3, KEY_LOG "." KEY_PRECISION ) );
         
-        DEBUG_PRINT( "robot %s initialized", configName );
+        DEBUG_PRINT( "robot %s initialized (%lu bytes of arena used)", configName, Arena_GetUsedSize( robot->arena ) );
       }
     }
     
     DataIO_UnloadData( configuration );
 
-    if( !loadSuccess ) Robot_End();
+    if( !loadSuccess ) 
+    {
+      Robot_End( robot );
+      robot = NULL;
+    }
+    
+    Arena_SetCurrent( NULL );
     
     // testing hack
-    //Robot_Enable();
-    //Robot_SetControlState( CONTROL_OPERATION );
+    //Robot_Enable( robot );
+    //Robot_SetControlState( robot, CONTROL_OPERATION );
   }
   
-  return loadSuccess;
+  return robot;
 }
 
-void Robot_End()
+void Robot_End( Robot robot )
 {
-  Robot_Disable();
+  if( robot == NULL ) return;
   
-  if( robot.EndController != NULL ) robot.EndController();
+  Robot_Disable( robot );
   
-  for( size_t jointIndex = 0; jointIndex < robot.jointsNumber; jointIndex++ )
-  {
-    Actuator_End( robot.actuatorsList[ jointIndex ] );
-    free( robot.jointMeasuresList[ jointIndex ] );
-    free( robot.jointSetpointsList[ jointIndex ] );
-    SystemLinearizer_DeleteSystem( robot.jointLinearizersList[ jointIndex ] );
-  }
-  free( robot.actuatorsList );
-  free( robot.jointMeasuresList );
-  free( robot.jointSetpointsList );
+  if( robot->controller != NULL ) robot->DiscardController( robot->controller );
   
-  for( size_t axisIndex = 0; axisIndex < robot.axesNumber; axisIndex++ )
+  // Memory from robot arena is released at once in the end (heap is still used for arena overflows)
+  Arena_SetCurrent( robot->arena );
+  
+  OutputBatch_End( robot->outputBatch );
+  
+  for( size_t jointIndex = 0; jointIndex < robot->jointsNumber; jointIndex++ )
   {
-    free( robot.axisMeasuresList[ axisIndex ] );
-    free( robot.axisSetpointsList[ axisIndex ] );
+    Actuator_End( robot->actuatorsList[ jointIndex ] );
+    SystemLinearizer_DeleteSystem( robot->jointLinearizersList[ jointIndex ] );
   }
-  free( robot.axisMeasuresList );
-  free( robot.axisSetpointsList );
+  if( robot->jointsNumber > 0 && robot->jointMeasuresList != NULL ) Arena_Free( robot->jointMeasuresList[ 0 ] );
+  Arena_Free( robot->actuatorsList );
+  Arena_Free( robot->jointMeasuresList );
+  Arena_Free( robot->jointSetpointsList );
+  Arena_Free( robot->jointLinearizersList );
+  
+  for( size_t axisIndex = 0; axisIndex < robot->axesNumber; axisIndex++ )
+    Trajectory_Discard( robot->axisTrajectoriesList[ axisIndex ] );
+  if( robot->axesNumber > 0 && robot->axisMeasuresList != NULL ) Arena_Free( robot->axisMeasuresList[ 0 ] );
+  Arena_Free( robot->axisMeasuresList );
+  Arena_Free( robot->axisSetpointsList );
+  Arena_Free( robot->axisTrajectoriesList );
     
-  for( size_t inputIndex = 0; inputIndex < robot.extraInputsNumber; inputIndex++ )
-    Input_End( robot.extraInputsList[ inputIndex ] );
-  if( robot.extraInputsList != NULL ) free( robot.extraInputsList );
-  if( robot.extraInputValuesList != NULL ) free( robot.extraInputValuesList );
-  
-  for( size_t outputIndex = 0; outputIndex < robot.extraOutputsNumber; outputIndex++ )
-    Output_End( robot.extraOutputsList[ outputIndex ] );
-  if( robot.extraOutputsList != NULL ) free( robot.extraOutputsList );
-  if( robot.extraOutputValuesList != NULL ) free( robot.extraOutputValuesList );
-  
-  Log_End( robot.controlLog );
-  
-  memset( &robot, 0, sizeof(RobotData) );
+  for( size_t inputIndex = 0; inputIndex < robot->extraInputsNumber; inputIndex++ )
+    Input_End( robot->extraInputsList[ inputIndex ] );
+  Arena_Free( robot->extraInputsList );
+  Arena_Free( robot->extraInputValuesList );
+  
+  for( size_t outputIndex = 0; outputIndex < robot->extraOutputsNumber; outputIndex++ )
+    Output_End( robot->extraOutputsList[ outputIndex ] );
+  Arena_Free( robot->extraOutputsList );
+  Arena_Free( robot->extraOutputValuesList );
+  
+  Log_End( robot->controlLog );
+  
+  UnregisterLegacyRobot( robot );
+  Arena_Free( robot->legacyController );
+  
+  Arena arena = robot->arena;
+  DEBUG_PRINT( "releasing robot arena (%lu bytes used, %lu heap overflows)", Arena_GetUsedSize( arena ), Arena_GetOverflowsNumber( arena ) );
+  Arena_Free( robot );
+  Arena_SetCurrent( NULL );
+  Arena_Discard( arena );
 }
 
-bool Robot_Enable()
+bool Robot_Enable( Robot robot )
 { 
-  Robot_SetControlState( CONTROL_OFFSET );
+  if( robot == NULL ) return false;
+  
+  Robot_SetControlState( robot, CONTROL_OFFSET );
   
-  for( size_t jointIndex = 0; jointIndex < robot.jointsNumber; jointIndex++ )
+  for( size_t jointIndex = 0; jointIndex < robot->jointsNumber; jointIndex++ )
   {
-    if( !Actuator_Enable( robot.actuatorsList[ jointIndex ] ) ) return false;
+    if( !Actuator_Enable( robot->actuatorsList[ jointIndex ] ) ) return false;
   }
   
-  if( !(robot.isControlRunning) )
+  if( !(robot->isControlRunning) )
   {
-    robot.controlThread = Thread_Start( AsyncControl, &robot, THREAD_JOINABLE );
+    if( robot->isIOPipelined ) StartInputsPipeline( robot );
+    
+    // On simulated time, control passes are driven externally (see Robot_Step)
+    if( Clock_GetSource() == CLOCK_SOURCE_SIMULATED )
+    {
+      robot->isControlRunning = true;
+      return true;
+    }
+    
+    robot->controlThread = Thread_Start( AsyncControl, robot, THREAD_JOINABLE );
   
-    if( robot.controlThread == THREAD_INVALID_HANDLE ) return false;
+    if( robot->controlThread == THREAD_INVALID_HANDLE ) 
+    {
+      StopInputsPipeline( robot );
+      return false;
+    }
   }
   
   return true;
 }
 
-bool Robot_Disable()
+bool Robot_Disable( Robot robot )
 {
-  if( robot.controlThread == THREAD_INVALID_HANDLE ) return false;
+  if( robot == NULL ) return false;
+  
+  if( robot->controlThread == THREAD_INVALID_HANDLE && !(robot->isControlRunning) ) return false;
+  
+  robot->isControlRunning = false;
+  if( robot->controlThread != THREAD_INVALID_HANDLE ) Thread_WaitExit( robot->controlThread, 5000 );
+  robot->controlThread = THREAD_INVALID_HANDLE;
   
-  robot.isControlRunning = false;
-  Thread_WaitExit( robot.controlThread, 5000 );
-  robot.controlThread = THREAD_INVALID_HANDLE;
+  StopInputsPipeline( robot );
   
-  for( size_t jointIndex = 0; jointIndex < robot.jointsNumber; jointIndex++ )
+  for( size_t jointIndex = 0; jointIndex < robot->jointsNumber; jointIndex++ )
   {
     DoFVariables stopSetpoints = { 0.0 };
-    (void) Actuator_SetSetpoints( robot.actuatorsList[ jointIndex ], &stopSetpoints );
+    (void) Actuator_SetSetpoints( robot->actuatorsList[ jointIndex ], &stopSetpoints );
     
-    Actuator_Disable( robot.actuatorsList[ jointIndex ] );
+    Actuator_Disable( robot->actuatorsList[ jointIndex ] );
   }
   
   return true;
 }
 
-bool Robot_SetControlState( enum ControlState newState )
+bool Robot_SetControlState( Robot robot, enum ControlState newState )
 {
-  if( newState == robot.controlState ) return false;
+  if( robot == NULL ) return false;
+  
+  if( newState == robot->controlState ) return false;
   
   if( newState >= CONTROL_STATES_NUMBER ) return false;
   
-  robot.SetControlState( newState );
+  robot->SetControllerState( robot->controller, newState );
   
-  for( size_t jointIndex = 0; jointIndex < robot.jointsNumber; jointIndex++ )
-    Actuator_SetControlState( robot.actuatorsList[ jointIndex ], newState );
+  for( size_t jointIndex = 0; jointIndex < robot->jointsNumber; jointIndex++ )
+    Actuator_SetControlState( robot->actuatorsList[ jointIndex ], newState );
   
-  robot.controlState = newState;
+  robot->controlState = newState;
   
   return true;
 }
 
-const char* Robot_GetJointName( size_t jointIndex )
+const char* Robot_GetJointName( Robot robot, size_t jointIndex )
 {
-  if( jointIndex >= robot.jointsNumber ) return NULL;
+  if( robot == NULL || jointIndex >= robot->jointsNumber ) return NULL;
   
-  const char** jointNamesList = robot.GetJointNamesList();
+  const char** jointNamesList = robot->GetControllerJointNamesList( robot->controller );
   
   if( jointNamesList == NULL ) return NULL;
   
   return jointNamesList[ jointIndex ];
 }
 
-const char* Robot_GetAxisName( size_t axisIndex )
+const char* Robot_GetAxisName( Robot robot, size_t axisIndex )
 {
-  if( axisIndex >= robot.axesNumber ) return NULL;
+  if( robot == NULL || axisIndex >= robot->axesNumber ) return NULL;
   
-  const char** axisNamesList = robot.GetAxisNamesList();
+  const char** axisNamesList = robot->GetControllerAxisNamesList( robot->controller );
   
   if( axisNamesList == NULL ) return NULL;
   
   return axisNamesList[ axisIndex ];
 }
 
-bool Robot_GetJointMeasures( size_t jointIndex, DoFVariables* ref_measures )
+bool Robot_GetJointMeasures( Robot robot, size_t jointIndex, DoFVariables* ref_measures )
 {
-  if( jointIndex >= robot.jointsNumber ) return false;
+  if( robot == NULL || jointIndex >= robot->jointsNumber ) return false;
   
-  *ref_measures = *(robot.jointMeasuresList[ jointIndex ]);
+  *ref_measures = *(robot->jointMeasuresList[ jointIndex ]);
   
   return true;
 }
 
-bool Robot_GetAxisMeasures( size_t axisIndex, DoFVariables* ref_measures )
+bool Robot_GetAxisMeasures( Robot robot, size_t axisIndex, DoFVariables* ref_measures )
+{
+  if( robot == NULL || axisIndex >= robot->axesNumber ) return false;
+  
+  *ref_measures = *(robot->axisMeasuresList[ axisIndex ]);
+  
+  return true;
+}
+
+void Robot_SetAxisSetpoints( Robot robot, size_t axisIndex, DoFVariables* ref_setpoints )
+{
+  if( robot == NULL || axisIndex >= robot->axesNumber ) return;
+  
+  *(robot->axisSetpointsList[ axisIndex ]) = *ref_setpoints;
+}
+
+size_t Robot_LoadAxisTrajectory( Robot robot, size_t axisIndex, enum TrajectoryInterpolation interpolation, size_t firstPointIndex, size_t pointsNumber, const double* timesList, const double* positionsList )
+{
+  if( robot == NULL || axisIndex >= robot->axesNumber ) return 0;
+  
+  return Trajectory_Load( robot->axisTrajectoriesList[ axisIndex ], interpolation, firstPointIndex, pointsNumber, timesList, positionsList );
+}
+
+bool Robot_StartAxisTrajectory( Robot robot, size_t axisIndex, double blendTime, bool isLooping )
+{
+  if( robot == NULL || axisIndex >= robot->axesNumber ) return false;
+  
+  return Trajectory_Start( robot->axisTrajectoriesList[ axisIndex ], blendTime, isLooping );
+}
+
+bool Robot_StopAxisTrajectory( Robot robot, size_t axisIndex )
+{
+  if( robot == NULL || axisIndex >= robot->axesNumber ) return false;
+  
+  return Trajectory_Stop( robot->axisTrajectoriesList[ axisIndex ] );
+}
+
+bool Robot_Step( Robot robot )
 {
-  if( axisIndex >= robot.axesNumber ) return false;
+  if( robot == NULL ) return false;
   
-  *ref_measures = *(robot.axisMeasuresList[ axisIndex ]);
+  if( !(robot->isControlRunning) || robot->controlThread != THREAD_INVALID_HANDLE ) return false;
+  
+  RunControlPass( robot, Clock_GetExecSeconds(), robot->controlTimeStep );
   
   return true;
 }
 
-void Robot_SetAxisSetpoints( size_t axisIndex, DoFVariables* ref_setpoints )
+double Robot_GetControlTimeStep( Robot robot )
 {
-  if( axisIndex >= robot.axesNumber ) return;
+  if( robot == NULL ) return 0.0;
   
-  *(robot.axisSetpointsList[ axisIndex ]) = *ref_setpoints;
+  return robot->controlTimeStep;
 }
 
-size_t Robot_GetJointsNumber()
+size_t Robot_GetJointsNumber( Robot robot )
 {
-  return robot.jointsNumber;
+  if( robot == NULL ) return 0;
+  
+  return robot->jointsNumber;
 }
 
-size_t Robot_GetAxesNumber()
+size_t Robot_GetAxesNumber( Robot robot )
 {
-  return robot.axesNumber;
+  if( robot == NULL ) return 0;
+  
+  return robot->axesNumber;
+}
+
+size_t Robot_GetSuppressedWritesNumber( Robot robot )
+{
+  if( robot == NULL ) return 0;
+  
+  size_t suppressedWritesNumber = 0;
+  for( size_t jointIndex = 0; jointIndex < robot->jointsNumber; jointIndex++ )
+    suppressedWritesNumber += Actuator_GetSuppressedWritesNumber( robot->actuatorsList[ jointIndex ] );
+  
+  return suppressedWritesNumber;
 }
 
 /////////////////////////////////////////////////////////////////////////////////
@@ -340,50 +684,168 @@ void LogRobotData( RobotData* robot, double execTime )
     Log_RegisterList( robot->controlLog, robot->extraOutputsNumber, robot->extraOutputValuesList );
 }
 
+static void WaitInputs( RobotData* robot )
+{
+  if( !(robot->isIORequested) ) return;
+  
+  Semaphore_Decrement( robot->ioCompletionSemaphore );
+  robot->isIORequested = false;
+}
+
+static void RequestInputs( RobotData* robot )
+{
+  robot->isIORequested = true;
+  Semaphore_Increment( robot->ioRequestSemaphore );
+}
+
+static void RunControlPass( RobotData* robot, double execTime, double elapsedTime )
+{
+  PROFILER_START( stageTime );
+  
+  // Inputs requested on the previous pass are usually ready by now, and only the remaining reading time is spent here
+  if( robot->isIORunning ) WaitInputs( robot );
+  PROFILER_REGISTER( PROFILER_IO_WAIT, stageTime );
+  
+  for( size_t inputIndex = 0; inputIndex < robot->extraInputsNumber; inputIndex++ )
+    robot->extraInputValuesList[ inputIndex ] = Input_Update( robot->extraInputsList[ inputIndex ] );
+  robot->SetControllerExtraInputsList( robot->controller, robot->extraInputValuesList );
+  PROFILER_REGISTER( PROFILER_EXTRA_INPUTS, stageTime );
+  
+  // Sensors reading and filtering stages are profiled inside actuators
+  for( size_t jointIndex = 0; jointIndex < robot->jointsNumber; jointIndex++ )
+    (void) Actuator_GetMeasures( robot->actuatorsList[ jointIndex ], robot->jointMeasuresList[ jointIndex ], elapsedTime );
+  PROFILER_RESTART( stageTime );
+
+  if( robot->controlState == CONTROL_OPERATION || robot->controlState == CONTROL_CALIBRATION )
+  {
+    for( size_t jointIndex = 0; jointIndex < robot->jointsNumber; jointIndex++ )
+      LinearizeDoF( robot->jointMeasuresList[ jointIndex ], robot->jointSetpointsList[ jointIndex ], robot->jointLinearizersList[ jointIndex ] );
+  }
+  PROFILER_REGISTER( PROFILER_LINEARIZATION, stageTime );
+  
+  // Running trajectories override kinematic setpoints, while received force/impedance setpoints are kept
+  for( size_t axisIndex = 0; axisIndex < robot->axesNumber; axisIndex++ )
+    (void) Trajectory_Evaluate( robot->axisTrajectoriesList[ axisIndex ], elapsedTime, robot->axisSetpointsList[ axisIndex ] );
+
+  CALL_ROBOT_CONTROL_FUNCTION( robot, RunControllerStep, robot->controller, robot->jointMeasuresList, robot->axisMeasuresList, robot->jointSetpointsList, robot->axisSetpointsList, elapsedTime );
+  PROFILER_REGISTER( PROFILER_CONTROL, stageTime );
+
+  // Outputs of devices with multi-channel writing are only stored here, and all committed at once below
+  OutputBatch_Begin( robot->outputBatch );
+  for( size_t jointIndex = 0; jointIndex < robot->jointsNumber; jointIndex++ )
+    (void) Actuator_SetSetpoints( robot->actuatorsList[ jointIndex ], robot->jointSetpointsList[ jointIndex ] );
+  PROFILER_REGISTER( PROFILER_SETPOINTS, stageTime );
+
+  robot->GetControllerExtraOutputsList( robot->controller, robot->extraOutputValuesList );
+  for( size_t outputIndex = 0; outputIndex < robot->extraOutputsNumber; outputIndex++ )
+    Output_Update( robot->extraOutputsList[ outputIndex ], robot->extraOutputValuesList[ outputIndex ] );
+  OutputBatch_Commit( robot->outputBatch );
+  PROFILER_REGISTER( PROFILER_EXTRA_OUTPUTS, stageTime );
+  
+  // With all outputs written, inputs for the next pass may already be read
+  if( robot->isIORunning ) RequestInputs( robot );
+  
+  LogRobotData( robot, execTime );
+  PROFILER_REGISTER( PROFILER_LOGGING, stageTime );
+}
+
 static void* AsyncControl( void* ref_robot )
 {
   RobotData* robot = (RobotData*) ref_robot;
   
-  double execTime = Time_GetExecSeconds(), elapsedTime = 0.0;
+  double execTime = Clock_GetExecSeconds(), elapsedTime = 0.0;
   
   robot->isControlRunning = true;
   
+#ifdef __linux__
+  // Keep each robot control loop on its own core, if configured, to avoid interference between concurrent robots
+  if( robot->controlCPU >= 0 )
+  {
+    cpu_set_t cpuSet;
+    CPU_ZERO( &cpuSet );
+    CPU_SET( robot->controlCPU, &cpuSet );
+    if( pthread_setaffinity_np( pthread_self(), sizeof(cpu_set_t), &cpuSet ) != 0 ) DEBUG_PRINT( "could not pin control thread to CPU %d", robot->controlCPU );
+  }
+#endif
+  
   DEBUG_PRINT( "starting to run control for robot %p on thread %lx", robot, Thread_GetID );
   
+  // Control passes are expected to run without any heap allocation (checked on ARENA_HEAP_TRAP builds)
+  Arena_SetHeapTrap( true );
+  
   while( robot->isControlRunning )
   {
-    elapsedTime = Time_GetExecSeconds() - execTime;
+    elapsedTime = Clock_GetExecSeconds() - execTime;
     
-    execTime = Time_GetExecSeconds();
+    execTime = Clock_GetExecSeconds();
     
-    for( size_t inputIndex = 0; inputIndex < robot->extraInputsNumber; inputIndex++ )
-      robot->extraInputValuesList[ inputIndex ] = Input_Update( robot->extraInputsList[ inputIndex ] );
-    robot->SetExtraInputsList( robot->extraInputValuesList );
+    RunControlPass( robot, execTime, elapsedTime );
     
-    for( size_t jointIndex = 0; jointIndex < robot->jointsNumber; jointIndex++ )
-      (void) Actuator_GetMeasures( robot->actuatorsList[ jointIndex ], robot->jointMeasuresList[ jointIndex ], elapsedTime );
-
-    if( robot->controlState == CONTROL_OPERATION || robot->controlState == CONTROL_CALIBRATION )
-    {
-      for( size_t jointIndex = 0; jointIndex < robot->jointsNumber; jointIndex++ )
-        LinearizeDoF( robot->jointMeasuresList[ jointIndex ], robot->jointSetpointsList[ jointIndex ], robot->jointLinearizersList[ jointIndex ] );
-    }
+    elapsedTime = Clock_GetExecSeconds() - execTime;
+    if( elapsedTime < robot->controlTimeStep ) Clock_Delay( robot->controlTimeStep - elapsedTime );
+    //DEBUG_PRINT( "step time for robot %p: before delay=%.5fs, after delay=%.5fs", robot, elapsedTime, Clock_GetExecSeconds() - execTime );
+  }
+  
+  Arena_SetHeapTrap( false );
+  
+  return NULL;
+}
 
-    robot->RunControlStep( robot->jointMeasuresList, robot->axisMeasuresList, robot->jointSetpointsList, robot->axisSetpointsList, elapsedTime );
+static void StartInputsPipeline( RobotData* robot )
+{
+  if( robot->ioThread != THREAD_INVALID_HANDLE ) return;
+  
+  // Besides the single pending request, the stop request may be added (see StopInputsPipeline)
+  robot->ioRequestSemaphore = Semaphore_Create( 0, 2 );
+  robot->ioCompletionSemaphore = Semaphore_Create( 0, 1 );
+  robot->isIORequested = false;
+  robot->isIORunning = true;
+  robot->ioThread = Thread_Start( AsyncInputs, robot, THREAD_JOINABLE );
+  if( robot->ioThread == THREAD_INVALID_HANDLE ) 
+  {
+    DEBUG_PRINT( "could not start inputs thread for robot %p, reading them on control passes", robot );
+    robot->isIORunning = false;
+    Semaphore_Discard( robot->ioRequestSemaphore );
+    Semaphore_Discard( robot->ioCompletionSemaphore );
+  }
+}
 
-    for( size_t jointIndex = 0; jointIndex < robot->jointsNumber; jointIndex++ )
-      (void) Actuator_SetSetpoints( robot->actuatorsList[ jointIndex ], robot->jointSetpointsList[ jointIndex ] );
+static void StopInputsPipeline( RobotData* robot )
+{
+  if( robot->ioThread == THREAD_INVALID_HANDLE ) return;
+  
+  // Inputs thread is woken up by a last (empty) request, to see that it has to stop
+  robot->isIORunning = false;
+  Semaphore_Increment( robot->ioRequestSemaphore );
+  Thread_WaitExit( robot->ioThread, 5000 );
+  robot->ioThread = THREAD_INVALID_HANDLE;
+  
+  Semaphore_Discard( robot->ioRequestSemaphore );
+  Semaphore_Discard( robot->ioCompletionSemaphore );
+}
 
-    robot->GetExtraOutputsList( robot->extraOutputValuesList );
-    for( size_t outputIndex = 0; outputIndex < robot->extraOutputsNumber; outputIndex++ )
-      Output_Update( robot->extraOutputsList[ outputIndex ], robot->extraOutputValuesList[ outputIndex ] );
+static void* AsyncInputs( void* ref_robot )
+{
+  RobotData* robot = (RobotData*) ref_robot;
+  
+  DEBUG_PRINT( "starting to read inputs for robot %p on thread %lx", robot, Thread_GetID() );
+  
+  Arena_SetHeapTrap( true );
+  
+  while( robot->isIORunning )
+  {
+    Semaphore_Decrement( robot->ioRequestSemaphore );
+    if( !(robot->isIORunning) ) break;
     
-    LogRobotData( robot, execTime );
+    for( size_t inputIndex = 0; inputIndex < robot->extraInputsNumber; inputIndex++ )
+      Input_Prefetch( robot->extraInputsList[ inputIndex ] );
+    for( size_t jointIndex = 0; jointIndex < robot->jointsNumber; jointIndex++ )
+      Actuator_PrefetchInputs( robot->actuatorsList[ jointIndex ] );
     
-    elapsedTime = Time_GetExecSeconds() - execTime;
-    if( elapsedTime < robot->controlTimeStep ) Time_Delay( (unsigned long) ( 1000 * ( robot->controlTimeStep - elapsedTime ) ) );
-    //DEBUG_PRINT( "step time for robot %p: before delay=%.5fs, after delay=%.5fs", robot, elapsedTime, Time_GetExecSeconds() - execTime );
+    Semaphore_Increment( robot->ioCompletionSemaphore );
   }
   
+  Arena_SetHeapTrap( false );
+  
   return NULL;
 }
@@ -25,7 +25,9 @@
 ///
 /// Interface for configurable robot control. Specific underlying implementation (plug-in) and further configuration are defined as explained in @ref robot_config.
 /// A robot works with 2 sets of coordinates: axes (read-write) and joints (read-only). For a detailed explanation, see @ref joint_axis_rationale.
-/// Even if RobotSystem handles one robot at a time, this code supports multiple robots for reusage in different applications.
+/// Each robot is referenced by its own handle and runs on its own control thread, so that several robots may be driven by the same process. 
+/// Controller plugins implementing the context interface (see robot_control_extensions.h) create a separate instance for each robot, while the ones implementing only the regular robot control interface
+/// keep their state in module-level variables, so that such a legacy controller type can be used by a single robot at a time.
 
 /// @page robot_config Robot Configuration
 /// The robot-level configuration (see [Configuration Levels](https://github.com/AeroTechLab/RobotSystem-Lite#robot-multi-level-configuration) is read using the [data I/O interface](https://labdin.github.io/Data-IO-Interface/data__io_8h.html). Configuration of listed joint actuators is loaded recursively (as described in @ref actuator_config)
@@ -38,7 +40,10 @@
 ///   "controller": {               // Robot controller configuration
 ///     "type": "<library_name>",   // Path (without extension, relative to MODULES_DIR/robot_control/) to plugin with robot controller implementation
 ///     "config": "",               // [o] Custom-format configuration string passed to controller (plugin) specific initialization
-///     "time_step": 0.005          // [o] Control updates time step
+///     "time_step": 0.005,         // [o] Control updates time step
+///     "cpu": -1,                  // [o] Index of processor core to which control thread is pinned (Linux only, negative for no pinning)
+///     "pipelined_io": false       // [o] Read inputs for the next control pass on a separate thread, right after outputs of the current one are written, 
+///                                 //     so that device reading latency overlaps with the rest of the pass and the wait for the next one (measures become one pass older)
 ///   },
 ///   "actuators": [                // List of robot actuators identifiers (strings) or configurations (objects)
 ///     "<actuator_1_id>",          // Actuator string identifier (configuration file name)
@@ -55,6 +60,12 @@
 ///       "interface": { ... }
 ///     }, ...
 ///   ]
+///   "trajectory": {               // [o] Preloaded axis trajectories settings
+///     "max_points": 1024          // [o] Capacity (preallocated for each axis) of trajectory points buffer (0 disables trajectory upload)
+///   },
+///   "memory": {                   // [o] Robot data allocation settings
+///     "arena_size": 1048576       // [o] Size (in bytes) of the memory block from which all robot, actuator, sensor, motor and input/output data is taken (heap is used when exceeded)
+///   },
 ///   "log": {                      // [o] Set logging of axis setpoint/measurement and extra input/output numeric data over time
 ///     "to_file": false,             // [o] Save data logging to <log_dir>/[<user_name>-]<robot_name>-<time_stamp>.log, to log file 
 ///                                   //     Default value will set terminal logging
@@ -68,65 +79,122 @@
 
 #include "robot_control/robot_control.h"
 
+#include "trajectory.h"
+
 #include <stdbool.h>
 #include <stddef.h>
 
+
+typedef struct _RobotData RobotData;    ///< Single robot internal data structure
+typedef RobotData* Robot;               ///< Opaque reference to robot internal data structure
+
                   
 /// @brief Creates and initializes robot data structure based on given information                                              
 /// @param[in] configPathName path to robot configuration, as explained at @ref robot_config
-/// @return true on successful initialization, false otherwise
-bool Robot_Init( const char* configPathName );
+/// @return reference/pointer to newly created robot data structure (NULL on errors or if its legacy controller type is already used by another robot)
+Robot Robot_Init( const char* configPathName );
 
 /// @brief Deallocates internal data of given robot                        
-void Robot_End();
+/// @param[in] robot reference to robot
+void Robot_End( Robot robot );
 
-/// @brief Initializes (if not running) update/operation thread for the given robot
+/// @brief Initializes (if not running) update/operation thread for the given robot (on simulated clock mode, control is driven by Robot_Step calls)
+/// @param[in] robot reference to robot
 /// @return true if control state was changed, false otherwise
-bool Robot_Enable();
+bool Robot_Enable( Robot robot );
                                                                  
 /// @brief Terminates (if running) update/operation thread for the given robot
+/// @param[in] robot reference to robot
 /// @return true if control state was changed, false otherwise
-bool Robot_Disable();
+bool Robot_Disable( Robot robot );
+
+/// @brief Runs a single control pass synchronously, one control time step long (for simulated clock mode, see clock.h, virtual time is advanced by the caller)
+/// @param[in] robot reference to robot
+/// @return true if control pass was executed, false if robot is not enabled or is controlled by its own update thread
+bool Robot_Step( Robot robot );
 
 /// @brief Change control state of given robot actuators and underlying (plugin) control implementation           
+/// @param[in] robot reference to robot
 /// @param[in] controlState new control state to be set
 /// @return true if control state was changed, false otherwise
-bool Robot_SetControlState( enum ControlState controlState );
+bool Robot_SetControlState( Robot robot, enum ControlState controlState );
 
 /// @brief Calls underlying (plugin) implementation to get string identifier for specified joint in given robot                
+/// @param[in] robot reference to robot
 /// @param[in] jointIndex index of robot joint (in the order listed on robot's configuration)
 /// @return pointer to string of robot joint name (NULL on errors or no joint of specified index)
-const char* Robot_GetJointName( size_t jointIndex );
+const char* Robot_GetJointName( Robot robot, size_t jointIndex );
 
 /// @brief Calls underlying (plugin) implementation to get string identifier for specified axis in given robot               
+/// @param[in] robot reference to robot
 /// @param[in] axisIndex index of robot axis (in the order listed on robot's configuration)
 /// @return pointer to string of robot axis name (NULL on errors or no axis of specified index)
-const char* Robot_GetAxisName( size_t axisIndex );
+const char* Robot_GetAxisName( Robot robot, size_t axisIndex );
 
 /// @brief Gets current value of specified joint measurements (see @ref joint_axis_rationale)          
+/// @param[in] robot reference to robot
 /// @param[in] jointIndex index of robot axis (in the order listed on robot's configuration)
 /// @param[out] ref_measures pointer/reference to variables structure where values will be stored
 /// @return true on if new values were acquired, false otherwise
-bool Robot_GetJointMeasures( size_t jointIndex, DoFVariables* ref_measures );
+bool Robot_GetJointMeasures( Robot robot, size_t jointIndex, DoFVariables* ref_measures );
 
 /// @brief Gets current value of specified axis measurements (see @ref joint_axis_rationale)          
+/// @param[in] robot reference to robot
 /// @param[in] axisIndex index of robot axis (in the order listed on robot's configuration)
 /// @param[out] ref_measures pointer/reference to variables structure where values will be stored
 /// @return true on if new values were acquired, false otherwise
-bool Robot_GetAxisMeasures( size_t axisIndex, DoFVariables* ref_measures );
+bool Robot_GetAxisMeasures( Robot robot, size_t axisIndex, DoFVariables* ref_measures );
 
 /// @brief Sets value of specified setpoint for given axis       
+/// @param[in] robot reference to robot
 /// @param[in] axisIndex index of robot axis (in the order listed on robot's configuration)
 /// @param[in] ref_setpoints pointer/reference to variables structure with the new setpoints
-void Robot_SetAxisSetpoints( size_t axisIndex, DoFVariables* ref_setpoints );
+void Robot_SetAxisSetpoints( Robot robot, size_t axisIndex, DoFVariables* ref_setpoints );
+
+/// @brief Loads points (or a chunk of points) of a trajectory for specified axis, without affecting the one currently running
+/// @param[in] robot reference to robot
+/// @param[in] axisIndex index of robot axis (in the order listed on robot's configuration)
+/// @param[in] interpolation interpolation method between loaded points
+/// @param[in] firstPointIndex index of first given point in the whole trajectory (0 starts a new upload)
+/// @param[in] pointsNumber number of given points
+/// @param[in] timesList strictly increasing points times (in seconds)
+/// @param[in] positionsList points axis positions
+/// @return total number of points loaded for next trajectory (0 on errors)
+size_t Robot_LoadAxisTrajectory( Robot robot, size_t axisIndex, enum TrajectoryInterpolation interpolation, size_t firstPointIndex, size_t pointsNumber, const double* timesList, const double* positionsList );
+
+/// @brief Starts execution of loaded trajectory for specified axis (its position, velocity and acceleration setpoints are then generated on each control pass)
+/// @param[in] robot reference to robot
+/// @param[in] axisIndex index of robot axis (in the order listed on robot's configuration)
+/// @param[in] blendTime time interval (in seconds) for smooth transition from current position setpoint to trajectory
+/// @param[in] isLooping repeat trajectory periodically, until stopped
+/// @return true if trajectory start was requested, false otherwise
+bool Robot_StartAxisTrajectory( Robot robot, size_t axisIndex, double blendTime, bool isLooping );
+
+/// @brief Stops (if running) trajectory execution for specified axis, holding its current position setpoint
+/// @param[in] robot reference to robot
+/// @param[in] axisIndex index of robot axis (in the order listed on robot's configuration)
+/// @return true if trajectory stop was requested, false otherwise
+bool Robot_StopAxisTrajectory( Robot robot, size_t axisIndex );
+
+/// @brief Gets configured control pass interval of given robot
+/// @param[in] robot reference to robot
+/// @return control time step (in seconds, 0.0 on errors)
+double Robot_GetControlTimeStep( Robot robot );
 
 /// @brief Calls underlying (plugin) implementation to get number of joint degrees-of-freedom for given robot        
+/// @param[in] robot reference to robot
 /// @return number of joint degrees-of-freedom
-size_t Robot_GetJointsNumber();
+size_t Robot_GetJointsNumber( Robot robot );
 
 /// @brief Calls underlying (plugin) implementation to get number of axis degrees-of-freedom for given robot              
+/// @param[in] robot reference to robot
 /// @return number of axis degrees-of-freedom
-size_t Robot_GetAxesNumber();
+size_t Robot_GetAxesNumber( Robot robot );
+
+/// @brief Gets total number of motor output writes skipped by all actuators of given robot, for values inside motor write deadbands
+/// @param[in] robot reference to robot
+/// @return number of suppressed writes since robot initialization
+size_t Robot_GetSuppressedWritesNumber( Robot robot );
 
 
 #endif // ROBOT_H 
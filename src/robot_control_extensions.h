@@ -0,0 +1,65 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file robot_control_extensions.h
+/// @brief Robot control plugin interface with per-robot controller contexts
+///
+/// Controller plugins implementing these functions, instead of the regular (global state) robot control interface, keep all their state in a context created for each robot, 
+/// so that the same controller type may drive several robots at once (e.g. in multi-station setups). The context returned on creation is passed to every other call.
+/// All bundled controllers implement this interface. Plugins implementing only the regular one are still loaded (dynamically), but each of them may be used by a single robot at a time
+
+#ifndef ROBOT_CONTROL_EXTENSIONS_H
+#define ROBOT_CONTROL_EXTENSIONS_H
+
+
+#include "robot_control/robot_control.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+
+typedef void* ControllerContext;      ///< Opaque reference to controller (plugin specific) per-robot data
+
+
+/// @brief Robot control functions with explicit controller context, declared with DECLARE_MODULE_INTERFACE( ROBOT_CONTROL_CONTEXT_INTERFACE ) on implementing plugins
+///
+/// ControllerContext CreateController( const char* configuration ): creates new controller instance from its configuration string, returning NULL on errors
+///
+/// void DiscardController( ControllerContext controller ): releases all controller instance data
+///
+/// Remaining functions are equivalent to the ones of the regular interface (GetJointsNumber, RunControlStep, etc.), applied to the given controller instance
+#define ROBOT_CONTROL_CONTEXT_INTERFACE( Namespace, INIT_FUNCTION ) \
+        INIT_FUNCTION( ControllerContext, Namespace, CreateController, const char* ) \
+        INIT_FUNCTION( void, Namespace, DiscardController, ControllerContext ) \
+        INIT_FUNCTION( size_t, Namespace, GetControllerJointsNumber, ControllerContext ) \
+        INIT_FUNCTION( const char**, Namespace, GetControllerJointNamesList, ControllerContext ) \
+        INIT_FUNCTION( size_t, Namespace, GetControllerAxesNumber, ControllerContext ) \
+        INIT_FUNCTION( const char**, Namespace, GetControllerAxisNamesList, ControllerContext ) \
+        INIT_FUNCTION( size_t, Namespace, GetControllerExtraInputsNumber, ControllerContext ) \
+        INIT_FUNCTION( void, Namespace, SetControllerExtraInputsList, ControllerContext, double* ) \
+        INIT_FUNCTION( size_t, Namespace, GetControllerExtraOutputsNumber, ControllerContext ) \
+        INIT_FUNCTION( void, Namespace, GetControllerExtraOutputsList, ControllerContext, double* ) \
+        INIT_FUNCTION( void, Namespace, SetControllerState, ControllerContext, enum ControlState ) \
+        INIT_FUNCTION( void, Namespace, RunControllerStep, ControllerContext, DoFVariables**, DoFVariables**, DoFVariables**, DoFVariables**, double )
+
+
+#endif // ROBOT_CONTROL_EXTENSIONS_H
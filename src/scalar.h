@@ -0,0 +1,68 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file scalar.h
+/// @brief Floating-point type for internal processing kernels
+///
+/// Only three kernels use the Scalar type for their state and intermediate values: control laws of the ImpedanceControl plugin, input envelope filters (see input.c)
+/// and actuator inner loop PIDs (see actuator.c). It is double precision by default, and single precision when building with ROBOT_SINGLE_PRECISION defined, for 
+/// targets with weak double precision arithmetic (where vectorized loops also process twice as many values per instruction). 
+/// The rest of the control pass data path (DoFVariables, signal I/O samples, sensor transforms, Kalman filter state estimation, linearizers and trajectories) 
+/// is always double precision, and conversions happen on kernel boundaries.
+///
+/// ROBOT_REFERENCE_PRECISION forces double precision even with ROBOT_SINGLE_PRECISION defined, for reference builds used in accuracy comparisons.
+
+#ifndef SCALAR_H
+#define SCALAR_H
+
+
+#include <math.h>
+
+
+#if defined( ROBOT_SINGLE_PRECISION ) && !defined( ROBOT_REFERENCE_PRECISION )
+
+typedef float Scalar;             ///< Single precision processing type
+
+#define SCALAR_ABS fabsf          ///< Absolute value function for Scalar type
+
+#else
+
+typedef double Scalar;            ///< Double precision processing type
+
+#define SCALAR_ABS fabs           ///< Absolute value function for Scalar type
+
+#endif
+
+// Widest vector registers for which code is being built (AVX, or SSE2/NEON otherwise)
+#if defined( __AVX__ )
+  #define SCALAR_VECTOR_SIZE 32
+#else
+  #define SCALAR_VECTOR_SIZE 16
+#endif
+
+#define SCALAR_LANES_NUMBER ( SCALAR_VECTOR_SIZE / sizeof(Scalar) )     ///< Number of Scalar values processed at once by vectorized loops
+
+/// Rounds given number of values up to a multiple of vector lanes, so that kernel loops over padded arrays have no scalar remainder iterations
+#define SCALAR_PADDED_LENGTH( length ) ( ( ( length ) + SCALAR_LANES_NUMBER - 1 ) / SCALAR_LANES_NUMBER * SCALAR_LANES_NUMBER )
+
+
+#endif // SCALAR_H
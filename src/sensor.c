@@ -23,15 +23,18 @@
 #include "sensor.h"
 
 #include "input.h"
+#include "clock.h"
+#include "arena.h"
 
 #include "tinyexpr/tinyexpr.h"
 
 #include "data_io/interface/data_io.h" 
 #include "debug/data_logging.h"
-#include "timing/timing.h"
 
 #include "config_keys.h"
 
+#include "compiled_config.h"
+
 #include <math.h>
 #include <stdio.h>
 #include <stdbool.h>
@@ -47,6 +50,9 @@ struct _SensorData
   double* inputValuesList;
   te_variable* inputVariables;
   te_expr* transformFunction;
+  CompiledSensorUpdate CompiledUpdate;
+  size_t updatesCount, samplesCount;
+  double firstSampleTime, lastSampleTime, maxSampleInterval;
   Log log;
 };
 
@@ -58,15 +64,25 @@ Sensor Sensor_Init( const char* configName )
   DataHandle configuration = DataIO_LoadStorageData( filePath );
   if( configuration == NULL ) return NULL;
   //DEBUG_PRINT( "sensor configuration found on data handle %p", configuration );
-  Sensor newSensor = (Sensor) malloc( sizeof(SensorData) );
-  memset( newSensor, 0, sizeof(SensorData) );  
+  Sensor newSensor = (Sensor) Arena_Calloc( 1, sizeof(SensorData) );
+  if( newSensor == NULL )
+  {
+    DataIO_UnloadData( configuration );
+    return NULL;
+  }
   
   bool loadSuccess = true;
   DEBUG_PRINT( "inputs number: %lu", DataIO_GetListSize( configuration, KEY_INPUTS ) );
   newSensor->inputsNumber = DataIO_GetListSize( configuration, KEY_INPUTS );
-  newSensor->inputsList = (Input*) calloc( newSensor->inputsNumber, sizeof(Input) );
-  newSensor->inputValuesList = (double*) calloc( newSensor->inputsNumber, sizeof(double) );
-  newSensor->inputVariables = (te_variable*) calloc( newSensor->inputsNumber, sizeof(te_variable) );
+  newSensor->inputsList = (Input*) Arena_Calloc( newSensor->inputsNumber, sizeof(Input) );
+  newSensor->inputValuesList = (double*) Arena_Calloc( newSensor->inputsNumber, sizeof(double) );
+  newSensor->inputVariables = (te_variable*) Arena_Calloc( newSensor->inputsNumber, sizeof(te_variable) );
+  if( newSensor->inputsList == NULL || newSensor->inputValuesList == NULL || newSensor->inputVariables == NULL )
+  {
+    // No input gets initialized over partially allocated lists
+    if( newSensor->inputsNumber > 0 ) loadSuccess = false;
+    newSensor->inputsNumber = 0;
+  }
   for( size_t inputIndex = 0; inputIndex < newSensor->inputsNumber; inputIndex++ )
   {
     newSensor->inputsList[ inputIndex ] = Input_Init( DataIO_GetSubData( configuration, KEY_INPUTS ".%lu", inputIndex ) );
@@ -82,6 +98,13 @@ Sensor Sensor_Init( const char* configName )
   newSensor->transformFunction = te_compile( transformExpression, newSensor->inputVariables, newSensor->inputsNumber, &expressionError );
   if( expressionError > 0 ) loadSuccess = false;
   DEBUG_PRINT( "transform function: out= %s (error: %d)", transformExpression, expressionError );    
+#ifdef COMPILED_CONFIG
+  // Build-time translated transform is used only if generated from the same configuration
+  const CompiledSensor* compiledSensor = CompiledConfig_GetSensor( configName );
+  if( compiledSensor != NULL && compiledSensor->inputsNumber == newSensor->inputsNumber && strcmp( compiledSensor->expression, transformExpression ) == 0 )
+    newSensor->CompiledUpdate = compiledSensor->Update;
+  else DEBUG_PRINT( "no up-to-date compiled transform for sensor %s", configName );
+#endif
   if( DataIO_HasKey( configuration, KEY_LOG ) )
     newSensor->log = Log_Init( DataIO_GetBooleanValue( configuration, false, KEY_LOG "." KEY_FILE ) ? configName : "", 
                                (size_t) DataIO_GetNumericValue( configuration, 3, KEY_LOG "." KEY_PRECISION ) );
@@ -101,35 +124,88 @@ void Sensor_End( Sensor sensor )
 {
   if( sensor == NULL ) return;
   
+  DEBUG_PRINT( "sensor %p: %lu new samples on %lu updates (%g Hz, max interval %g s)", sensor, sensor->samplesCount, sensor->updatesCount, 
+               Sensor_GetSampleRate( sensor ), sensor->maxSampleInterval );
+  
   for( size_t inputIndex = 0; inputIndex < sensor->inputsNumber; inputIndex++ )
     Input_End( sensor->inputsList[ inputIndex ] );
-  free( sensor->inputsList );
-  free( sensor->inputValuesList );
-  free( sensor->inputVariables );
+  Arena_Free( sensor->inputsList );
+  Arena_Free( sensor->inputValuesList );
+  Arena_Free( sensor->inputVariables );
   
   if( sensor->transformFunction != NULL ) te_free( sensor->transformFunction );
   
   Log_End( sensor->log );
   
-  free( sensor );
+  Arena_Free( sensor );
 }
 
-double Sensor_Update( Sensor sensor )
+static void RegisterSample( Sensor sensor, bool* ref_hasNewSample )
 {
-  if( sensor == NULL ) return 0.0;
+  sensor->updatesCount++;
+  
+  // Sensor value changes with new samples of any of its inputs
+  bool hasNewSample = ( sensor->inputsNumber == 0 );
+  for( size_t inputIndex = 0; inputIndex < sensor->inputsNumber; inputIndex++ )
+    if( Input_HasNewSamples( sensor->inputsList[ inputIndex ] ) ) hasNewSample = true;
+  
+  if( hasNewSample )
+  {
+    double sampleTime = Clock_GetExecSeconds();
+    if( sensor->samplesCount == 0 ) sensor->firstSampleTime = sampleTime;
+    else if( sampleTime - sensor->lastSampleTime > sensor->maxSampleInterval ) sensor->maxSampleInterval = sampleTime - sensor->lastSampleTime;
+    sensor->lastSampleTime = sampleTime;
+    sensor->samplesCount++;
+  }
+  
+  if( ref_hasNewSample != NULL ) *ref_hasNewSample = hasNewSample;
+}
+
+double Sensor_Update( Sensor sensor, bool* ref_hasNewSample )
+{
+  if( sensor == NULL ) 
+  {
+    if( ref_hasNewSample != NULL ) *ref_hasNewSample = false;
+    return 0.0;
+  }
+  
+  if( sensor->CompiledUpdate != NULL ) 
+  {
+    double sensorOutput = sensor->CompiledUpdate( sensor->inputsList );
+    RegisterSample( sensor, ref_hasNewSample );
+    return sensorOutput;
+  }
   
   for( size_t inputIndex = 0; inputIndex < sensor->inputsNumber; inputIndex++ )
     sensor->inputValuesList[ inputIndex ] = Input_Update( sensor->inputsList[ inputIndex ] );
+  RegisterSample( sensor, ref_hasNewSample );
    
   double sensorOutput = te_eval( sensor->transformFunction );
   //if( sensor->inputsNumber > 1 ) DEBUG_PRINT( "in0=%.5f, in1=%.5f, out=%.5f", sensor->inputValuesList[ 0 ], sensor->inputValuesList[ 1 ], sensorOutput );
-  //Log_EnterNewLine( sensor->log, Time_GetExecSeconds() );
+  //Log_EnterNewLine( sensor->log, Clock_GetExecSeconds() );
   //Log_RegisterList( sensor->log, sensor->inputsNumber, sensor->inputValuesList );
   //Log_RegisterValues( sensor->log, 1, sensorOutput ); 
   
   return sensorOutput;
 }
 
+double Sensor_GetSampleRate( Sensor sensor )
+{
+  if( sensor == NULL ) return 0.0;
+  
+  if( sensor->samplesCount < 2 || sensor->lastSampleTime <= sensor->firstSampleTime ) return 0.0;
+  
+  return ( sensor->samplesCount - 1 ) / ( sensor->lastSampleTime - sensor->firstSampleTime );
+}
+
+void Sensor_PrefetchInputs( Sensor sensor )
+{
+  if( sensor == NULL ) return;
+  
+  for( size_t inputIndex = 0; inputIndex < sensor->inputsNumber; inputIndex++ )
+    Input_Prefetch( sensor->inputsList[ inputIndex ] );
+}
+
 void SetState( Sensor sensor, enum SigProcState newProcessingState )
 {
   if( sensor == NULL ) return;
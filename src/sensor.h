@@ -45,6 +45,12 @@
 ///         "normalized": false,                    // [o] Normalize signal (after calibration) if true
 ///         "min_frequency": -1.0                   // [o] Low-pass filter cutoff frequency, relative to (factor of) the sampling frequency (negative for no filtering)
 ///         "max_frequency": -1.0                   // [o] High-pass filter cutoff frequency, relative to (factor of) the sampling frequency (negative for no filtering)
+///       },
+///       "acquisition": {                        // [o] Read full rate signal on separate (shared) thread, extracting its envelope (e.g. for EMG): band-pass -> rectify -> low-pass -> decimate
+///         "min_frequency": -1.0,                  // [o] Band-pass filter lower cutoff frequency, relative to the sampling frequency (negative for no filtering)
+///         "max_frequency": -1.0,                  // [o] Band-pass filter upper cutoff frequency, relative to the sampling frequency (negative for no filtering)
+///         "envelope_frequency": -1.0,             // [o] Envelope low-pass filter cutoff frequency, relative to the sampling frequency (negative for no filtering)
+///         "decimation": 1                         // [o] Envelope is published once every <decimation> samples, and the latest value is picked up by each input update
 ///       }
 ///     }, ...
 ///   ],
@@ -80,8 +86,18 @@ void Sensor_End( Sensor sensor );
 
 /// @brief Performs single reading and processing of signal measured by given sensor
 /// @param[in] sensor reference to sensor
+/// @param[out] ref_hasNewSample pointer to flag set if any sensor input got new samples (NULL if not needed)
 /// @return current value of processed signal (0.0 on erros)
-double Sensor_Update( Sensor sensor );
+double Sensor_Update( Sensor sensor, bool* ref_hasNewSample );
+
+/// @brief Gets rate of new samples of given sensor, from its updates since initialization
+/// @param[in] sensor reference to sensor
+/// @return average number of new samples per second (0.0 if not enough samples)
+double Sensor_GetSampleRate( Sensor sensor );
+
+/// @brief Reads raw samples of all inputs of given sensor ahead of its next update (see Input_Prefetch)
+/// @param[in] sensor reference to sensor
+void Sensor_PrefetchInputs( Sensor sensor );
 
 /// @brief Calls underlying signal reading implementation (plugin) to check for errors on given sensor              
 /// @param[in] sensor reference to sensor
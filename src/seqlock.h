@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file seqlock.h
+/// @brief Sequence lock for lock-free single writer/multiple readers data publishing
+///
+/// The writer increments a sequence counter before and after updating shared data. Readers never block the writer: they copy the data and retry 
+/// if the counter was odd (write in progress) or changed during the copy. Suitable for small, frequently updated data (like latest measurements or setpoints)
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined( _MSC_VER )
+  #include <windows.h>
+  #define SEQLOCK_BARRIER() MemoryBarrier()
+#else
+  #define SEQLOCK_BARRIER() __sync_synchronize()
+#endif
+
+
+typedef struct _SeqLock 
+{ 
+  volatile uint32_t sequence; 
+} 
+SeqLock;                        ///< Sequence lock (zero initialized)
+
+
+/// @brief Marks start of shared data update (only one writer thread allowed)
+/// @param[in] lock pointer to sequence lock protecting the data
+static inline void SeqLock_BeginWrite( SeqLock* lock )
+{
+  lock->sequence++;
+  SEQLOCK_BARRIER();
+}
+
+/// @brief Marks end of shared data update, publishing it to readers
+/// @param[in] lock pointer to sequence lock protecting the data
+static inline void SeqLock_EndWrite( SeqLock* lock )
+{
+  SEQLOCK_BARRIER();
+  lock->sequence++;
+}
+
+/// @brief Marks start of shared data copy, waiting for any write in progress
+/// @param[in] lock pointer to sequence lock protecting the data
+/// @return sequence value to be checked at end of copy
+static inline uint32_t SeqLock_BeginRead( const SeqLock* lock )
+{
+  uint32_t sequence;
+  while( (sequence = lock->sequence) & 1 );
+  SEQLOCK_BARRIER();
+  
+  return sequence;
+}
+
+/// @brief Checks if shared data copy was consistent (not concurrent with any write)
+/// @param[in] lock pointer to sequence lock protecting the data
+/// @param[in] sequence value returned by read start call
+/// @return true if copy is valid, false if it must be retried
+static inline bool SeqLock_EndRead( const SeqLock* lock, uint32_t sequence )
+{
+  SEQLOCK_BARRIER();
+  
+  return ( lock->sequence == sequence );
+}
+
+
+#endif // SEQLOCK_H
@@ -42,8 +42,9 @@ enum RobotControlCode {
        ROBOT_REQ_GET_CONFIG,
        /// Reply code for ROBOT_REQ_GET_CONFIG. Followed, in the same message, by a JSON-format string like:
        /// @code
-       /// { "id":"<robot_name>", "axes":[ "<axis1_name>", "<axis2_name>" ], "joints":[ "<joint1_name>", "<joint2_name>" ] }
+       /// { "id":"<robot_name>", "axes":[ "<axis1_name>", "<axis2_name>" ], "joints":[ "<joint1_name>", "<joint2_name>" ], "first_axis":0 }
        /// @endcode
+       /// Where "first_axis" is the index, on axes update messages, of the robot first axis (axes of all robots driven by the same process are listed in sequence)
        ROBOT_REP_GOT_CONFIG = ROBOT_REQ_GET_CONFIG,
        ROBOT_REQ_SET_CONFIG,                            ///< Request setting new @ref robot_config, reloading all parameters. Must be followed, in the same message, by a string with the new @ref robot_config name
        ROBOT_REP_CONFIG_SET = ROBOT_REQ_SET_CONFIG,     ///< Confirmation reply to ROBOT_REQ_SET_CONFIG. Followed by the same JSON string type as in ROBOT_REP_GOT_CONFIG
@@ -64,7 +65,30 @@ enum RobotControlCode {
        ROBOT_REQ_PREPROCESS,                            ///< Request setting robot to implementation-specific pre-operation state (passed on to control implementation)
        ROBOT_REP_PREPROCESSING = ROBOT_REQ_PREPROCESS,  ///< Confirmation reply to ROBOT_REQ_PREPROCESS
        ROBOT_REQ_RESET,                                 ///< Clear errors and calibration values for the robot of corresponding index
-       ROBOT_REP_ERROR = ROBOT_REQ_RESET                ///< Robot error/failure signal, can come before ROBOT_REQ_RESET
+       ROBOT_REP_ERROR = ROBOT_REQ_RESET,               ///< Robot error/failure signal, can come before ROBOT_REQ_RESET
+       /// Request loading (part of) a time-parameterized trajectory for a single axis, to be executed on the robot side instead of streaming setpoints. Must be followed, in the same message, by:
+       ///
+       /// Axis Index | Interpolation |  First Point Index  | Points Number | Time 1  | Position 1 | Time 2  | ...
+       /// :--------: | :-----------: | :-----------------: | :-----------: | :-----: | :--------: | :-----: | :-:
+       ///   1 byte   |    1 byte     | 2 bytes (LSB first) |    1 byte     | 4 bytes |  4 bytes   | 4 bytes | ...
+       ///
+       /// Interpolation is 0 for linearly interpolated samples or 1 for natural cubic spline knots. Times (in seconds) and positions are single precision floating-point values, with strictly increasing times. 
+       /// Trajectories longer than a single message are sent in chunks, with first point index 0 starting a new upload. Loading does not affect the trajectory currently running
+       ROBOT_REQ_LOAD_TRAJECTORY,
+       /// Confirmation reply to ROBOT_REQ_LOAD_TRAJECTORY. Followed by total number of loaded points (2 bytes, LSB first)
+       ROBOT_REP_TRAJECTORY_LOADED = ROBOT_REQ_LOAD_TRAJECTORY,
+       /// Request starting last loaded trajectory (at next control pass). Must be followed, in the same message, by axis index (1 byte, 0xFF for all axes of selected robot with loaded trajectories), 
+       /// looping flag (1 byte, non-zero for periodic repetition) and blend time from current setpoint (4 bytes floating-point, in seconds)
+       ROBOT_REQ_START_TRAJECTORY,
+       ROBOT_REP_TRAJECTORY_STARTED = ROBOT_REQ_START_TRAJECTORY,     ///< Confirmation reply to ROBOT_REQ_START_TRAJECTORY
+       ROBOT_REQ_STOP_TRAJECTORY,                                     ///< Request stopping running trajectory and holding current position. Must be followed, in the same message, by axis index (1 byte, 0xFF for all axes of selected robot)
+       ROBOT_REP_TRAJECTORY_STOPPED = ROBOT_REQ_STOP_TRAJECTORY,      ///< Confirmation reply to ROBOT_REQ_STOP_TRAJECTORY
+       /// Request selecting robot (from the ones driven by the same process) affected by subsequent state/configuration requests (the first one is selected by default). Must be followed, in the same message, by robot index (1 byte).
+       /// Selecting the index after the last robot allows adding a new one with ROBOT_REQ_SET_CONFIG
+       ROBOT_REQ_SELECT_ROBOT,
+       ROBOT_REP_ROBOT_SELECTED = ROBOT_REQ_SELECT_ROBOT              ///< Confirmation reply to ROBOT_REQ_SELECT_ROBOT. Followed by the same JSON string type as in ROBOT_REP_GOT_CONFIG (empty for new robot)
 };
 
+#define ROBOT_ALL_AXES 0xFF           ///< Axis index value for trajectory commands applied to all axes of selected robot
+
 #endif // SHARED_ROBOT_CONTROL_H
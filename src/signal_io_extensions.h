@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file signal_io_extensions.h
+/// @brief Optional asynchronous extension of the signal I/O plugin interface
+///
+/// Signal I/O plugins for slow devices (CAN, serial, networked acquisition boards) may implement these functions, besides the regular (synchronous) interface, 
+/// so that control passes don't block on device access. An input update collects the samples of the reading requested on its previous update (if completed) and 
+/// requests the next one, keeping its last value meanwhile, while output updates only queue the values to be written.
+/// Plugins for devices accepting multi-channel frames may also write values of many output channels with a single call, as done for outputs grouped in batches (see output.h).
+/// Extensions are looked up on dynamically loaded and statically linked plugins (see static_plugins.h), and Read/Write calls are used whenever they are not found (or requests are refused)
+
+#ifndef SIGNAL_IO_EXTENSIONS_H
+#define SIGNAL_IO_EXTENSIONS_H
+
+
+#include "signal_io/signal_io.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/// @brief Asynchronous signal I/O functions, declared with DECLARE_MODULE_INTERFACE( SIGNAL_IO_ASYNC_INTERFACE ) on implementing plugins
+///
+/// bool ReadAsync( long int deviceID, unsigned int channel ): requests new samples from input channel, returning false if request could not be issued
+///
+/// bool PollRead( long int deviceID, unsigned int channel, double* ref_samplesList, size_t* ref_samplesNumber ): checks for completion of requested reading,
+/// returning true and filling samples list (with GetMaxInputSamplesNumber capacity) and number once completed, false while it is pending
+///
+/// bool WriteAsync( long int deviceID, unsigned int channel, double value ): queues value for writing on output channel (replacing a pending one), 
+/// returning false if it could not be queued (errors on actual writing are reported by HasError)
+#define SIGNAL_IO_ASYNC_INTERFACE( Namespace, INIT_FUNCTION ) \
+        INIT_FUNCTION( bool, Namespace, ReadAsync, long int, unsigned int ) \
+        INIT_FUNCTION( bool, Namespace, PollRead, long int, unsigned int, double*, size_t* ) \
+        INIT_FUNCTION( bool, Namespace, WriteAsync, long int, unsigned int, double )
+
+/// @brief Multi-channel write function, declared with DECLARE_MODULE_INTERFACE( SIGNAL_IO_BATCH_INTERFACE ) on implementing plugins
+///
+/// bool WriteBatch( long int deviceID, unsigned int* channelsList, double* valuesList, size_t channelsNumber, double timestamp ): writes all given values at once (in a single device transaction),
+/// returning false if they could not be written together (nothing is written then). Timestamp is the (control clock) commit time in seconds, shared by all devices of the same batch
+#define SIGNAL_IO_BATCH_INTERFACE( Namespace, INIT_FUNCTION ) \
+        INIT_FUNCTION( bool, Namespace, WriteBatch, long int, unsigned int*, double*, size_t, double )
+
+
+#endif // SIGNAL_IO_EXTENSIONS_H
@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "static_plugins.h"
+
+#include <string.h>
+
+// The generated list contains one ROBOT_CONTROL_PLUGIN( <name> ) or SIGNAL_IO_PLUGIN( <name> ) line for each statically linked plugin, 
+// followed by SIGNAL_IO_ASYNC_PLUGIN( <name> ) and SIGNAL_IO_BATCH_PLUGIN( <name> ) lines for signal I/O plugins declaring those extensions
+
+#define ROBOT_CONTROL_PLUGIN( pluginName ) ROBOT_CONTROL_CONTEXT_INTERFACE( pluginName, DECLARE_STATIC_PLUGIN_FUNCTION )
+#define SIGNAL_IO_PLUGIN( pluginName ) SIGNAL_IO_INTERFACE( pluginName, DECLARE_STATIC_PLUGIN_FUNCTION )
+#define SIGNAL_IO_ASYNC_PLUGIN( pluginName ) SIGNAL_IO_ASYNC_INTERFACE( pluginName, DECLARE_STATIC_PLUGIN_FUNCTION )
+#define SIGNAL_IO_BATCH_PLUGIN( pluginName ) SIGNAL_IO_BATCH_INTERFACE( pluginName, DECLARE_STATIC_PLUGIN_FUNCTION )
+#include "static_plugins_list.h"
+#undef ROBOT_CONTROL_PLUGIN
+#undef SIGNAL_IO_PLUGIN
+#undef SIGNAL_IO_ASYNC_PLUGIN
+#undef SIGNAL_IO_BATCH_PLUGIN
+
+#define STATIC_PLUGIN_FUNCTION_ENTRY( rtype, pluginName, funcName, ... ) .funcName = STATIC_PLUGIN_FUNCTION_NAME( pluginName, funcName ),
+
+typedef struct _RobotControlEntry
+{
+  const char* typeName;
+  RobotControlImplementation implementation;
+}
+RobotControlEntry;
+
+#define ROBOT_CONTROL_PLUGIN( pluginName ) { #pluginName, { ROBOT_CONTROL_CONTEXT_INTERFACE( pluginName, STATIC_PLUGIN_FUNCTION_ENTRY ) } },
+#define SIGNAL_IO_PLUGIN( pluginName )
+#define SIGNAL_IO_ASYNC_PLUGIN( pluginName )
+#define SIGNAL_IO_BATCH_PLUGIN( pluginName )
+static const RobotControlEntry ROBOT_CONTROL_PLUGINS[] = {
+#include "static_plugins_list.h"
+  { NULL }
+};
+#undef ROBOT_CONTROL_PLUGIN
+#undef SIGNAL_IO_PLUGIN
+#undef SIGNAL_IO_ASYNC_PLUGIN
+#undef SIGNAL_IO_BATCH_PLUGIN
+
+typedef struct _SignalIOEntry
+{
+  const char* typeName;
+  SignalIOImplementation implementation;
+}
+SignalIOEntry;
+
+#define ROBOT_CONTROL_PLUGIN( pluginName )
+#define SIGNAL_IO_PLUGIN( pluginName ) { #pluginName, { SIGNAL_IO_INTERFACE( pluginName, STATIC_PLUGIN_FUNCTION_ENTRY ) } },
+#define SIGNAL_IO_ASYNC_PLUGIN( pluginName )
+#define SIGNAL_IO_BATCH_PLUGIN( pluginName )
+static const SignalIOEntry SIGNAL_IO_PLUGINS[] = {
+#include "static_plugins_list.h"
+  { NULL }
+};
+#undef ROBOT_CONTROL_PLUGIN
+#undef SIGNAL_IO_PLUGIN
+#undef SIGNAL_IO_ASYNC_PLUGIN
+#undef SIGNAL_IO_BATCH_PLUGIN
+
+typedef struct _SignalIOAsyncEntry
+{
+  const char* typeName;
+  SignalIOAsyncImplementation implementation;
+}
+SignalIOAsyncEntry;
+
+#define ROBOT_CONTROL_PLUGIN( pluginName )
+#define SIGNAL_IO_PLUGIN( pluginName )
+#define SIGNAL_IO_ASYNC_PLUGIN( pluginName ) { #pluginName, { SIGNAL_IO_ASYNC_INTERFACE( pluginName, STATIC_PLUGIN_FUNCTION_ENTRY ) } },
+#define SIGNAL_IO_BATCH_PLUGIN( pluginName )
+static const SignalIOAsyncEntry SIGNAL_IO_ASYNC_PLUGINS[] = {
+#include "static_plugins_list.h"
+  { NULL }
+};
+#undef ROBOT_CONTROL_PLUGIN
+#undef SIGNAL_IO_PLUGIN
+#undef SIGNAL_IO_ASYNC_PLUGIN
+#undef SIGNAL_IO_BATCH_PLUGIN
+
+typedef struct _SignalIOBatchEntry
+{
+  const char* typeName;
+  SignalIOBatchImplementation implementation;
+}
+SignalIOBatchEntry;
+
+#define ROBOT_CONTROL_PLUGIN( pluginName )
+#define SIGNAL_IO_PLUGIN( pluginName )
+#define SIGNAL_IO_ASYNC_PLUGIN( pluginName )
+#define SIGNAL_IO_BATCH_PLUGIN( pluginName ) { #pluginName, { SIGNAL_IO_BATCH_INTERFACE( pluginName, STATIC_PLUGIN_FUNCTION_ENTRY ) } },
+static const SignalIOBatchEntry SIGNAL_IO_BATCH_PLUGINS[] = {
+#include "static_plugins_list.h"
+  { NULL }
+};
+#undef ROBOT_CONTROL_PLUGIN
+#undef SIGNAL_IO_PLUGIN
+#undef SIGNAL_IO_ASYNC_PLUGIN
+#undef SIGNAL_IO_BATCH_PLUGIN
+
+static bool isLookupEnabled = true;
+
+
+void StaticPlugins_SetEnabled( bool enabled )
+{
+  isLookupEnabled = enabled;
+}
+
+const RobotControlImplementation* StaticPlugins_GetRobotControl( const char* typeName )
+{
+  if( !isLookupEnabled || typeName == NULL ) return NULL;
+  
+  for( size_t pluginIndex = 0; ROBOT_CONTROL_PLUGINS[ pluginIndex ].typeName != NULL; pluginIndex++ )
+  {
+    if( strcmp( ROBOT_CONTROL_PLUGINS[ pluginIndex ].typeName, typeName ) == 0 ) return &(ROBOT_CONTROL_PLUGINS[ pluginIndex ].implementation);
+  }
+  
+  return NULL;
+}
+
+const SignalIOImplementation* StaticPlugins_GetSignalIO( const char* typeName )
+{
+  if( !isLookupEnabled || typeName == NULL ) return NULL;
+  
+  for( size_t pluginIndex = 0; SIGNAL_IO_PLUGINS[ pluginIndex ].typeName != NULL; pluginIndex++ )
+  {
+    if( strcmp( SIGNAL_IO_PLUGINS[ pluginIndex ].typeName, typeName ) == 0 ) return &(SIGNAL_IO_PLUGINS[ pluginIndex ].implementation);
+  }
+  
+  return NULL;
+}
+
+const SignalIOAsyncImplementation* StaticPlugins_GetSignalIOAsync( const char* typeName )
+{
+  if( !isLookupEnabled || typeName == NULL ) return NULL;
+  
+  for( size_t pluginIndex = 0; SIGNAL_IO_ASYNC_PLUGINS[ pluginIndex ].typeName != NULL; pluginIndex++ )
+  {
+    if( strcmp( SIGNAL_IO_ASYNC_PLUGINS[ pluginIndex ].typeName, typeName ) == 0 ) return &(SIGNAL_IO_ASYNC_PLUGINS[ pluginIndex ].implementation);
+  }
+  
+  return NULL;
+}
+
+const SignalIOBatchImplementation* StaticPlugins_GetSignalIOBatch( const char* typeName )
+{
+  if( !isLookupEnabled || typeName == NULL ) return NULL;
+  
+  for( size_t pluginIndex = 0; SIGNAL_IO_BATCH_PLUGINS[ pluginIndex ].typeName != NULL; pluginIndex++ )
+  {
+    if( strcmp( SIGNAL_IO_BATCH_PLUGINS[ pluginIndex ].typeName, typeName ) == 0 ) return &(SIGNAL_IO_BATCH_PLUGINS[ pluginIndex ].implementation);
+  }
+  
+  return NULL;
+}
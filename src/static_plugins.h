@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file static_plugins.h
+/// @brief Registry of plugins linked into the application at build time
+///
+/// When built with the STATIC_PLUGINS CMake option, listed plugins are compiled into the application with their interface functions renamed to <PluginName>_<FunctionName>,
+/// and implementations are looked up by plugin type name before trying dynamic module loading (unlisted plugins keep being loaded at runtime).
+/// The first listed plugin of each interface can also be called directly on control pass hot paths (instead of through function pointers) whenever it is the loaded one, 
+/// allowing its code to be inlined with link-time optimization.
+/// Robot control plugins are registered with their per-robot context interface (see robot_control_extensions.h), so only plugins implementing it may be linked statically
+/// Optional signal I/O extensions (see signal_io_extensions.h) are registered for plugins declaring them on their sources
+
+#ifndef STATIC_PLUGINS_H
+#define STATIC_PLUGINS_H
+
+
+#include "robot_control/robot_control.h"
+#include "robot_control_extensions.h"
+#include "signal_io/signal_io.h"
+#include "signal_io_extensions.h"
+
+#include <stdbool.h>
+
+
+typedef struct _RobotControlImplementation { DECLARE_MODULE_INTERFACE_REF( ROBOT_CONTROL_CONTEXT_INTERFACE ); } RobotControlImplementation;   ///< Robot control plugin functions
+typedef struct _SignalIOImplementation { DECLARE_MODULE_INTERFACE_REF( SIGNAL_IO_INTERFACE ); } SignalIOImplementation;                ///< Signal I/O plugin functions
+typedef struct _SignalIOAsyncImplementation { DECLARE_MODULE_INTERFACE_REF( SIGNAL_IO_ASYNC_INTERFACE ); } SignalIOAsyncImplementation;   ///< Signal I/O plugin asynchronous extension functions
+typedef struct _SignalIOBatchImplementation { DECLARE_MODULE_INTERFACE_REF( SIGNAL_IO_BATCH_INTERFACE ); } SignalIOBatchImplementation;   ///< Signal I/O plugin multi-channel extension functions
+
+
+/// @brief Enables or disables static implementations lookup (to force dynamic loading of all plugins, e.g. for comparison)
+/// @param[in] enabled true for using statically linked plugins (default), false otherwise
+void StaticPlugins_SetEnabled( bool enabled );
+
+/// @brief Gets statically linked robot control implementation for the given plugin type
+/// @param[in] typeName plugin name, as in robot configuration
+/// @return pointer to plugin functions (NULL if not linked statically or lookup is disabled)
+const RobotControlImplementation* StaticPlugins_GetRobotControl( const char* typeName );
+
+/// @brief Gets statically linked signal I/O implementation for the given plugin type
+/// @param[in] typeName plugin name, as in input/output interface configuration
+/// @return pointer to plugin functions (NULL if not linked statically or lookup is disabled)
+const SignalIOImplementation* StaticPlugins_GetSignalIO( const char* typeName );
+
+/// @brief Gets asynchronous extension of statically linked signal I/O implementation for the given plugin type
+/// @param[in] typeName plugin name, as in input/output interface configuration
+/// @return pointer to extension functions (NULL if not implemented, not linked statically or lookup is disabled)
+const SignalIOAsyncImplementation* StaticPlugins_GetSignalIOAsync( const char* typeName );
+
+/// @brief Gets multi-channel extension of statically linked signal I/O implementation for the given plugin type
+/// @param[in] typeName plugin name, as in input/output interface configuration
+/// @return pointer to extension functions (NULL if not implemented, not linked statically or lookup is disabled)
+const SignalIOBatchImplementation* StaticPlugins_GetSignalIOBatch( const char* typeName );
+
+
+#define STATIC_PLUGIN_FUNCTION_NAME_( pluginName, funcName ) pluginName ## _ ## funcName
+#define STATIC_PLUGIN_FUNCTION_NAME( pluginName, funcName ) STATIC_PLUGIN_FUNCTION_NAME_( pluginName, funcName )      ///< Renamed function of statically linked plugin
+
+#define DECLARE_STATIC_PLUGIN_FUNCTION( rtype, pluginName, funcName, ... ) rtype STATIC_PLUGIN_FUNCTION_NAME( pluginName, funcName )( __VA_ARGS__ );
+#define LOAD_STATIC_PLUGIN_FUNCTION( rtype, ref_module, funcName, ... ) (ref_module)->funcName = staticImplementation->funcName;
+
+/// Fills robot control (context interface) module structure with statically linked implementation functions (if available) or dynamically loaded ones otherwise
+#define LOAD_ROBOT_CONTROL_PLUGIN( typeName, path, ref_module, ref_success ) \
+  do { \
+    const RobotControlImplementation* staticImplementation = StaticPlugins_GetRobotControl( typeName ); \
+    if( staticImplementation != NULL ) { ROBOT_CONTROL_CONTEXT_INTERFACE( ref_module, LOAD_STATIC_PLUGIN_FUNCTION ) *(ref_success) = true; } \
+    else LOAD_MODULE_IMPLEMENTATION( ROBOT_CONTROL_CONTEXT_INTERFACE, path, ref_module, ref_success ); \
+  } while( 0 )
+
+/// Fills signal I/O module structure with statically linked implementation functions (if available) or dynamically loaded ones otherwise
+#define LOAD_SIGNAL_IO_PLUGIN( typeName, path, ref_module, ref_success ) \
+  do { \
+    const SignalIOImplementation* staticImplementation = StaticPlugins_GetSignalIO( typeName ); \
+    if( staticImplementation != NULL ) { SIGNAL_IO_INTERFACE( ref_module, LOAD_STATIC_PLUGIN_FUNCTION ) *(ref_success) = true; } \
+    else LOAD_MODULE_IMPLEMENTATION( SIGNAL_IO_INTERFACE, path, ref_module, ref_success ); \
+  } while( 0 )
+
+/// Fills signal I/O asynchronous extension functions from the statically linked plugin (if its base functions are linked statically) or dynamically loaded one otherwise
+#define LOAD_SIGNAL_IO_ASYNC_PLUGIN( typeName, path, ref_module, ref_success ) \
+  do { \
+    if( StaticPlugins_GetSignalIO( typeName ) != NULL ) { \
+      const SignalIOAsyncImplementation* staticImplementation = StaticPlugins_GetSignalIOAsync( typeName ); \
+      if( (*(ref_success) = ( staticImplementation != NULL )) ) { SIGNAL_IO_ASYNC_INTERFACE( ref_module, LOAD_STATIC_PLUGIN_FUNCTION ) } } \
+    else LOAD_MODULE_IMPLEMENTATION( SIGNAL_IO_ASYNC_INTERFACE, path, ref_module, ref_success ); \
+  } while( 0 )
+
+/// Fills signal I/O multi-channel extension functions from the statically linked plugin (if its base functions are linked statically) or dynamically loaded one otherwise
+#define LOAD_SIGNAL_IO_BATCH_PLUGIN( typeName, path, ref_module, ref_success ) \
+  do { \
+    if( StaticPlugins_GetSignalIO( typeName ) != NULL ) { \
+      const SignalIOBatchImplementation* staticImplementation = StaticPlugins_GetSignalIOBatch( typeName ); \
+      if( (*(ref_success) = ( staticImplementation != NULL )) ) { SIGNAL_IO_BATCH_INTERFACE( ref_module, LOAD_STATIC_PLUGIN_FUNCTION ) } } \
+    else LOAD_MODULE_IMPLEMENTATION( SIGNAL_IO_BATCH_INTERFACE, path, ref_module, ref_success ); \
+  } while( 0 )
+
+// Guarded direct calls: plain function pointer call unless the pointer refers to the inlined plugin
+
+#ifdef INLINE_ROBOT_CONTROL_PLUGIN
+ROBOT_CONTROL_CONTEXT_INTERFACE( INLINE_ROBOT_CONTROL_PLUGIN, DECLARE_STATIC_PLUGIN_FUNCTION )
+#define CALL_ROBOT_CONTROL_FUNCTION( ref_module, funcName, ... ) \
+  ( ( (ref_module)->funcName == STATIC_PLUGIN_FUNCTION_NAME( INLINE_ROBOT_CONTROL_PLUGIN, funcName ) ) ? \
+    STATIC_PLUGIN_FUNCTION_NAME( INLINE_ROBOT_CONTROL_PLUGIN, funcName )( __VA_ARGS__ ) : (ref_module)->funcName( __VA_ARGS__ ) )
+#else
+#define CALL_ROBOT_CONTROL_FUNCTION( ref_module, funcName, ... ) (ref_module)->funcName( __VA_ARGS__ )     ///< Calls robot control plugin function (directly for inlined plugin)
+#endif
+
+#ifdef INLINE_SIGNAL_IO_PLUGIN
+SIGNAL_IO_INTERFACE( INLINE_SIGNAL_IO_PLUGIN, DECLARE_STATIC_PLUGIN_FUNCTION )
+#define CALL_SIGNAL_IO_FUNCTION( ref_module, funcName, ... ) \
+  ( ( (ref_module)->funcName == STATIC_PLUGIN_FUNCTION_NAME( INLINE_SIGNAL_IO_PLUGIN, funcName ) ) ? \
+    STATIC_PLUGIN_FUNCTION_NAME( INLINE_SIGNAL_IO_PLUGIN, funcName )( __VA_ARGS__ ) : (ref_module)->funcName( __VA_ARGS__ ) )
+#else
+#define CALL_SIGNAL_IO_FUNCTION( ref_module, funcName, ... ) (ref_module)->funcName( __VA_ARGS__ )        ///< Calls signal I/O plugin function (directly for inlined plugin)
+#endif
+
+
+#endif // STATIC_PLUGINS_H
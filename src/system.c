@@ -28,11 +28,12 @@
 #include "shared_dof_variables.h"
 
 #include "robot.h"
+#include "clock.h"
+#include "profiler.h"
 
 #include "data_io/interface/data_io.h"
 
 #include "debug/data_logging.h"
-#include "timing/timing.h" 
 
 #include "config_keys.h"
 
@@ -58,28 +59,55 @@ static unsigned long lastUpdateTimeMS = 0;
 static unsigned long lastNetworkUpdateElapsedTimeMS = NETWORK_UPDATE_MIN_INTERVAL_MS;
 
 
-bool robotInitialized = false;
-size_t axesNumber = 0, jointsNumber = 0;
+#define SYSTEM_MAX_ROBOTS 8
 
-DataHandle robotConfig = NULL;
+typedef struct _RobotEntry
+{
+  Robot robot;
+  DataHandle config;
+  size_t firstAxisIndex;
+  double nextStepTime;
+  bool isStepping;
+}
+RobotEntry;
+
+static RobotEntry robotsList[ SYSTEM_MAX_ROBOTS ];
+static size_t robotsNumber = 0;
+static size_t selectedRobotIndex = 0;
+
+// Axes of all robots share a single (byte) index space on network messages, in robot order
+size_t axesNumber = 0;
+static Robot axisRobotsList[ UINT8_MAX + 1 ];
+static size_t axisLocalIndexesList[ UINT8_MAX + 1 ];
+// Axis indexes are single bytes, so pending setpoints for all possible axes fit in fixed size lists
+static DoFVariables pendingSetpointsList[ UINT8_MAX + 1 ];
+static bool hasPendingSetpointsList[ UINT8_MAX + 1 ];
+
+static unsigned long receivedSetpointsCount = 0, supersededSetpointsCount = 0, droppedSetpointsCount = 0;
 
 IPCConnection robotEventsConnection = NULL;
 IPCConnection robotAxesConnection = NULL;
 
 
 void ListRobotConfigs( char*, size_t );
-DataHandle ReloadRobotConfig( const char* );
+DataHandle ReloadRobotConfig( RobotEntry*, const char* );
+void UpdateAxesMap( void );
 void GetRobotConfigString( DataHandle, char*, size_t );
+void StepRobots( void );
+size_t LoadTrajectory( const Byte*, size_t );
+bool StartTrajectory( Robot, const Byte* );
+bool StopTrajectory( Robot, const Byte* );
 
 
 bool System_Init( const int argc, const char** argv )
 {
-  DEBUG_PRINT( "Starting Robot Control at time %g", Time_GetExecSeconds() );
+  DEBUG_PRINT( "Starting Robot Control at time %g", Clock_GetExecSeconds() );
   
   const char* rootDirectory = ".";
   const char* connectionAddress = NULL;
   const char* logDirectory = "./" KEY_LOGS "/";
-  const char* robotConfigName = NULL;
+  const char* robotConfigNamesList[ SYSTEM_MAX_ROBOTS ] = { NULL };
+  size_t robotConfigsNumber = 0;
   
   static struct option longOptions[] =
   {
@@ -88,23 +116,25 @@ bool System_Init( const int argc, const char** argv )
     { "log", required_argument, NULL, 'l' },
     { "addr", required_argument, NULL, 'a' },
     { "config", required_argument, NULL, 'c' },
+    { "sim", no_argument, NULL, 's' },
     { NULL, 0, NULL, 0 }
   };
   
   int optionChar;
   int optionIndex;
-  while( (optionChar = getopt_long( argc, (char* const*) argv, "hr:l:a:c:", longOptions, &optionIndex )) != -1 )
+  while( (optionChar = getopt_long( argc, (char* const*) argv, "hr:l:a:c:s", longOptions, &optionIndex )) != -1 )
   {
     DEBUG_PRINT( "option %s(%c) set with argument %s", longOptions[ optionIndex ].name, optionChar, optarg );
     if( optionChar == 'h' )
     {
-      printf( "usage: %s [--root <root_dir>] [--addr <connection_address>] [--log <log_dir>] [--config <robot_name>]\n", argv[ 0 ] );
+      printf( "usage: %s [--root <root_dir>] [--addr <connection_address>] [--log <log_dir>] [--config <robot_name> ...] [--sim]\n", argv[ 0 ] );
       return false;
     }
     else if( optionChar == 'r' ) rootDirectory = optarg;
     else if( optionChar == 'l' ) logDirectory = optarg;
     else if( optionChar == 'a' ) connectionAddress = optarg;
-    else if( optionChar == 'c' ) robotConfigName = optarg;
+    else if( optionChar == 'c' && robotConfigsNumber < SYSTEM_MAX_ROBOTS ) robotConfigNamesList[ robotConfigsNumber++ ] = optarg;
+    else if( optionChar == 's' ) Clock_SetSource( CLOCK_SOURCE_SIMULATED );
   }
   
   const char* connectionHost = connectionAddress;
@@ -116,38 +146,85 @@ bool System_Init( const int argc, const char** argv )
   Log_SetDirectory( logDirectory );
 
   chdir( rootDirectory );
-  DEBUG_PRINT( "loading robot configuration from %s", robotConfigName );
-  robotConfig = ReloadRobotConfig( robotConfigName );
+  // Each configuration option loads one more robot, driven by the same process
+  for( selectedRobotIndex = 0; selectedRobotIndex < robotConfigsNumber; selectedRobotIndex++ )
+  {
+    DEBUG_PRINT( "loading robot configuration from %s", robotConfigNamesList[ selectedRobotIndex ] );
+    (void) System_SetRobot( robotConfigNamesList[ selectedRobotIndex ] );
+  }
+  selectedRobotIndex = 0;
 
-  lastUpdateTimeMS = Time_GetExecMilliseconds();
+  lastUpdateTimeMS = Clock_GetExecMilliseconds();
   
   return true;
 }
 
 void System_End()
 {
-  DEBUG_PRINT( "Ending Robot Control at time %g", Time_GetExecSeconds() );
+  DEBUG_PRINT( "Ending Robot Control at time %g", Clock_GetExecSeconds() );
 
   IPC_CloseConnection( robotEventsConnection ); DEBUG_PRINT( "closing events connection %p", robotEventsConnection );
   IPC_CloseConnection( robotAxesConnection ); DEBUG_PRINT( "closing data connection %p", robotAxesConnection );
 
-  DataIO_UnloadData( robotConfig ); DEBUG_PRINT( "unloading robot config %p", robotConfig );
+  for( size_t robotIndex = 0; robotIndex < robotsNumber; robotIndex++ )
+  {
+    DataIO_UnloadData( robotsList[ robotIndex ].config ); DEBUG_PRINT( "unloading robot config %p", robotsList[ robotIndex ].config );
+    Robot_End( robotsList[ robotIndex ].robot );
+  }
+  memset( robotsList, 0, sizeof(robotsList) );
+  robotsNumber = 0;
+  
+  DEBUG_PRINT( "axis setpoints: %lu received, %lu superseded, %lu dropped", receivedSetpointsCount, supersededSetpointsCount, droppedSetpointsCount );
+  
+  DEBUG_PRINT( "Robot Control ended at time %g", Clock_GetExecSeconds() );
+}
+
+void System_GetSetpointCounts( unsigned long* ref_receivedCount, unsigned long* ref_supersededCount, unsigned long* ref_droppedCount )
+{
+  if( ref_receivedCount != NULL ) *ref_receivedCount = receivedSetpointsCount;
+  if( ref_supersededCount != NULL ) *ref_supersededCount = supersededSetpointsCount;
+  if( ref_droppedCount != NULL ) *ref_droppedCount = droppedSetpointsCount;
+}
+
+bool System_SetRobot( const char* robotName )
+{
+  RobotEntry* robotEntry = &(robotsList[ selectedRobotIndex ]);
+  
+  DataIO_UnloadData( robotEntry->config );
+  
+  robotEntry->config = ReloadRobotConfig( robotEntry, robotName );
+  
+  if( selectedRobotIndex >= robotsNumber ) robotsNumber = selectedRobotIndex + 1;
+  
+  UpdateAxesMap();
+  
+  return ( robotEntry->robot != NULL );
+}
 
-  Robot_End();
+Robot System_GetRobot( size_t robotIndex )
+{
+  if( robotIndex >= robotsNumber ) return NULL;
   
-  DEBUG_PRINT( "Robot Control ended at time %g", Time_GetExecSeconds() );
+  return robotsList[ robotIndex ].robot;
+}
+
+size_t System_GetRobotsNumber( void )
+{
+  return robotsNumber;
 }
 
 void UpdateEvents()
 {
   static Byte messageBuffer[ IPC_MAX_MESSAGE_LENGTH ];
 
-  Byte* messageIn = (Byte*) messageBuffer;
-  while( IPC_ReadMessage( robotEventsConnection, messageIn ) ) 
+  while( IPC_ReadMessage( robotEventsConnection, messageBuffer ) ) 
   {
+    Byte* messageIn = (Byte*) messageBuffer;
     Byte robotCommand = (Byte) *(messageIn++);    
     DEBUG_PRINT( "received robot command: %u (data: %s)", robotCommand, messageIn );
     Byte* messageOut = (Byte*) messageBuffer;
+    // Commands (apart from trajectory ones, with global axis indexes) act on last selected robot
+    Robot robot = robotsList[ selectedRobotIndex ].robot;
     if( robotCommand == ROBOT_REQ_LIST_CONFIGS ) 
     {
       messageOut[ 0 ] = ROBOT_REP_CONFIGS_LISTED;
@@ -156,15 +233,34 @@ void UpdateEvents()
     else if( robotCommand == ROBOT_REQ_GET_CONFIG ) 
     {
       messageOut[ 0 ] = ROBOT_REP_GOT_CONFIG;
-      GetRobotConfigString( robotConfig, (char*) ( messageOut + 1 ), IPC_MAX_MESSAGE_LENGTH - 1 );
+      GetRobotConfigString( robotsList[ selectedRobotIndex ].config, (char*) ( messageOut + 1 ), IPC_MAX_MESSAGE_LENGTH - 1 );
     }
     else if( robotCommand == ROBOT_REQ_SET_CONFIG )
     {
       char* robotName = (char*) messageIn;
       DEBUG_PRINT( "robot config %s set", robotName );
-      robotConfig = ReloadRobotConfig( robotName );
+      (void) System_SetRobot( robotName );
       messageOut[ 0 ] = ROBOT_REP_CONFIG_SET;
-      GetRobotConfigString( robotConfig, (char*) ( messageOut + 1 ), IPC_MAX_MESSAGE_LENGTH - 1 );
+      GetRobotConfigString( robotsList[ selectedRobotIndex ].config, (char*) ( messageOut + 1 ), IPC_MAX_MESSAGE_LENGTH - 1 );
+    }
+    else if( robotCommand == ROBOT_REQ_SELECT_ROBOT )
+    {
+      size_t robotIndex = (size_t) messageIn[ 0 ];
+      // Selecting the first free position allows adding a new robot with ROBOT_REQ_SET_CONFIG
+      bool isValidIndex = ( robotIndex <= robotsNumber && robotIndex < SYSTEM_MAX_ROBOTS );
+      if( isValidIndex ) selectedRobotIndex = robotIndex;
+      DEBUG_PRINT( "robot %lu selected: %s", robotIndex, isValidIndex ? "true" : "false" );
+      memset( messageOut, 0, IPC_MAX_MESSAGE_LENGTH );
+      messageOut[ 0 ] = isValidIndex ? ROBOT_REP_ROBOT_SELECTED : 0x00;
+      if( isValidIndex ) GetRobotConfigString( robotsList[ selectedRobotIndex ].config, (char*) ( messageOut + 1 ), IPC_MAX_MESSAGE_LENGTH - 1 );
+    }
+    else if( robotCommand == ROBOT_REQ_LOAD_TRAJECTORY )
+    {
+      size_t loadedPointsNumber = LoadTrajectory( messageIn, IPC_MAX_MESSAGE_LENGTH - 1 );
+      memset( messageOut, 0, IPC_MAX_MESSAGE_LENGTH );
+      messageOut[ 0 ] = ( loadedPointsNumber > 0 ) ? ROBOT_REP_TRAJECTORY_LOADED : 0x00;
+      messageOut[ 1 ] = (Byte) ( loadedPointsNumber & 0xFF );
+      messageOut[ 2 ] = (Byte) ( ( loadedPointsNumber >> 8 ) & 0xFF );
     }
     else 
     {
@@ -175,13 +271,15 @@ void UpdateEvents()
         Log_SetBaseName( userName );
         messageOut[ 0 ] = ROBOT_REP_USER_SET;
       }
-      else if( robotCommand == ROBOT_REQ_DISABLE ) messageOut[ 0 ] = Robot_Disable() ? ROBOT_REP_DISABLED : 0x00;
-      else if( robotCommand == ROBOT_REQ_ENABLE ) messageOut[ 0 ] = Robot_Enable() ? ROBOT_REP_ENABLED : 0x00;
-      else if( robotCommand == ROBOT_REQ_PASSIVATE ) messageOut[ 0 ] = Robot_SetControlState( CONTROL_PASSIVE ) ? ROBOT_REP_PASSIVE : 0x00;
-      else if( robotCommand == ROBOT_REQ_OFFSET ) messageOut[ 0 ] = Robot_SetControlState( CONTROL_OFFSET ) ? ROBOT_REP_OFFSETTING : 0x00;
-      else if( robotCommand == ROBOT_REQ_CALIBRATE ) messageOut[ 0 ] = Robot_SetControlState( CONTROL_CALIBRATION ) ? ROBOT_REP_CALIBRATING : 0x00;
-      else if( robotCommand == ROBOT_REQ_PREPROCESS ) messageOut[ 0 ] = Robot_SetControlState( CONTROL_PREPROCESSING ) ? ROBOT_REP_PREPROCESSING : 0x00;
-      else if( robotCommand == ROBOT_REQ_OPERATE ) messageOut[ 0 ] = Robot_SetControlState( CONTROL_OPERATION ) ? ROBOT_REP_OPERATING : 0x00;
+      else if( robotCommand == ROBOT_REQ_DISABLE ) messageOut[ 0 ] = Robot_Disable( robot ) ? ROBOT_REP_DISABLED : 0x00;
+      else if( robotCommand == ROBOT_REQ_ENABLE ) messageOut[ 0 ] = Robot_Enable( robot ) ? ROBOT_REP_ENABLED : 0x00;
+      else if( robotCommand == ROBOT_REQ_PASSIVATE ) messageOut[ 0 ] = Robot_SetControlState( robot, CONTROL_PASSIVE ) ? ROBOT_REP_PASSIVE : 0x00;
+      else if( robotCommand == ROBOT_REQ_OFFSET ) messageOut[ 0 ] = Robot_SetControlState( robot, CONTROL_OFFSET ) ? ROBOT_REP_OFFSETTING : 0x00;
+      else if( robotCommand == ROBOT_REQ_CALIBRATE ) messageOut[ 0 ] = Robot_SetControlState( robot, CONTROL_CALIBRATION ) ? ROBOT_REP_CALIBRATING : 0x00;
+      else if( robotCommand == ROBOT_REQ_PREPROCESS ) messageOut[ 0 ] = Robot_SetControlState( robot, CONTROL_PREPROCESSING ) ? ROBOT_REP_PREPROCESSING : 0x00;
+      else if( robotCommand == ROBOT_REQ_OPERATE ) messageOut[ 0 ] = Robot_SetControlState( robot, CONTROL_OPERATION ) ? ROBOT_REP_OPERATING : 0x00;
+      else if( robotCommand == ROBOT_REQ_START_TRAJECTORY ) messageOut[ 0 ] = StartTrajectory( robot, messageIn ) ? ROBOT_REP_TRAJECTORY_STARTED : 0x00;
+      else if( robotCommand == ROBOT_REQ_STOP_TRAJECTORY ) messageOut[ 0 ] = StopTrajectory( robot, messageIn ) ? ROBOT_REP_TRAJECTORY_STOPPED : 0x00;
       memset( messageOut + 1, 0, IPC_MAX_MESSAGE_LENGTH - 1 );
     }
     DEBUG_PRINT( "sending robot state: %u", messageOut[ 0 ] );
@@ -193,35 +291,63 @@ bool UpdateAxes( unsigned long lastNetworkUpdateElapsedTimeMS )
 {
   static Byte message[ IPC_MAX_MESSAGE_LENGTH ];
 
-  Byte* messageIn = (Byte*) message;
-  while( IPC_ReadMessage( robotAxesConnection, messageIn ) ) 
+  // Drain all queued messages, keeping only the latest received setpoint for each axis (stale ones after a stall are not replayed)
+  while( IPC_ReadMessage( robotAxesConnection, message ) ) 
   {
+    Byte* messageIn = (Byte*) message;
     size_t setpointBlocksNumber = (size_t) *(messageIn++);
     //DEBUG_PRINT( "received message for %lu axes", setpointBlocksNumber );
     for( size_t setpointBlockIndex = 0; setpointBlockIndex < setpointBlocksNumber; setpointBlockIndex++ )
     {
-      size_t axisIndex = (size_t) *(messageIn++);
+      if( messageIn + 1 + DOF_DATA_BLOCK_SIZE > message + IPC_MAX_MESSAGE_LENGTH )
+      {
+        receivedSetpointsCount += setpointBlocksNumber - setpointBlockIndex;
+        droppedSetpointsCount += setpointBlocksNumber - setpointBlockIndex;
+        break;
+      }
+      
+      receivedSetpointsCount++;
       
-      if( axisIndex >= axesNumber ) continue;      
+      size_t axisIndex = (size_t) *(messageIn++);
       
-      float* axisSetpointsList = (float*) messageIn;
-      DoFVariables axisSetpoints = { .position = axisSetpointsList[ DOF_POSITION ], .velocity = axisSetpointsList[ DOF_VELOCITY ],
-                                     .acceleration = axisSetpointsList[ DOF_ACCELERATION ], .force = axisSetpointsList[ DOF_FORCE ],
-                                     .inertia = axisSetpointsList[ DOF_INERTIA ],
-                                     .damping = axisSetpointsList[ DOF_DAMPING ], .stiffness = axisSetpointsList[ DOF_STIFFNESS ] };
-      //if( axisIndex == 0 ) DEBUG_PRINT( "setpoints: p: %.3f - v: %.3f", axisSetpoints.position, axisSetpoints.velocity );
-      Robot_SetAxisSetpoints( axisIndex, &axisSetpoints );
+      if( axisIndex >= axesNumber ) droppedSetpointsCount++;
+      else
+      {
+        if( hasPendingSetpointsList[ axisIndex ] ) supersededSetpointsCount++;
+        
+        float* axisSetpointsList = (float*) messageIn;
+        DoFVariables* axisSetpoints = &(pendingSetpointsList[ axisIndex ]);
+        axisSetpoints->position = axisSetpointsList[ DOF_POSITION ];
+        axisSetpoints->velocity = axisSetpointsList[ DOF_VELOCITY ];
+        axisSetpoints->acceleration = axisSetpointsList[ DOF_ACCELERATION ];
+        axisSetpoints->force = axisSetpointsList[ DOF_FORCE ];
+        axisSetpoints->inertia = axisSetpointsList[ DOF_INERTIA ];
+        axisSetpoints->damping = axisSetpointsList[ DOF_DAMPING ];
+        axisSetpoints->stiffness = axisSetpointsList[ DOF_STIFFNESS ];
+        hasPendingSetpointsList[ axisIndex ] = true;
+      }
 
       messageIn += DOF_DATA_BLOCK_SIZE;
     }
   }
   
+  // Apply coalesced setpoints in a single batch (at most one per axis)
+  for( size_t axisIndex = 0; axisIndex < axesNumber; axisIndex++ )
+  {
+    if( !hasPendingSetpointsList[ axisIndex ] ) continue;
+    //if( axisIndex == 0 ) DEBUG_PRINT( "setpoints: p: %.3f - v: %.3f", pendingSetpointsList[ axisIndex ].position, pendingSetpointsList[ axisIndex ].velocity );
+    Robot_SetAxisSetpoints( axisRobotsList[ axisIndex ], axisLocalIndexesList[ axisIndex ], &(pendingSetpointsList[ axisIndex ]) );
+    hasPendingSetpointsList[ axisIndex ] = false;
+  }
+  
+  PROFILER_START( stageTime );
+  
   memset( message, 0, IPC_MAX_MESSAGE_LENGTH * sizeof(Byte) );
   size_t axisdataOffset = 1;
   for( size_t axisIndex = 0; axisIndex < axesNumber; axisIndex++ )
   {    
     DoFVariables axisMeasures = { 0 };
-    if( Robot_GetAxisMeasures( axisIndex, &axisMeasures ) )
+    if( Robot_GetAxisMeasures( axisRobotsList[ axisIndex ], axisLocalIndexesList[ axisIndex ], &axisMeasures ) )
     {
       message[ 0 ]++;
       message[ axisdataOffset++ ] = (Byte) axisIndex;
@@ -239,6 +365,7 @@ bool UpdateAxes( unsigned long lastNetworkUpdateElapsedTimeMS )
       axisdataOffset += DOF_DATA_BLOCK_SIZE;
     }
   }
+  PROFILER_REGISTER( PROFILER_SERIALIZATION, stageTime );
   
   if( message[ 0 ] > 0 && lastNetworkUpdateElapsedTimeMS >= NETWORK_UPDATE_MIN_INTERVAL_MS )
   {
@@ -252,11 +379,13 @@ bool UpdateAxes( unsigned long lastNetworkUpdateElapsedTimeMS )
 
 void System_Update()
 {
-  unsigned long lastUpdateElapsedTimeMS = Time_GetExecMilliseconds() - lastUpdateTimeMS;
-  lastUpdateTimeMS = Time_GetExecMilliseconds();
+  unsigned long lastUpdateElapsedTimeMS = Clock_GetExecMilliseconds() - lastUpdateTimeMS;
+  lastUpdateTimeMS = Clock_GetExecMilliseconds();
   
   UpdateEvents();
   
+  if( Clock_GetSource() == CLOCK_SOURCE_SIMULATED ) StepRobots();
+  
   lastNetworkUpdateElapsedTimeMS += lastUpdateElapsedTimeMS;
   if( UpdateAxes( lastNetworkUpdateElapsedTimeMS ) )
     lastNetworkUpdateElapsedTimeMS = 0;
@@ -281,7 +410,7 @@ void ListRobotConfigs( char* sharedRobotsString, size_t bufferSize )
   DataIO_UnloadData( robotsList );
 }
 
-DataHandle ReloadRobotConfig( const char* robotName )
+DataHandle ReloadRobotConfig( RobotEntry* robotEntry, const char* robotName )
 { 
   DataHandle robotConfig = DataIO_CreateEmptyData();
   
@@ -289,36 +418,88 @@ DataHandle ReloadRobotConfig( const char* robotName )
   {     
     Log_SetTimeStamp();
     
-    if( robotInitialized ) Robot_End();
+    Robot_End( robotEntry->robot );
     
-    if( (robotInitialized = Robot_Init( robotName )) )
+    if( (robotEntry->robot = Robot_Init( robotName )) != NULL )
     {
       DataIO_SetStringValue( robotConfig, KEY_ID, robotName );   
       
       DataHandle sharedJointsList = DataIO_AddList( robotConfig, KEY_JOINTS );
       DataHandle sharedAxesList = DataIO_AddList( robotConfig, KEY_AXES );
       
-      axesNumber = Robot_GetAxesNumber(); 
+      size_t robotAxesNumber = Robot_GetAxesNumber( robotEntry->robot ); 
 
-      for( size_t axisIndex = 0; axisIndex < axesNumber; axisIndex++ )
+      for( size_t axisIndex = 0; axisIndex < robotAxesNumber; axisIndex++ )
       {
-        const char* axisName = Robot_GetAxisName( axisIndex );
+        const char* axisName = Robot_GetAxisName( robotEntry->robot, axisIndex );
         if( axisName != NULL ) DataIO_SetStringValue( sharedAxesList, NULL, axisName );
       }
       
-      jointsNumber = Robot_GetJointsNumber();
+      size_t robotJointsNumber = Robot_GetJointsNumber( robotEntry->robot );
 
-      for( size_t jointIndex = 0; jointIndex < jointsNumber; jointIndex++ )
+      for( size_t jointIndex = 0; jointIndex < robotJointsNumber; jointIndex++ )
       {
-        const char* jointName = Robot_GetJointName( jointIndex );
+        const char* jointName = Robot_GetJointName( robotEntry->robot, jointIndex );
         if( jointName != NULL ) DataIO_SetStringValue( sharedJointsList, NULL, jointName );
       }
     }
   }
   
+  robotEntry->nextStepTime = Clock_GetExecSeconds();
+  robotEntry->isStepping = false;
+  
   return robotConfig;
 }
 
+void UpdateAxesMap( void )
+{
+  // Pending setpoints refer to the previous map, and could otherwise be applied to other axes (or robots)
+  memset( hasPendingSetpointsList, 0, sizeof(hasPendingSetpointsList) );
+  
+  axesNumber = 0;
+  for( size_t robotIndex = 0; robotIndex < robotsNumber; robotIndex++ )
+  {
+    RobotEntry* robotEntry = &(robotsList[ robotIndex ]);
+    robotEntry->firstAxisIndex = axesNumber;
+    size_t robotAxesNumber = Robot_GetAxesNumber( robotEntry->robot );
+    for( size_t axisIndex = 0; axisIndex < robotAxesNumber; axisIndex++ )
+    {
+      if( axesNumber > UINT8_MAX )
+      {
+        DEBUG_PRINT( "axes limit reached: axis %lu of robot %lu not available", axisIndex, robotIndex );
+        break;
+      }
+      axisRobotsList[ axesNumber ] = robotEntry->robot;
+      axisLocalIndexesList[ axesNumber ] = axisIndex;
+      axesNumber++;
+    }
+    if( robotEntry->robot != NULL ) DataIO_SetNumericValue( robotEntry->config, KEY_FIRST_AXIS, robotEntry->firstAxisIndex );
+  }
+}
+
+void StepRobots( void )
+{
+  // Virtual time only advances with control passes, driven from here (each enabled robot is stepped at its own time step)
+  double currentTime = Clock_GetExecSeconds();
+  double nextStepTime = -1.0;
+  for( size_t robotIndex = 0; robotIndex < robotsNumber; robotIndex++ )
+  {
+    RobotEntry* robotEntry = &(robotsList[ robotIndex ]);
+    if( robotEntry->robot == NULL ) continue;
+    
+    if( robotEntry->nextStepTime <= currentTime + 1e-9 )
+    {
+      robotEntry->isStepping = Robot_Step( robotEntry->robot );
+      robotEntry->nextStepTime = currentTime + Robot_GetControlTimeStep( robotEntry->robot );
+    }
+    
+    if( robotEntry->isStepping && ( nextStepTime < 0.0 || robotEntry->nextStepTime < nextStepTime ) ) 
+      nextStepTime = robotEntry->nextStepTime;
+  }
+  
+  if( nextStepTime > currentTime ) Clock_Advance( nextStepTime - currentTime );
+}
+
 void GetRobotConfigString( DataHandle robotConfig, char* sharedControlsString, size_t bufferSize )
 {
   if( sharedControlsString != NULL )
@@ -329,3 +510,74 @@ void GetRobotConfigString( DataHandle robotConfig, char* sharedControlsString, s
     free( robotConfigString );
   }
 }
+
+size_t LoadTrajectory( const Byte* trajectoryData, size_t dataLength )
+{
+  const size_t HEADER_LENGTH = 5, POINT_LENGTH = 2 * sizeof(float);
+  static double timesList[ IPC_MAX_MESSAGE_LENGTH / ( 2 * sizeof(float) ) ];
+  static double positionsList[ IPC_MAX_MESSAGE_LENGTH / ( 2 * sizeof(float) ) ];
+  
+  size_t axisIndex = (size_t) trajectoryData[ 0 ];
+  enum TrajectoryInterpolation interpolation = (enum TrajectoryInterpolation) trajectoryData[ 1 ];
+  size_t firstPointIndex = (size_t) trajectoryData[ 2 ] + ( (size_t) trajectoryData[ 3 ] << 8 );
+  size_t pointsNumber = (size_t) trajectoryData[ 4 ];
+  
+  if( HEADER_LENGTH + pointsNumber * POINT_LENGTH > dataLength ) return 0;
+  
+  const Byte* pointData = trajectoryData + HEADER_LENGTH;
+  for( size_t pointIndex = 0; pointIndex < pointsNumber; pointIndex++ )
+  {
+    float pointValuesList[ 2 ];
+    memcpy( pointValuesList, pointData, POINT_LENGTH );
+    timesList[ pointIndex ] = (double) pointValuesList[ 0 ];
+    positionsList[ pointIndex ] = (double) pointValuesList[ 1 ];
+    pointData += POINT_LENGTH;
+  }
+  
+  DEBUG_PRINT( "loading %lu trajectory points (from %lu) for axis %lu", pointsNumber, firstPointIndex, axisIndex );
+  
+  if( axisIndex >= axesNumber ) return 0;
+  
+  return Robot_LoadAxisTrajectory( axisRobotsList[ axisIndex ], axisLocalIndexesList[ axisIndex ], interpolation, firstPointIndex, pointsNumber, timesList, positionsList );
+}
+
+bool StartTrajectory( Robot robot, const Byte* startData )
+{
+  size_t axisIndex = (size_t) startData[ 0 ];
+  bool isLooping = ( startData[ 1 ] != 0 );
+  float blendTime;
+  memcpy( &blendTime, startData + 2, sizeof(float) );
+  
+  if( axisIndex != ROBOT_ALL_AXES ) 
+  {
+    if( axisIndex >= axesNumber ) return false;
+    return Robot_StartAxisTrajectory( axisRobotsList[ axisIndex ], axisLocalIndexesList[ axisIndex ], blendTime, isLooping );
+  }
+  
+  bool anyStarted = false;
+  for( axisIndex = 0; axisIndex < Robot_GetAxesNumber( robot ); axisIndex++ )
+  {
+    if( Robot_StartAxisTrajectory( robot, axisIndex, blendTime, isLooping ) ) anyStarted = true;
+  }
+  
+  return anyStarted;
+}
+
+bool StopTrajectory( Robot robot, const Byte* stopData )
+{
+  size_t axisIndex = (size_t) stopData[ 0 ];
+  
+  if( axisIndex != ROBOT_ALL_AXES ) 
+  {
+    if( axisIndex >= axesNumber ) return false;
+    return Robot_StopAxisTrajectory( axisRobotsList[ axisIndex ], axisLocalIndexesList[ axisIndex ] );
+  }
+  
+  bool anyStopped = false;
+  for( axisIndex = 0; axisIndex < Robot_GetAxesNumber( robot ); axisIndex++ )
+  {
+    if( Robot_StopAxisTrajectory( robot, axisIndex ) ) anyStopped = true;
+  }
+  
+  return anyStopped;
+}
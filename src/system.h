@@ -29,7 +29,10 @@
 #ifndef SYSTEM_H
 #define SYSTEM_H
 
+#include "robot.h"
+
 #include <stdbool.h>
+#include <stddef.h>
 
 /// @brief Initialize RobotSystem with list of command-line string arguments                                             
 /// @param[in] argc number of string arguments, at least 2: application name and robot config path (see @ref robot_config) or help flag
@@ -43,5 +46,25 @@ void System_End( void );
 /// @brief Call RobotSystem update step
 void System_Update( void );
 
+/// @brief Replace currently selected robot (if any) by a new one, loaded from given configuration (the first robot is selected by default)
+/// @param[in] robotName name of robot configuration (see @ref robot_config) to be loaded
+/// @return true if new robot was initialized successfully, false otherwise
+bool System_SetRobot( const char* robotName );
+
+/// @brief Gets one of the robots driven by RobotSystem
+/// @param[in] robotIndex index of robot (in the order of loading)
+/// @return reference to robot (NULL if not loaded)
+Robot System_GetRobot( size_t robotIndex );
+
+/// @brief Gets number of robot positions in use (robots are loaded by --config command-line options or ROBOT_REQ_SELECT_ROBOT/ROBOT_REQ_SET_CONFIG requests)
+/// @return number of robots, including failed loadings
+size_t System_GetRobotsNumber( void );
+
+/// @brief Gets counters of axis setpoints received from clients since initialization (only the latest setpoint for each axis is applied on every update)
+/// @param[out] ref_receivedCount pointer/reference to number of received setpoint blocks (ignored if NULL)
+/// @param[out] ref_supersededCount pointer/reference to number of valid setpoints replaced by newer ones before being applied (ignored if NULL)
+/// @param[out] ref_droppedCount pointer/reference to number of setpoints discarded for invalid axis index or truncated message (ignored if NULL)
+void System_GetSetpointCounts( unsigned long* ref_receivedCount, unsigned long* ref_supersededCount, unsigned long* ref_droppedCount );
+
 
 #endif // SYSTEM_H
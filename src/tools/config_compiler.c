@@ -0,0 +1,500 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file config_compiler.c
+/// @brief Robot configuration to C code compiler
+///
+/// Reads the given robot configurations (and all actuator, sensor and motor configurations they refer to) and generates a C translation unit with specialized entries
+/// (see compiled_config.h): sensor and motor transform expressions are translated from TinyExpr syntax to C code, with constant inputs number.
+/// Expressions using unsupported functions are skipped (and keep being evaluated at runtime).
+/// It must be run from the root project folder, like the control application:
+///
+///     $ ./ConfigCompiler <output_file> <robot_name> [<robot_name> ...]
+
+#include "data_io/interface/data_io.h"
+
+#include "config_keys.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+
+#define EXPRESSION_MAX_LENGTH 4096
+#define ENTRIES_MAX_NUMBER 1024
+
+const char* SENSOR_VARIABLE_NAMES[] = { "in0", "in1", "in2", "in3", "in4", "in5" };
+const char* SENSOR_VARIABLE_CODES[] = { "in[ 0 ]", "in[ 1 ]", "in[ 2 ]", "in[ 3 ]", "in[ 4 ]", "in[ 5 ]" };
+#define SENSOR_INPUTS_MAX_NUMBER ( sizeof(SENSOR_VARIABLE_NAMES) / sizeof(const char*) )
+
+const char* MOTOR_VARIABLE_NAMES[] = { "set", "ref" };
+const char* MOTOR_VARIABLE_CODES[] = { "setpoint", "reference" };
+
+// TinyExpr built-in functions and their C equivalents (TinyExpr "log" is base 10 unless built with TE_NAT_LOG)
+typedef struct _Function { const char* name; const char* code; int arity; } Function;
+const Function FUNCTIONS_LIST[] = { { "pi", "3.14159265358979323846", 0 }, { "e", "2.71828182845904523536", 0 },
+                                    { "abs", "fabs", 1 }, { "acos", "acos", 1 }, { "asin", "asin", 1 }, { "atan", "atan", 1 }, { "ceil", "ceil", 1 },
+                                    { "cos", "cos", 1 }, { "cosh", "cosh", 1 }, { "exp", "exp", 1 }, { "floor", "floor", 1 }, { "ln", "log", 1 },
+                                    { "log", "log10", 1 }, { "log10", "log10", 1 }, { "sin", "sin", 1 }, { "sinh", "sinh", 1 }, { "sqrt", "sqrt", 1 },
+                                    { "tan", "tan", 1 }, { "tanh", "tanh", 1 }, { "atan2", "atan2", 2 }, { "pow", "pow", 2 } };
+#define FUNCTIONS_NUMBER ( sizeof(FUNCTIONS_LIST) / sizeof(Function) )
+
+typedef struct _Parser
+{
+  const char* next;
+  const char** variableNames;
+  const char** variableCodes;
+  size_t variablesNumber;
+  char code[ EXPRESSION_MAX_LENGTH ];
+  size_t codeLength;
+  bool hasError;
+}
+Parser;
+
+typedef struct _Entry { char name[ DATA_IO_MAX_PATH_LENGTH ]; size_t inputsNumber; bool isCompiled; } Entry;
+
+static Entry sensorsList[ ENTRIES_MAX_NUMBER ];
+static size_t sensorsNumber = 0;
+static Entry motorsList[ ENTRIES_MAX_NUMBER ];
+static size_t motorsNumber = 0;
+static Entry actuatorsList[ ENTRIES_MAX_NUMBER ];
+static size_t actuatorsNumber = 0;
+
+/////////////////////////////////////////////////////////////////////////////////
+/////                      TINYEXPR TO C TRANSLATION                        /////
+/////////////////////////////////////////////////////////////////////////////////
+
+static void InsertCode( Parser* parser, size_t position, const char* text )
+{
+  size_t textLength = strlen( text );
+  if( parser->codeLength + textLength >= EXPRESSION_MAX_LENGTH )
+  {
+    parser->hasError = true;
+    return;
+  }
+  memmove( parser->code + position + textLength, parser->code + position, parser->codeLength - position + 1 );
+  memcpy( parser->code + position, text, textLength );
+  parser->codeLength += textLength;
+}
+
+static void AppendCode( Parser* parser, const char* text ) { InsertCode( parser, parser->codeLength, text ); }
+
+static char PeekChar( Parser* parser )
+{
+  while( isspace( (unsigned char) *(parser->next) ) ) parser->next++;
+  return *(parser->next);
+}
+
+static bool MatchChar( Parser* parser, char expectedChar )
+{
+  if( PeekChar( parser ) != expectedChar ) return false;
+  parser->next++;
+  return true;
+}
+
+static void ParseList( Parser* );
+static void ParseExpression( Parser* );
+static void ParsePower( Parser* );
+
+// base = number | variable | function0 ["(" ")"] | function1 power | function2 "(" expr "," expr ")" | "(" list ")"
+static void ParseBase( Parser* parser )
+{
+  char nextChar = PeekChar( parser );
+  if( isdigit( (unsigned char) nextChar ) || nextChar == '.' )
+  {
+    char* numberEnd;
+    double number = strtod( parser->next, &numberEnd );
+    if( numberEnd == parser->next ) { parser->hasError = true; return; }
+    parser->next = numberEnd;
+    // Always floating-point literals, so that integer divisions are never generated
+    char numberCode[ 64 ];
+    snprintf( numberCode, sizeof(numberCode), "%.17g", number );
+    if( strpbrk( numberCode, ".eEn" ) == NULL ) strcat( numberCode, ".0" );
+    AppendCode( parser, numberCode );
+  }
+  else if( isalpha( (unsigned char) nextChar ) )
+  {
+    const char* nameStart = parser->next;
+    while( isalnum( (unsigned char) *(parser->next) ) || *(parser->next) == '_' ) parser->next++;
+    size_t nameLength = parser->next - nameStart;
+    // User variables take precedence over built-in functions (as in TinyExpr)
+    for( size_t variableIndex = 0; variableIndex < parser->variablesNumber; variableIndex++ )
+    {
+      if( strlen( parser->variableNames[ variableIndex ] ) == nameLength && strncmp( nameStart, parser->variableNames[ variableIndex ], nameLength ) == 0 )
+      {
+        AppendCode( parser, parser->variableCodes[ variableIndex ] );
+        return;
+      }
+    }
+    const Function* function = NULL;
+    for( size_t functionIndex = 0; functionIndex < FUNCTIONS_NUMBER; functionIndex++ )
+    {
+      if( strlen( FUNCTIONS_LIST[ functionIndex ].name ) == nameLength && strncmp( nameStart, FUNCTIONS_LIST[ functionIndex ].name, nameLength ) == 0 )
+        function = &(FUNCTIONS_LIST[ functionIndex ]);
+    }
+    if( function == NULL )
+    {
+      fprintf( stderr, "unknown or unsupported name: %.*s\n", (int) nameLength, nameStart );
+      parser->hasError = true;
+      return;
+    }
+    AppendCode( parser, function->code );
+    if( function->arity == 0 )
+    {
+      if( MatchChar( parser, '(' ) && !MatchChar( parser, ')' ) ) parser->hasError = true;
+    }
+    else if( function->arity == 1 )
+    {
+      AppendCode( parser, "( " );
+      ParsePower( parser );
+      AppendCode( parser, " )" );
+    }
+    else
+    {
+      AppendCode( parser, "( " );
+      if( !MatchChar( parser, '(' ) ) parser->hasError = true;
+      ParseExpression( parser );
+      AppendCode( parser, ", " );
+      if( !MatchChar( parser, ',' ) ) parser->hasError = true;
+      ParseExpression( parser );
+      if( !MatchChar( parser, ')' ) ) parser->hasError = true;
+      AppendCode( parser, " )" );
+    }
+  }
+  else if( MatchChar( parser, '(' ) )
+  {
+    AppendCode( parser, "( " );
+    ParseList( parser );
+    if( !MatchChar( parser, ')' ) ) parser->hasError = true;
+    AppendCode( parser, " )" );
+  }
+  else parser->hasError = true;
+}
+
+// power = {"-" | "+"} base
+static void ParsePower( Parser* parser )
+{
+  bool isNegative = false;
+  char nextChar;
+  while( (nextChar = PeekChar( parser )) == '-' || nextChar == '+' )
+  {
+    if( nextChar == '-' ) isNegative = !isNegative;
+    parser->next++;
+  }
+  if( isNegative ) AppendCode( parser, "-( " );
+  ParseBase( parser );
+  if( isNegative ) AppendCode( parser, " )" );
+}
+
+// factor = power {"^" power} (left associative, as in default TinyExpr builds)
+static void ParseFactor( Parser* parser )
+{
+  size_t factorStart = parser->codeLength;
+  ParsePower( parser );
+  while( !(parser->hasError) && MatchChar( parser, '^' ) )
+  {
+    InsertCode( parser, factorStart, "pow( " );
+    AppendCode( parser, ", " );
+    ParsePower( parser );
+    AppendCode( parser, " )" );
+  }
+}
+
+// term = factor {("*" | "/" | "%") factor}
+static void ParseTerm( Parser* parser )
+{
+  size_t termStart = parser->codeLength;
+  ParseFactor( parser );
+  char nextChar;
+  while( !(parser->hasError) && ( (nextChar = PeekChar( parser )) == '*' || nextChar == '/' || nextChar == '%' ) )
+  {
+    parser->next++;
+    if( nextChar == '%' )
+    {
+      InsertCode( parser, termStart, "fmod( " );
+      AppendCode( parser, ", " );
+      ParseFactor( parser );
+      AppendCode( parser, " )" );
+    }
+    else
+    {
+      AppendCode( parser, ( nextChar == '*' ) ? " * " : " / " );
+      ParseFactor( parser );
+    }
+  }
+}
+
+// expr = term {("+" | "-") term}
+static void ParseExpression( Parser* parser )
+{
+  AppendCode( parser, "( " );
+  ParseTerm( parser );
+  char nextChar;
+  while( !(parser->hasError) && ( (nextChar = PeekChar( parser )) == '+' || nextChar == '-' ) )
+  {
+    parser->next++;
+    AppendCode( parser, ( nextChar == '+' ) ? " + " : " - " );
+    ParseTerm( parser );
+  }
+  AppendCode( parser, " )" );
+}
+
+// list = expr {"," expr} (all evaluated, last one is the result)
+static void ParseList( Parser* parser )
+{
+  ParseExpression( parser );
+  while( !(parser->hasError) && MatchChar( parser, ',' ) )
+  {
+    AppendCode( parser, ", " );
+    ParseExpression( parser );
+  }
+}
+
+static bool TranslateExpression( const char* expression, const char** variableNames, const char** variableCodes, size_t variablesNumber, Parser* parser )
+{
+  memset( parser, 0, sizeof(Parser) );
+  parser->next = expression;
+  parser->variableNames = variableNames;
+  parser->variableCodes = variableCodes;
+  parser->variablesNumber = variablesNumber;
+
+  ParseList( parser );
+  if( PeekChar( parser ) != '\0' ) parser->hasError = true;
+
+  if( parser->hasError ) fprintf( stderr, "could not translate expression \"%s\" (kept for runtime evaluation)\n", expression );
+
+  return !(parser->hasError);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+/////                           CODE GENERATION                             /////
+/////////////////////////////////////////////////////////////////////////////////
+
+static Entry* AddEntry( Entry* entriesList, size_t* ref_entriesNumber, const char* name )
+{
+  for( size_t entryIndex = 0; entryIndex < *ref_entriesNumber; entryIndex++ )
+    if( strcmp( entriesList[ entryIndex ].name, name ) == 0 ) return NULL;
+
+  if( *ref_entriesNumber >= ENTRIES_MAX_NUMBER ) return NULL;
+
+  Entry* newEntry = &(entriesList[ (*ref_entriesNumber)++ ]);
+  strncpy( newEntry->name, name, DATA_IO_MAX_PATH_LENGTH - 1 );
+  newEntry->inputsNumber = 0;
+  newEntry->isCompiled = false;
+
+  return newEntry;
+}
+
+// Writes configuration strings as C literals
+static void WriteStringLiteral( FILE* outputFile, const char* text )
+{
+  fputc( '"', outputFile );
+  for( ; *text != '\0'; text++ )
+  {
+    if( *text == '"' || *text == '\\' ) fputc( '\\', outputFile );
+    fputc( *text, outputFile );
+  }
+  fputc( '"', outputFile );
+}
+
+static bool CompileSensor( FILE* outputFile, const char* sensorName )
+{
+  Entry* sensorEntry = AddEntry( sensorsList, &sensorsNumber, sensorName );
+  if( sensorEntry == NULL ) return true;
+
+  char filePath[ DATA_IO_MAX_PATH_LENGTH ];
+  sprintf( filePath, KEY_CONFIG "/" KEY_SENSORS "/%s", sensorName );
+  DataHandle configuration = DataIO_LoadStorageData( filePath );
+  if( configuration == NULL )
+  {
+    fprintf( stderr, "sensor configuration %s not found\n", sensorName );
+    return false;
+  }
+
+  size_t sensorIndex = sensorsNumber - 1;
+  size_t inputsNumber = DataIO_GetListSize( configuration, KEY_INPUTS );
+  const char* transformExpression = DataIO_GetStringValue( configuration, SENSOR_VARIABLE_NAMES[ 0 ], KEY_OUTPUT );
+  Parser parser;
+  if( inputsNumber <= SENSOR_INPUTS_MAX_NUMBER && TranslateExpression( transformExpression, SENSOR_VARIABLE_NAMES, SENSOR_VARIABLE_CODES, inputsNumber, &parser ) )
+  {
+    fprintf( outputFile, "// sensor %s: out = %s\n", sensorName, transformExpression );
+    fprintf( outputFile, "static const char* SENSOR_%lu_EXPRESSION = ", sensorIndex );
+    WriteStringLiteral( outputFile, transformExpression );
+    fprintf( outputFile, ";\nstatic double Sensor_%lu_Update( Input* inputsList )\n{\n", sensorIndex );
+    fprintf( outputFile, "  double in[ %lu ];\n", ( inputsNumber > 0 ) ? inputsNumber : 1 );
+    for( size_t inputIndex = 0; inputIndex < inputsNumber; inputIndex++ )
+      fprintf( outputFile, "  in[ %lu ] = Input_Update( inputsList[ %lu ] );\n", inputIndex, inputIndex );
+    fprintf( outputFile, "  (void) in;\n  return %s;\n}\n\n", parser.code );
+    sensorEntry->inputsNumber = inputsNumber;
+    sensorEntry->isCompiled = true;
+  }
+
+  DataIO_UnloadData( configuration );
+
+  return true;
+}
+
+static bool CompileMotor( FILE* outputFile, const char* motorName )
+{
+  Entry* motorEntry = AddEntry( motorsList, &motorsNumber, motorName );
+  if( motorEntry == NULL ) return true;
+
+  char filePath[ DATA_IO_MAX_PATH_LENGTH ];
+  sprintf( filePath, KEY_CONFIG "/" KEY_MOTORS "/%s", motorName );
+  DataHandle configuration = DataIO_LoadStorageData( filePath );
+  if( configuration == NULL )
+  {
+    fprintf( stderr, "motor configuration %s not found\n", motorName );
+    return false;
+  }
+
+  size_t motorIndex = motorsNumber - 1;
+  const char* transformExpression = DataIO_GetStringValue( configuration, MOTOR_VARIABLE_NAMES[ 0 ], KEY_OUTPUT );
+  Parser parser;
+  if( TranslateExpression( transformExpression, MOTOR_VARIABLE_NAMES, MOTOR_VARIABLE_CODES, 2, &parser ) )
+  {
+    fprintf( outputFile, "// motor %s: out = %s\n", motorName, transformExpression );
+    fprintf( outputFile, "static const char* MOTOR_%lu_EXPRESSION = ", motorIndex );
+    WriteStringLiteral( outputFile, transformExpression );
+    fprintf( outputFile, ";\nstatic double Motor_%lu_Transform( double setpoint, double reference )\n{\n", motorIndex );
+    fprintf( outputFile, "  (void) setpoint; (void) reference;\n  return %s;\n}\n\n", parser.code );
+    motorEntry->isCompiled = true;
+  }
+
+  DataIO_UnloadData( configuration );
+
+  return true;
+}
+
+static bool CompileActuator( FILE* outputFile, const char* actuatorName )
+{
+  if( AddEntry( actuatorsList, &actuatorsNumber, actuatorName ) == NULL ) return true;
+
+  char filePath[ DATA_IO_MAX_PATH_LENGTH ];
+  sprintf( filePath, KEY_CONFIG "/" KEY_ACTUATORS "/%s", actuatorName );
+  DataHandle configuration = DataIO_LoadStorageData( filePath );
+  if( configuration == NULL )
+  {
+    fprintf( stderr, "actuator configuration %s not found\n", actuatorName );
+    return false;
+  }
+
+  bool compileSuccess = true;
+  size_t sensorsNumber = DataIO_GetListSize( configuration, KEY_SENSORS );
+  for( size_t sensorIndex = 0; sensorIndex < sensorsNumber; sensorIndex++ )
+  {
+    if( !CompileSensor( outputFile, DataIO_GetStringValue( configuration, "", KEY_SENSORS ".%lu." KEY_CONFIG, sensorIndex ) ) ) compileSuccess = false;
+  }
+  if( !CompileMotor( outputFile, DataIO_GetStringValue( configuration, "", KEY_MOTOR "." KEY_CONFIG ) ) ) compileSuccess = false;
+
+  DataIO_UnloadData( configuration );
+
+  return compileSuccess;
+}
+
+static bool CompileRobot( FILE* outputFile, const char* robotName )
+{
+  char filePath[ DATA_IO_MAX_PATH_LENGTH ];
+  sprintf( filePath, KEY_CONFIG "/" KEY_ROBOTS "/%s", robotName );
+  DataHandle configuration = DataIO_LoadStorageData( filePath );
+  if( configuration == NULL )
+  {
+    fprintf( stderr, "robot configuration %s not found\n", robotName );
+    return false;
+  }
+
+  bool compileSuccess = true;
+  size_t jointsNumber = DataIO_GetListSize( configuration, KEY_ACTUATORS );
+  for( size_t jointIndex = 0; jointIndex < jointsNumber; jointIndex++ )
+  {
+    if( !CompileActuator( outputFile, DataIO_GetStringValue( configuration, "", KEY_ACTUATORS ".%lu", jointIndex ) ) ) compileSuccess = false;
+  }
+
+  DataIO_UnloadData( configuration );
+
+  return compileSuccess;
+}
+
+static void WriteEntryLists( FILE* outputFile )
+{
+  fprintf( outputFile, "const CompiledSensor COMPILED_SENSORS_LIST[] = \n{\n" );
+  for( size_t sensorIndex = 0; sensorIndex < sensorsNumber; sensorIndex++ )
+  {
+    if( !sensorsList[ sensorIndex ].isCompiled ) continue;
+    fprintf( outputFile, "  { " );
+    WriteStringLiteral( outputFile, sensorsList[ sensorIndex ].name );
+    fprintf( outputFile, ", SENSOR_%lu_EXPRESSION, %lu, Sensor_%lu_Update },\n", sensorIndex, sensorsList[ sensorIndex ].inputsNumber, sensorIndex );
+  }
+  fprintf( outputFile, "  { NULL }\n};\n\n" );
+
+  fprintf( outputFile, "const CompiledMotor COMPILED_MOTORS_LIST[] = \n{\n" );
+  for( size_t motorIndex = 0; motorIndex < motorsNumber; motorIndex++ )
+  {
+    if( !motorsList[ motorIndex ].isCompiled ) continue;
+    fprintf( outputFile, "  { " );
+    WriteStringLiteral( outputFile, motorsList[ motorIndex ].name );
+    fprintf( outputFile, ", MOTOR_%lu_EXPRESSION, Motor_%lu_Transform },\n", motorIndex, motorIndex );
+  }
+  fprintf( outputFile, "  { NULL }\n};\n" );
+}
+
+/* Program entry-point */
+int main( int argc, char* argv[] )
+{
+  if( argc < 3 )
+  {
+    printf( "usage: %s <output_file> <robot_name> [<robot_name> ...]\n", argv[ 0 ] );
+    return 0;
+  }
+
+  FILE* outputFile = fopen( argv[ 1 ], "w" );
+  if( outputFile == NULL )
+  {
+    fprintf( stderr, "could not open output file %s\n", argv[ 1 ] );
+    return -1;
+  }
+
+  fprintf( outputFile, "// Generated by ConfigCompiler from robot configurations:" );
+  for( int robotIndex = 2; robotIndex < argc; robotIndex++ )
+    fprintf( outputFile, " %s", argv[ robotIndex ] );
+  fprintf( outputFile, "\n// (do not edit, it is rewritten whenever configurations change)\n\n" );
+  fprintf( outputFile, "#include \"compiled_config.h\"\n\n#include <math.h>\n\n" );
+
+  bool compileSuccess = true;
+  for( int robotIndex = 2; robotIndex < argc; robotIndex++ )
+  {
+    if( !CompileRobot( outputFile, argv[ robotIndex ] ) ) compileSuccess = false;
+  }
+
+  WriteEntryLists( outputFile );
+
+  fclose( outputFile );
+
+  if( !compileSuccess )
+  {
+    remove( argv[ 1 ] );
+    return -1;
+  }
+
+  return 0;
+}
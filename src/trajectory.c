@@ -0,0 +1,321 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "trajectory.h"
+#include "arena.h"
+
+#include "threads/threads.h"
+
+#include <stdlib.h>
+#include <math.h>
+
+typedef struct _TrajectoryBuffer
+{
+  double* timesList;
+  double* positionsList;
+  double* curvaturesList;           // Spline second derivatives at knots
+  size_t pointsNumber;
+  enum TrajectoryInterpolation interpolation;
+}
+TrajectoryBuffer;
+
+enum TrajectoryRequest { REQUEST_NONE, REQUEST_START, REQUEST_STOP };
+
+struct _TrajectoryData
+{
+  TrajectoryBuffer buffersList[ 2 ];
+  size_t maxPointsNumber;
+  double* auxiliaryList;            // Scratch space for spline coefficients solution
+  ThreadLock requestLock;
+  volatile enum TrajectoryRequest request;
+  double requestedBlendTime;
+  bool requestedLooping;
+  // Control thread only state
+  TrajectoryBuffer* activeBuffer;
+  TrajectoryBuffer* loadingBuffer;
+  bool isRunning;
+  bool isLooping;
+  double elapsedTime;
+  double blendTime;
+  double blendOrigin;
+  size_t segmentIndex;
+};
+
+
+static bool AllocateBuffer( TrajectoryBuffer* buffer, size_t maxPointsNumber )
+{
+  buffer->timesList = (double*) Arena_Calloc( maxPointsNumber, sizeof(double) );
+  buffer->positionsList = (double*) Arena_Calloc( maxPointsNumber, sizeof(double) );
+  buffer->curvaturesList = (double*) Arena_Calloc( maxPointsNumber, sizeof(double) );
+  buffer->pointsNumber = 0;
+  
+  return ( buffer->timesList != NULL && buffer->positionsList != NULL && buffer->curvaturesList != NULL );
+}
+
+Trajectory Trajectory_Create( size_t maxPointsNumber )
+{
+  if( maxPointsNumber < 2 ) return NULL;
+  
+  Trajectory newTrajectory = (Trajectory) Arena_Calloc( 1, sizeof(TrajectoryData) );
+  if( newTrajectory == NULL ) return NULL;
+  
+  newTrajectory->maxPointsNumber = maxPointsNumber;
+  bool allocationSuccess = AllocateBuffer( &(newTrajectory->buffersList[ 0 ]), maxPointsNumber );
+  allocationSuccess = AllocateBuffer( &(newTrajectory->buffersList[ 1 ]), maxPointsNumber ) && allocationSuccess;
+  newTrajectory->auxiliaryList = (double*) Arena_Calloc( maxPointsNumber, sizeof(double) );
+  if( !allocationSuccess || newTrajectory->auxiliaryList == NULL )
+  {
+    Trajectory_Discard( newTrajectory );
+    return NULL;
+  }
+  
+  newTrajectory->activeBuffer = &(newTrajectory->buffersList[ 0 ]);
+  newTrajectory->loadingBuffer = &(newTrajectory->buffersList[ 1 ]);
+  newTrajectory->requestLock = ThreadLock_Create();
+  
+  return newTrajectory;
+}
+
+void Trajectory_Discard( Trajectory trajectory )
+{
+  if( trajectory == NULL ) return;
+  
+  for( size_t bufferIndex = 0; bufferIndex < 2; bufferIndex++ )
+  {
+    Arena_Free( trajectory->buffersList[ bufferIndex ].timesList );
+    Arena_Free( trajectory->buffersList[ bufferIndex ].positionsList );
+    Arena_Free( trajectory->buffersList[ bufferIndex ].curvaturesList );
+  }
+  Arena_Free( trajectory->auxiliaryList );
+  
+  if( trajectory->requestLock ) ThreadLock_Discard( trajectory->requestLock );
+  
+  Arena_Free( trajectory );
+}
+
+size_t Trajectory_Load( Trajectory trajectory, enum TrajectoryInterpolation interpolation, size_t firstPointIndex, size_t pointsNumber, const double* timesList, const double* positionsList )
+{
+  if( trajectory == NULL ) return 0;
+  
+  if( interpolation >= TRAJECTORY_INTERPOLATIONS_NUMBER ) return 0;
+  
+  ThreadLock_Aquire( trajectory->requestLock );
+  
+  // Staging buffer is only swapped by control thread on start request, so loading over it is safe once the request is withdrawn
+  if( trajectory->request == REQUEST_START ) trajectory->request = REQUEST_NONE;
+  
+  TrajectoryBuffer* buffer = trajectory->loadingBuffer;
+  
+  size_t loadedPointsNumber = 0;
+  if( firstPointIndex == 0 || ( firstPointIndex <= buffer->pointsNumber && interpolation == buffer->interpolation ) )
+  {
+    if( firstPointIndex + pointsNumber <= trajectory->maxPointsNumber )
+    {
+      loadedPointsNumber = firstPointIndex + pointsNumber;
+      for( size_t pointIndex = 0; pointIndex < pointsNumber; pointIndex++ )
+      {
+        size_t bufferIndex = firstPointIndex + pointIndex;
+        if( bufferIndex > 0 && timesList[ pointIndex ] <= buffer->timesList[ bufferIndex - 1 ] )
+        {
+          loadedPointsNumber = 0;
+          break;
+        }
+        buffer->timesList[ bufferIndex ] = timesList[ pointIndex ];
+        buffer->positionsList[ bufferIndex ] = positionsList[ pointIndex ];
+      }
+    }
+  }
+  buffer->pointsNumber = loadedPointsNumber;
+  buffer->interpolation = interpolation;
+  
+  ThreadLock_Release( trajectory->requestLock );
+  
+  return loadedPointsNumber;
+}
+
+// Natural cubic spline second derivatives (tridiagonal system solved with Thomas algorithm)
+static void CalculateCurvatures( TrajectoryBuffer* buffer, double* auxiliaryList )
+{
+  double* timesList = buffer->timesList;
+  double* positionsList = buffer->positionsList;
+  double* curvaturesList = buffer->curvaturesList;
+  size_t lastIndex = buffer->pointsNumber - 1;
+  
+  curvaturesList[ 0 ] = auxiliaryList[ 0 ] = 0.0;
+  for( size_t pointIndex = 1; pointIndex < lastIndex; pointIndex++ )
+  {
+    double previousInterval = timesList[ pointIndex ] - timesList[ pointIndex - 1 ];
+    double nextInterval = timesList[ pointIndex + 1 ] - timesList[ pointIndex ];
+    double ratio = previousInterval / ( timesList[ pointIndex + 1 ] - timesList[ pointIndex - 1 ] );
+    double pivot = ratio * curvaturesList[ pointIndex - 1 ] + 2.0;
+    curvaturesList[ pointIndex ] = ( ratio - 1.0 ) / pivot;
+    double slopeChange = ( positionsList[ pointIndex + 1 ] - positionsList[ pointIndex ] ) / nextInterval 
+                         - ( positionsList[ pointIndex ] - positionsList[ pointIndex - 1 ] ) / previousInterval;
+    auxiliaryList[ pointIndex ] = ( 6.0 * slopeChange / ( previousInterval + nextInterval ) - ratio * auxiliaryList[ pointIndex - 1 ] ) / pivot;
+  }
+  
+  curvaturesList[ lastIndex ] = 0.0;
+  for( size_t pointIndex = lastIndex; pointIndex > 0; pointIndex-- )
+    curvaturesList[ pointIndex - 1 ] = curvaturesList[ pointIndex - 1 ] * curvaturesList[ pointIndex ] + auxiliaryList[ pointIndex - 1 ];
+}
+
+bool Trajectory_Start( Trajectory trajectory, double blendTime, bool isLooping )
+{
+  if( trajectory == NULL ) return false;
+  
+  ThreadLock_Aquire( trajectory->requestLock );
+  
+  TrajectoryBuffer* buffer = trajectory->loadingBuffer;
+  bool startRequested = ( buffer->pointsNumber >= 2 );
+  if( startRequested )
+  {
+    if( buffer->interpolation == TRAJECTORY_CUBIC_SPLINE ) CalculateCurvatures( buffer, trajectory->auxiliaryList );
+    trajectory->requestedBlendTime = ( blendTime > 0.0 ) ? blendTime : 0.0;
+    trajectory->requestedLooping = isLooping;
+    trajectory->request = REQUEST_START;
+  }
+  
+  ThreadLock_Release( trajectory->requestLock );
+  
+  return startRequested;
+}
+
+bool Trajectory_Stop( Trajectory trajectory )
+{
+  if( trajectory == NULL ) return false;
+  
+  ThreadLock_Aquire( trajectory->requestLock );
+  trajectory->request = REQUEST_STOP;
+  ThreadLock_Release( trajectory->requestLock );
+  
+  return true;
+}
+
+static void HandleRequest( Trajectory trajectory, DoFVariables* setpoints )
+{
+  // Never block control pass: pending requests are applied on a later call if loading thread holds the lock
+  if( !ThreadLock_TryAquire( trajectory->requestLock ) ) return;
+  
+  if( trajectory->request == REQUEST_START )
+  {
+    TrajectoryBuffer* startedBuffer = trajectory->loadingBuffer;
+    trajectory->loadingBuffer = trajectory->activeBuffer;
+    trajectory->activeBuffer = startedBuffer;
+    // Previous running points are dropped: next trajectory has to be fully uploaded again
+    trajectory->loadingBuffer->pointsNumber = 0;
+    trajectory->isLooping = trajectory->requestedLooping;
+    trajectory->blendTime = trajectory->requestedBlendTime;
+    trajectory->blendOrigin = setpoints->position;
+    trajectory->elapsedTime = 0.0;
+    trajectory->segmentIndex = 0;
+    trajectory->isRunning = true;
+  }
+  else if( trajectory->request == REQUEST_STOP )
+  {
+    if( trajectory->isRunning )
+    {
+      setpoints->velocity = 0.0;
+      setpoints->acceleration = 0.0;
+    }
+    trajectory->isRunning = false;
+  }
+  trajectory->request = REQUEST_NONE;
+  
+  ThreadLock_Release( trajectory->requestLock );
+}
+
+bool Trajectory_Evaluate( Trajectory trajectory, double timeDelta, DoFVariables* ref_setpoints )
+{
+  if( trajectory == NULL ) return false;
+  
+  if( trajectory->request != REQUEST_NONE ) HandleRequest( trajectory, ref_setpoints );
+  
+  if( !trajectory->isRunning ) return false;
+  
+  TrajectoryBuffer* buffer = trajectory->activeBuffer;
+  double* timesList = buffer->timesList;
+  size_t lastIndex = buffer->pointsNumber - 1;
+  double duration = timesList[ lastIndex ] - timesList[ 0 ];
+  
+  double blendElapsedTime = trajectory->elapsedTime;
+  trajectory->elapsedTime += ( timeDelta > 0.0 ) ? timeDelta : 0.0;
+  
+  bool hasEnded = false;
+  double time = timesList[ 0 ] + blendElapsedTime;
+  if( blendElapsedTime >= duration )
+  {
+    if( trajectory->isLooping ) time = timesList[ 0 ] + fmod( blendElapsedTime, duration );
+    else 
+    {
+      time = timesList[ lastIndex ];
+      hasEnded = true;
+    }
+  }
+  
+  // Points are visited in increasing time order, so segment search only moves forward (apart from loop restarts)
+  size_t segmentIndex = trajectory->segmentIndex;
+  if( time < timesList[ segmentIndex ] ) segmentIndex = 0;
+  while( segmentIndex < lastIndex - 1 && time > timesList[ segmentIndex + 1 ] ) segmentIndex++;
+  trajectory->segmentIndex = segmentIndex;
+  
+  double interval = timesList[ segmentIndex + 1 ] - timesList[ segmentIndex ];
+  double startPosition = buffer->positionsList[ segmentIndex ];
+  double endPosition = buffer->positionsList[ segmentIndex + 1 ];
+  double endWeight = ( time - timesList[ segmentIndex ] ) / interval;
+  double startWeight = 1.0 - endWeight;
+  
+  double position = startWeight * startPosition + endWeight * endPosition;
+  double velocity = ( endPosition - startPosition ) / interval;
+  double acceleration = 0.0;
+  if( buffer->interpolation == TRAJECTORY_CUBIC_SPLINE )
+  {
+    double startCurvature = buffer->curvaturesList[ segmentIndex ];
+    double endCurvature = buffer->curvaturesList[ segmentIndex + 1 ];
+    position += ( ( startWeight * startWeight * startWeight - startWeight ) * startCurvature 
+                + ( endWeight * endWeight * endWeight - endWeight ) * endCurvature ) * interval * interval / 6.0;
+    velocity += ( ( 3.0 * endWeight * endWeight - 1.0 ) * endCurvature - ( 3.0 * startWeight * startWeight - 1.0 ) * startCurvature ) * interval / 6.0;
+    acceleration = startWeight * startCurvature + endWeight * endCurvature;
+  }
+  
+  if( hasEnded ) velocity = acceleration = 0.0;
+  
+  // Smoothstep transition from setpoint at start time (position offset fades out with continuous velocity)
+  if( blendElapsedTime < trajectory->blendTime )
+  {
+    double phase = blendElapsedTime / trajectory->blendTime;
+    double weight = phase * phase * ( 3.0 - 2.0 * phase );
+    double weightDerivative = 6.0 * phase * ( 1.0 - phase ) / trajectory->blendTime;
+    double weightSecondDerivative = ( 6.0 - 12.0 * phase ) / ( trajectory->blendTime * trajectory->blendTime );
+    double offset = position - trajectory->blendOrigin;
+    acceleration = weight * acceleration + 2.0 * weightDerivative * velocity + weightSecondDerivative * offset;
+    velocity = weight * velocity + weightDerivative * offset;
+    position = trajectory->blendOrigin + weight * offset;
+  }
+  
+  ref_setpoints->position = position;
+  ref_setpoints->velocity = velocity;
+  ref_setpoints->acceleration = acceleration;
+  
+  if( hasEnded && blendElapsedTime >= trajectory->blendTime ) trajectory->isRunning = false;
+  
+  return true;
+}
@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  Copyright (c) 2016-2025 Leonardo Consoni <leonardojc@protonmail.com>      //
+//                                                                            //
+//  This file is part of RobotSystem-Lite.                                    //
+//                                                                            //
+//  RobotSystem-Lite is free software: you can redistribute it and/or modify  //
+//  it under the terms of the GNU Lesser General Public License as published  //
+//  by the Free Software Foundation, either version 3 of the License, or      //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  RobotSystem-Lite is distributed in the hope that it will be useful,       //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              //
+//  GNU Lesser General Public License for more details.                       //
+//                                                                            //
+//  You should have received a copy of the GNU Lesser General Public License  //
+//  along with RobotSystem-Lite. If not, see <http://www.gnu.org/licenses/>.  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/// @file trajectory.h
+/// @brief Preloaded axis trajectory functions
+///
+/// Interface for time-parameterized single axis trajectories, uploaded (possibly in several chunks) into preallocated buffers and evaluated locally on each control pass, 
+/// so that motion does not depend on per-cycle setpoint streaming from clients. Loading is done on a staging buffer, swapped with the running one only when a trajectory is (re)started, 
+/// and the control thread never waits on the loading thread.
+
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+
+#include "robot_control/robot_control.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/// Interpolation methods between trajectory points
+enum TrajectoryInterpolation { TRAJECTORY_LINEAR,           ///< Points are sampled positions, linearly interpolated
+                               TRAJECTORY_CUBIC_SPLINE,     ///< Points are knots of a natural cubic spline (continuous velocity and acceleration)
+                               TRAJECTORY_INTERPOLATIONS_NUMBER };
+
+typedef struct _TrajectoryData TrajectoryData;    ///< Single axis trajectory internal data structure
+typedef TrajectoryData* Trajectory;               ///< Opaque reference to trajectory internal data structure
+
+
+/// @brief Creates trajectory data structure with preallocated buffers
+/// @param[in] maxPointsNumber maximum number of points (samples or knots) of a single trajectory
+/// @return reference/pointer to newly created trajectory data structure (NULL on errors or zero capacity)
+Trajectory Trajectory_Create( size_t maxPointsNumber );
+
+/// @brief Deallocates internal data of given trajectory
+/// @param[in] trajectory reference to trajectory
+void Trajectory_Discard( Trajectory trajectory );
+
+/// @brief Copies points to trajectory staging buffer (cancels a previous start request still not applied by control)
+/// @param[in] trajectory reference to trajectory
+/// @param[in] interpolation interpolation method for loaded points (must be the same for all chunks)
+/// @param[in] firstPointIndex position of the first given point on buffer (0 restarts loading, otherwise must not exceed already loaded points number)
+/// @param[in] pointsNumber number of given points
+/// @param[in] timesList strictly increasing points times (in seconds)
+/// @param[in] positionsList points positions
+/// @return total number of loaded points (0 on errors)
+size_t Trajectory_Load( Trajectory trajectory, enum TrajectoryInterpolation interpolation, size_t firstPointIndex, size_t pointsNumber, const double* timesList, const double* positionsList );
+
+/// @brief Requests execution of loaded trajectory from its beginning, starting from current setpoint on next control pass
+/// @param[in] trajectory reference to trajectory
+/// @param[in] blendTime time interval (in seconds) for smooth transition from current setpoint to trajectory
+/// @param[in] isLooping repeat trajectory periodically, instead of stopping at last point
+/// @return true if start was requested, false on errors (less than 2 points loaded)
+bool Trajectory_Start( Trajectory trajectory, double blendTime, bool isLooping );
+
+/// @brief Requests interruption of running trajectory, holding current position on next control pass
+/// @param[in] trajectory reference to trajectory
+/// @return true if stop was requested, false on errors
+bool Trajectory_Stop( Trajectory trajectory );
+
+/// @brief Advances running trajectory and writes its current kinematic values (called from control thread)
+/// @param[in] trajectory reference to trajectory
+/// @param[in] timeDelta time (in seconds) passed since last evaluation
+/// @param[in,out] ref_setpoints pointer/reference to setpoints structure (position, velocity and acceleration are overwritten while running)
+/// @return true if trajectory is running and setpoints were written, false otherwise
+bool Trajectory_Evaluate( Trajectory trajectory, double timeDelta, DoFVariables* ref_setpoints );
+
+
+#endif // TRAJECTORY_H